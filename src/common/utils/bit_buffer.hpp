@@ -2,6 +2,8 @@
 
 #include <string>
 #include <cassert>
+#include <cmath>
+#include <cstdint>
 
 // https://github.com/Aadeshp/BitBufferCpp/tree/master/src
 
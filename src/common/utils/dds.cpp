@@ -0,0 +1,531 @@
+#include "dds.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace utils::dds
+{
+	namespace
+	{
+		constexpr std::uint32_t DDS_MAGIC = 0x20534444; // "DDS "
+
+		constexpr std::uint32_t DDSD_DEPTH = 0x800000;
+
+		constexpr std::uint32_t DDPF_ALPHA = 0x2;
+		constexpr std::uint32_t DDPF_FOURCC = 0x4;
+		constexpr std::uint32_t DDPF_RGB = 0x40;
+		constexpr std::uint32_t DDPF_LUMINANCE = 0x20000;
+
+		constexpr std::uint32_t DDSCAPS2_CUBEMAP = 0x200;
+		constexpr std::uint32_t DDSCAPS2_CUBEMAP_ALLFACES = 0xFC00;
+		constexpr std::uint32_t DDSCAPS2_VOLUME = 0x200000;
+
+		constexpr std::uint32_t DDS_RESOURCE_MISC_TEXTURECUBE = 0x4;
+
+		struct dds_pixel_format
+		{
+			std::uint32_t size;
+			std::uint32_t flags;
+			std::uint32_t four_cc;
+			std::uint32_t rgb_bit_count;
+			std::uint32_t r_bit_mask;
+			std::uint32_t g_bit_mask;
+			std::uint32_t b_bit_mask;
+			std::uint32_t a_bit_mask;
+		};
+
+		struct dds_header
+		{
+			std::uint32_t size;
+			std::uint32_t flags;
+			std::uint32_t height;
+			std::uint32_t width;
+			std::uint32_t pitch_or_linear_size;
+			std::uint32_t depth;
+			std::uint32_t mip_map_count;
+			std::uint32_t reserved1[11];
+			dds_pixel_format ddspf;
+			std::uint32_t caps;
+			std::uint32_t caps2;
+			std::uint32_t caps3;
+			std::uint32_t caps4;
+			std::uint32_t reserved2;
+		};
+
+		struct dds_header_dxt10
+		{
+			std::uint32_t dxgi_format;
+			std::uint32_t resource_dimension;
+			std::uint32_t misc_flag;
+			std::uint32_t array_size;
+			std::uint32_t misc_flags2;
+		};
+
+		static_assert(sizeof(dds_pixel_format) == 32);
+		static_assert(sizeof(dds_header) == 124);
+		static_assert(sizeof(dds_header_dxt10) == 20);
+
+		constexpr std::uint32_t make_four_cc(const char a, const char b, const char c, const char d)
+		{
+			return static_cast<std::uint32_t>(a) | (static_cast<std::uint32_t>(b) << 8) |
+				(static_cast<std::uint32_t>(c) << 16) | (static_cast<std::uint32_t>(d) << 24);
+		}
+
+		// DXGI_FORMAT values, kept local so this file doesn't need dxgiformat.h
+		enum dxgi_format : std::uint32_t
+		{
+			FORMAT_UNKNOWN = 0,
+			FORMAT_R32G32B32A32_FLOAT = 2,
+			FORMAT_R16G16B16A16_FLOAT = 10,
+			FORMAT_R16G16B16A16_UNORM = 11,
+			FORMAT_R16G16B16A16_SNORM = 13,
+			FORMAT_R32G32_FLOAT = 16,
+			FORMAT_R8G8B8A8_UNORM = 28,
+			FORMAT_R16G16_FLOAT = 34,
+			FORMAT_R16G16_UNORM = 35,
+			FORMAT_R32_FLOAT = 41,
+			FORMAT_R8G8_UNORM = 49,
+			FORMAT_R16_FLOAT = 54,
+			FORMAT_R16_UNORM = 56,
+			FORMAT_R8_UNORM = 61,
+			FORMAT_A8_UNORM = 65,
+			FORMAT_BC1_UNORM = 71,
+			FORMAT_BC2_UNORM = 74,
+			FORMAT_BC3_UNORM = 77,
+			FORMAT_BC4_UNORM = 80,
+			FORMAT_BC4_SNORM = 81,
+			FORMAT_BC5_UNORM = 83,
+			FORMAT_BC5_SNORM = 84,
+			FORMAT_B5G6R5_UNORM = 85,
+			FORMAT_B5G5R5A1_UNORM = 86,
+			FORMAT_B8G8R8A8_UNORM = 87,
+			FORMAT_B8G8R8X8_UNORM = 88,
+			FORMAT_B4G4R4A4_UNORM = 115,
+		};
+
+		bool is_bit_mask(const dds_pixel_format& pf, const std::uint32_t r, const std::uint32_t g,
+			const std::uint32_t b, const std::uint32_t a)
+		{
+			return pf.r_bit_mask == r && pf.g_bit_mask == g && pf.b_bit_mask == b && pf.a_bit_mask == a;
+		}
+
+		// only legacy layouts that DirectXTex loads without a pixel conversion are accepted
+		std::uint32_t get_legacy_format(const dds_pixel_format& pf)
+		{
+			if (pf.flags & DDPF_FOURCC)
+			{
+				switch (pf.four_cc)
+				{
+				case make_four_cc('D', 'X', 'T', '1'):
+					return FORMAT_BC1_UNORM;
+				case make_four_cc('D', 'X', 'T', '2'):
+				case make_four_cc('D', 'X', 'T', '3'):
+					return FORMAT_BC2_UNORM;
+				case make_four_cc('D', 'X', 'T', '4'):
+				case make_four_cc('D', 'X', 'T', '5'):
+					return FORMAT_BC3_UNORM;
+				case make_four_cc('A', 'T', 'I', '1'):
+				case make_four_cc('B', 'C', '4', 'U'):
+					return FORMAT_BC4_UNORM;
+				case make_four_cc('B', 'C', '4', 'S'):
+					return FORMAT_BC4_SNORM;
+				case make_four_cc('A', 'T', 'I', '2'):
+				case make_four_cc('B', 'C', '5', 'U'):
+					return FORMAT_BC5_UNORM;
+				case make_four_cc('B', 'C', '5', 'S'):
+					return FORMAT_BC5_SNORM;
+				// D3DFMT values stored directly in the fourcc field
+				case 36:
+					return FORMAT_R16G16B16A16_UNORM;
+				case 110:
+					return FORMAT_R16G16B16A16_SNORM;
+				case 111:
+					return FORMAT_R16_FLOAT;
+				case 112:
+					return FORMAT_R16G16_FLOAT;
+				case 113:
+					return FORMAT_R16G16B16A16_FLOAT;
+				case 114:
+					return FORMAT_R32_FLOAT;
+				case 115:
+					return FORMAT_R32G32_FLOAT;
+				case 116:
+					return FORMAT_R32G32B32A32_FLOAT;
+				default:
+					return FORMAT_UNKNOWN;
+				}
+			}
+
+			if (pf.flags & DDPF_RGB)
+			{
+				switch (pf.rgb_bit_count)
+				{
+				case 32:
+					if (is_bit_mask(pf, 0x000000FF, 0x0000FF00, 0x00FF0000, 0xFF000000))
+					{
+						return FORMAT_R8G8B8A8_UNORM;
+					}
+					if (is_bit_mask(pf, 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000))
+					{
+						return FORMAT_B8G8R8A8_UNORM;
+					}
+					if (is_bit_mask(pf, 0x00FF0000, 0x0000FF00, 0x000000FF, 0))
+					{
+						return FORMAT_B8G8R8X8_UNORM;
+					}
+					if (is_bit_mask(pf, 0x0000FFFF, 0xFFFF0000, 0, 0))
+					{
+						return FORMAT_R16G16_UNORM;
+					}
+					if (is_bit_mask(pf, 0xFFFFFFFF, 0, 0, 0))
+					{
+						return FORMAT_R32_FLOAT;
+					}
+					break;
+				case 16:
+					if (is_bit_mask(pf, 0xF800, 0x07E0, 0x001F, 0))
+					{
+						return FORMAT_B5G6R5_UNORM;
+					}
+					if (is_bit_mask(pf, 0x7C00, 0x03E0, 0x001F, 0x8000))
+					{
+						return FORMAT_B5G5R5A1_UNORM;
+					}
+					if (is_bit_mask(pf, 0x0F00, 0x00F0, 0x000F, 0xF000))
+					{
+						return FORMAT_B4G4R4A4_UNORM;
+					}
+					break;
+				}
+
+				return FORMAT_UNKNOWN;
+			}
+
+			if (pf.flags & DDPF_LUMINANCE)
+			{
+				if (pf.rgb_bit_count == 8 && is_bit_mask(pf, 0xFF, 0, 0, 0))
+				{
+					return FORMAT_R8_UNORM;
+				}
+				if (pf.rgb_bit_count == 16 && is_bit_mask(pf, 0xFFFF, 0, 0, 0))
+				{
+					return FORMAT_R16_UNORM;
+				}
+				if (pf.rgb_bit_count == 16 && is_bit_mask(pf, 0x00FF, 0, 0, 0xFF00))
+				{
+					return FORMAT_R8G8_UNORM;
+				}
+
+				return FORMAT_UNKNOWN;
+			}
+
+			if ((pf.flags & DDPF_ALPHA) && pf.rgb_bit_count == 8)
+			{
+				return FORMAT_A8_UNORM;
+			}
+
+			return FORMAT_UNKNOWN;
+		}
+
+		std::size_t get_bits_per_pixel(const std::uint32_t format)
+		{
+			if (format >= 1 && format <= 4) return 128; // R32G32B32A32
+			if (format >= 5 && format <= 8) return 96; // R32G32B32
+			if (format >= 9 && format <= 22) return 64; // R16G16B16A16, R32G32, R32G8X24
+			if (format >= 23 && format <= 47) return 32; // R10G10B10A2 .. R24G8
+			if (format >= 48 && format <= 59) return 16; // R8G8, R16
+			if (format >= 60 && format <= 65) return 8; // R8, A8
+			if (format == 67) return 32; // R9G9B9E5_SHAREDEXP
+			if (format == 85 || format == 86 || format == 115) return 16; // B5G6R5, B5G5R5A1, B4G4R4A4
+			if (format >= 87 && format <= 93) return 32; // B8G8R8A8, B8G8R8X8, R10G10B10_XR_BIAS_A2
+			return 0;
+		}
+
+		std::size_t get_block_size(const std::uint32_t format)
+		{
+			switch (format)
+			{
+			case 70: case 71: case 72: // BC1
+			case 79: case 80: case 81: // BC4
+				return 8;
+			case 73: case 74: case 75: // BC2
+			case 76: case 77: case 78: // BC3
+			case 82: case 83: case 84: // BC5
+			case 94: case 95: case 96: // BC6H
+			case 97: case 98: case 99: // BC7
+				return 16;
+			default:
+				return 0;
+			}
+		}
+
+		bool set_error(std::string* error, const char* message)
+		{
+			if (error)
+			{
+				*error = message;
+			}
+
+			return false;
+		}
+	}
+
+	bool is_block_compressed(const std::uint32_t format)
+	{
+		return get_block_size(format) != 0;
+	}
+
+	std::size_t get_surface_size(const std::uint32_t format, const std::uint32_t width, const std::uint32_t height)
+	{
+		if (const auto block_size = get_block_size(format))
+		{
+			const auto blocks_wide = std::max<std::uint64_t>(1, (static_cast<std::uint64_t>(width) + 3) / 4);
+			const auto blocks_high = std::max<std::uint64_t>(1, (static_cast<std::uint64_t>(height) + 3) / 4);
+			return static_cast<std::size_t>(blocks_wide * blocks_high * block_size);
+		}
+
+		if (const auto bpp = get_bits_per_pixel(format))
+		{
+			const auto row_pitch = (static_cast<std::uint64_t>(width) * bpp + 7) / 8;
+			return static_cast<std::size_t>(row_pitch * height);
+		}
+
+		return 0;
+	}
+
+	std::size_t get_image_size(const texture_info& info)
+	{
+		std::size_t total = 0;
+
+		for (auto item = 0u; item < info.array_size; item++)
+		{
+			for (auto mip = 0u; mip < info.mip_levels; mip++)
+			{
+				const auto width = std::max(1u, info.width >> mip);
+				const auto height = std::max(1u, info.height >> mip);
+				const auto depth = info.dimension == TEXTURE_DIMENSION_3D ? std::max(1u, info.depth >> mip) : 1u;
+
+				const auto surface_size = get_surface_size(info.format, width, height);
+				if (!surface_size)
+				{
+					return 0;
+				}
+
+				total += surface_size * depth;
+			}
+		}
+
+		return total;
+	}
+
+	bool parse_header(const void* data, const std::size_t size, texture_info* info, std::string* error)
+	{
+		const auto bytes = static_cast<const std::uint8_t*>(data);
+		auto offset = sizeof(std::uint32_t) + sizeof(dds_header);
+
+		if (!data || size < offset)
+		{
+			return set_error(error, "file is too small to contain a DDS header");
+		}
+
+		std::uint32_t magic{};
+		std::memcpy(&magic, bytes, sizeof(magic));
+		if (magic != DDS_MAGIC)
+		{
+			return set_error(error, "invalid DDS magic");
+		}
+
+		dds_header header{};
+		std::memcpy(&header, bytes + sizeof(magic), sizeof(header));
+		if (header.size != sizeof(dds_header) || header.ddspf.size != sizeof(dds_pixel_format))
+		{
+			return set_error(error, "invalid DDS header size");
+		}
+
+		texture_info result{};
+		result.width = header.width;
+		result.height = header.height;
+		result.depth = 1;
+		result.array_size = 1;
+		// like DirectXTex the count is used even without DDSD_MIPMAPCOUNT, some writers leave the flag unset
+		result.mip_levels = header.mip_map_count ? header.mip_map_count : 1;
+
+		if ((header.ddspf.flags & DDPF_FOURCC) && header.ddspf.four_cc == make_four_cc('D', 'X', '1', '0'))
+		{
+			if (size < offset + sizeof(dds_header_dxt10))
+			{
+				return set_error(error, "file is too small to contain a DX10 header");
+			}
+
+			dds_header_dxt10 dx10{};
+			std::memcpy(&dx10, bytes + offset, sizeof(dx10));
+			offset += sizeof(dds_header_dxt10);
+
+			if (dx10.array_size == 0)
+			{
+				return set_error(error, "invalid DX10 array size");
+			}
+
+			result.format = dx10.dxgi_format;
+			result.array_size = dx10.array_size;
+
+			switch (dx10.resource_dimension)
+			{
+			case TEXTURE_DIMENSION_1D:
+				result.dimension = TEXTURE_DIMENSION_1D;
+				result.height = 1;
+				break;
+			case TEXTURE_DIMENSION_2D:
+				result.dimension = TEXTURE_DIMENSION_2D;
+				if (dx10.misc_flag & DDS_RESOURCE_MISC_TEXTURECUBE)
+				{
+					result.is_cubemap = true;
+					result.array_size *= 6;
+				}
+				break;
+			case TEXTURE_DIMENSION_3D:
+				if (!(header.flags & DDSD_DEPTH) || dx10.array_size != 1)
+				{
+					return set_error(error, "invalid DX10 volume texture");
+				}
+
+				result.dimension = TEXTURE_DIMENSION_3D;
+				result.depth = header.depth;
+				break;
+			default:
+				return set_error(error, "unknown DX10 resource dimension");
+			}
+		}
+		else
+		{
+			result.format = get_legacy_format(header.ddspf);
+			if (result.format == FORMAT_UNKNOWN)
+			{
+				return set_error(error, "legacy pixel format requires a conversion");
+			}
+
+			if (header.flags & DDSD_DEPTH)
+			{
+				result.dimension = TEXTURE_DIMENSION_3D;
+				result.depth = header.depth;
+			}
+			else
+			{
+				result.dimension = TEXTURE_DIMENSION_2D;
+
+				if (header.caps2 & DDSCAPS2_CUBEMAP)
+				{
+					// partial cubemaps are expanded by DirectXTex, we don't bother
+					if ((header.caps2 & DDSCAPS2_CUBEMAP_ALLFACES) != DDSCAPS2_CUBEMAP_ALLFACES)
+					{
+						return set_error(error, "partial cubemaps are not supported");
+					}
+
+					result.is_cubemap = true;
+					result.array_size = 6;
+				}
+			}
+
+			if ((header.caps2 & DDSCAPS2_VOLUME) && result.dimension != TEXTURE_DIMENSION_3D)
+			{
+				return set_error(error, "volume flag set without depth");
+			}
+		}
+
+		if (result.width == 0 || result.height == 0 || result.depth == 0)
+		{
+			return set_error(error, "invalid image dimensions");
+		}
+
+		auto largest = std::max(result.width, result.height);
+		if (result.dimension == TEXTURE_DIMENSION_3D)
+		{
+			largest = std::max(largest, result.depth);
+		}
+
+		auto full_chain = 1u;
+		while (largest > 1)
+		{
+			largest >>= 1;
+			full_chain++;
+		}
+
+		if (result.mip_levels > full_chain)
+		{
+			return set_error(error, "mip count exceeds the full mip chain");
+		}
+
+		result.payload_offset = offset;
+		result.payload_size = get_image_size(result);
+
+		if (result.payload_size == 0)
+		{
+			return set_error(error, "unsupported pixel format");
+		}
+
+		if (size - offset < result.payload_size)
+		{
+			return set_error(error, "pixel data is truncated");
+		}
+
+		*info = result;
+		return true;
+	}
+
+	file::file(const std::string& path)
+	{
+		this->open(path);
+	}
+
+	bool file::open(const std::string& path)
+	{
+		this->close();
+
+		if (!this->file_.open(path))
+		{
+			this->error_ = "failed to open file";
+			return false;
+		}
+
+		this->valid_ = parse_header(this->file_.data(), this->file_.size(), &this->info_, &this->error_);
+		if (!this->valid_)
+		{
+			this->file_.close();
+		}
+
+		return this->valid_;
+	}
+
+	void file::close()
+	{
+		this->file_.close();
+		this->info_ = {};
+		this->valid_ = false;
+		this->error_.clear();
+	}
+
+	bool file::is_valid() const
+	{
+		return this->valid_;
+	}
+
+	const texture_info& file::get_info() const
+	{
+		return this->info_;
+	}
+
+	std::string_view file::get_payload() const
+	{
+		if (!this->valid_)
+		{
+			return {};
+		}
+
+		return this->file_.view(this->info_.payload_offset, this->info_.payload_size);
+	}
+
+	const std::string& file::get_error() const
+	{
+		return this->error_;
+	}
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "mapped_file.hpp"
+
+#include <string>
+#include <string_view>
+#include <cstdint>
+
+// minimal DDS/DX10 container reader, does not depend on DirectXTex or any windows headers
+// so it can also be used by offline validation tools
+
+namespace utils::dds
+{
+	enum texture_dimension : std::uint32_t
+	{
+		TEXTURE_DIMENSION_1D = 2,
+		TEXTURE_DIMENSION_2D = 3,
+		TEXTURE_DIMENSION_3D = 4,
+	};
+
+	struct texture_info
+	{
+		std::uint32_t width;
+		std::uint32_t height;
+		std::uint32_t depth;
+		std::uint32_t array_size; // includes cube faces, like DirectX::TexMetadata
+		std::uint32_t mip_levels;
+		std::uint32_t format; // DXGI_FORMAT
+		texture_dimension dimension;
+		bool is_cubemap;
+
+		std::size_t payload_offset;
+		std::size_t payload_size;
+	};
+
+	bool is_block_compressed(std::uint32_t format);
+
+	// size of a single surface in bytes, 0 if the format is unsupported
+	std::size_t get_surface_size(std::uint32_t format, std::uint32_t width, std::uint32_t height);
+
+	// size of every surface of the image (array items, faces, mips and slices), 0 if unsupported
+	std::size_t get_image_size(const texture_info& info);
+
+	// parses the DDS header and computes the payload location, fails on formats that would need a conversion
+	bool parse_header(const void* data, std::size_t size, texture_info* info, std::string* error = nullptr);
+
+	class file final
+	{
+	public:
+		file() = default;
+		file(const std::string& path);
+
+		bool open(const std::string& path);
+		void close();
+
+		bool is_valid() const;
+
+		const texture_info& get_info() const;
+		std::string_view get_payload() const;
+
+		const std::string& get_error() const;
+
+	private:
+		mapped_file file_;
+		texture_info info_{};
+		bool valid_ = false;
+		std::string error_;
+	};
+}
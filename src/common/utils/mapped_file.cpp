@@ -0,0 +1,214 @@
+#include "mapped_file.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <Windows.h>
+
+#ifdef max
+#undef max
+#endif
+
+#ifdef min
+#undef min
+#endif
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace utils
+{
+	mapped_file::mapped_file(const std::string& path)
+	{
+		this->open(path);
+	}
+
+	mapped_file::~mapped_file()
+	{
+		this->close();
+	}
+
+	mapped_file::mapped_file(mapped_file&& obj) noexcept
+	{
+		this->move(obj);
+	}
+
+	mapped_file& mapped_file::operator=(mapped_file&& obj) noexcept
+	{
+		if (this != &obj)
+		{
+			this->close();
+			this->move(obj);
+		}
+
+		return *this;
+	}
+
+	void mapped_file::move(mapped_file& obj)
+	{
+		this->file_ = std::exchange(obj.file_, nullptr);
+		this->mapping_ = std::exchange(obj.mapping_, nullptr);
+		this->data_ = std::exchange(obj.data_, nullptr);
+		this->size_ = std::exchange(obj.size_, 0);
+	}
+
+#ifdef _WIN32
+	bool mapped_file::open(const std::string& path)
+	{
+		this->close();
+
+		const auto file = CreateFileA(path.data(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+			OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+
+		this->file_ = file;
+
+		LARGE_INTEGER size{};
+		if (!GetFileSizeEx(file, &size))
+		{
+			this->close();
+			return false;
+		}
+
+		this->size_ = static_cast<std::size_t>(size.QuadPart);
+		if (this->size_ == 0)
+		{
+			// empty files cannot be mapped, but are still valid
+			return true;
+		}
+
+		this->mapping_ = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!this->mapping_)
+		{
+			this->close();
+			return false;
+		}
+
+		this->data_ = static_cast<const std::uint8_t*>(MapViewOfFile(this->mapping_, FILE_MAP_READ, 0, 0, 0));
+		if (!this->data_)
+		{
+			this->close();
+			return false;
+		}
+
+		return true;
+	}
+
+	void mapped_file::close()
+	{
+		if (this->data_)
+		{
+			UnmapViewOfFile(this->data_);
+		}
+
+		if (this->mapping_)
+		{
+			CloseHandle(this->mapping_);
+		}
+
+		if (this->file_)
+		{
+			CloseHandle(this->file_);
+		}
+
+		this->file_ = nullptr;
+		this->mapping_ = nullptr;
+		this->data_ = nullptr;
+		this->size_ = 0;
+	}
+#else
+	bool mapped_file::open(const std::string& path)
+	{
+		this->close();
+
+		const auto fd = ::open(path.data(), O_RDONLY);
+		if (fd < 0)
+		{
+			return false;
+		}
+
+		struct stat st{};
+		if (fstat(fd, &st) != 0)
+		{
+			::close(fd);
+			return false;
+		}
+
+		this->file_ = reinterpret_cast<void*>(static_cast<std::intptr_t>(fd) + 1);
+		this->size_ = static_cast<std::size_t>(st.st_size);
+		if (this->size_ == 0)
+		{
+			return true;
+		}
+
+		const auto data = mmap(nullptr, this->size_, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (data == MAP_FAILED)
+		{
+			this->close();
+			return false;
+		}
+
+		this->mapping_ = data;
+		this->data_ = static_cast<const std::uint8_t*>(data);
+		return true;
+	}
+
+	void mapped_file::close()
+	{
+		if (this->mapping_)
+		{
+			munmap(this->mapping_, this->size_);
+		}
+
+		if (this->file_)
+		{
+			::close(static_cast<int>(reinterpret_cast<std::intptr_t>(this->file_) - 1));
+		}
+
+		this->file_ = nullptr;
+		this->mapping_ = nullptr;
+		this->data_ = nullptr;
+		this->size_ = 0;
+	}
+#endif
+
+	bool mapped_file::is_open() const
+	{
+		return this->file_ != nullptr;
+	}
+
+	const std::uint8_t* mapped_file::data() const
+	{
+		return this->data_;
+	}
+
+	std::size_t mapped_file::size() const
+	{
+		return this->size_;
+	}
+
+	std::string_view mapped_file::view() const
+	{
+		return {reinterpret_cast<const char*>(this->data_), this->size_};
+	}
+
+	std::string_view mapped_file::view(const std::size_t offset, const std::size_t size) const
+	{
+		if (offset >= this->size_)
+		{
+			return {};
+		}
+
+		return {reinterpret_cast<const char*>(this->data_) + offset, std::min(size, this->size_ - offset)};
+	}
+}
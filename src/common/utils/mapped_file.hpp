@@ -0,0 +1,42 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <cstdint>
+
+namespace utils
+{
+	// read-only view of a whole file, backed by a file mapping instead of a heap copy
+	class mapped_file final
+	{
+	public:
+		mapped_file() = default;
+		mapped_file(const std::string& path);
+		~mapped_file();
+
+		mapped_file(const mapped_file&) = delete;
+		mapped_file& operator=(const mapped_file&) = delete;
+
+		mapped_file(mapped_file&& obj) noexcept;
+		mapped_file& operator=(mapped_file&& obj) noexcept;
+
+		bool open(const std::string& path);
+		void close();
+
+		bool is_open() const;
+
+		const std::uint8_t* data() const;
+		std::size_t size() const;
+
+		std::string_view view() const;
+		std::string_view view(std::size_t offset, std::size_t size) const;
+
+	private:
+		void* file_ = nullptr;
+		void* mapping_ = nullptr;
+		const std::uint8_t* data_ = nullptr;
+		std::size_t size_ = 0;
+
+		void move(mapped_file& obj);
+	};
+}
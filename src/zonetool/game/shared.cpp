@@ -182,6 +182,22 @@ namespace zonetool
 		return Com_HashStringLower(string);
 	}
 
+	void string_table_hash_batch(const std::string_view* strings, std::uint32_t* hashes, const std::size_t count)
+	{
+		// same as string_table_hash, without building a std::string per cell
+		for (std::size_t i = 0; i < count; i++)
+		{
+			std::uint32_t hash = 0;
+			for (const auto c : strings[i])
+			{
+				const auto uc = static_cast<unsigned char>(c);
+				hash = hash * 31 + ((uc >= 'A' && uc <= 'Z') ? uc + ('a' - 'A') : uc);
+			}
+
+			hashes[i] = hash;
+		}
+	}
+
 	std::uint32_t DDL_HashString(const char* str, int len)
 	{
 		if (!str)
@@ -134,6 +134,7 @@ namespace zonetool
 
 	std::uint32_t snd_hash_name(const char* name);
 	std::uint32_t string_table_hash(const std::string& string);
+	void string_table_hash_batch(const std::string_view* strings, std::uint32_t* hashes, std::size_t count);
 	std::uint32_t Com_HashString(const std::string& string);
 	std::uint32_t Com_HashStringLower(const std::string& string);
 	std::uint32_t Com_HashStringUpper(const std::string& string);
@@ -7,10 +7,13 @@
 #pragma warning( pop )
 
 #include "zonetool/utils/iwi.hpp"
+#include "zonetool/utils/image_budget.hpp"
 
 #include "zonetool/utils/compression.hpp"
+#include "zonetool/utils/dump_writer.hpp"
 
 #include <utils/cryptography.hpp>
+#include <utils/dds.hpp>
 #include <utils/flags.hpp>
 #include <utils/io.hpp>
 
@@ -112,6 +115,59 @@ namespace zonetool::h1
 		}
 	}
 
+	namespace dds
+	{
+		GfxImage* parse(const std::string& name, zone_memory* mem)
+		{
+			const auto path = utils::string::va("images\\%s.dds", clean_name(name).data());
+			const auto folder = filesystem::get_file_path(path);
+			if (folder.empty())
+			{
+				return nullptr;
+			}
+
+			// pixel data is copied straight from the mapped file, layouts that need a conversion go through directxtex
+			const utils::dds::file file(folder + path);
+			if (!file.is_valid())
+			{
+				return nullptr;
+			}
+
+			ZONETOOL_INFO("Parsing custom image \"%s\"", name.data());
+
+			const auto& info = file.get_info();
+			const auto pixels = file.get_payload();
+
+			auto* image = mem->allocate<GfxImage>();
+
+			image->imageFormat = static_cast<DXGI_FORMAT>(info.format);
+			image->mapType = static_cast<MapType>(info.dimension);
+			image->semantic = TS_COLOR_MAP; // material changes this
+			image->category = IMG_CATEGORY_LOAD_FROM_FILE;
+			image->width = static_cast<unsigned short>(info.width);
+			image->height = static_cast<unsigned short>(info.height);
+			image->depth = static_cast<unsigned short>(info.depth);
+			image->numElements = static_cast<unsigned short>(info.array_size);
+			image->levelCount = static_cast<unsigned char>(info.mip_levels);
+			image->streamed = 0;
+			image->dataLen1 = static_cast<int>(pixels.size());
+			image->dataLen2 = static_cast<int>(pixels.size());
+			image->pixelData = mem->allocate<unsigned char>(pixels.size());
+			std::memcpy(image->pixelData, pixels.data(), pixels.size());
+			image->name = mem->duplicate_string(name);
+
+			if (info.is_cubemap)
+			{
+				image->mapType = MAPTYPE_CUBE;
+				image->numElements = 1;
+			}
+
+			add_loaded_image_flags(image);
+
+			return image;
+		}
+	}
+
 	namespace directxtex
 	{
 		bool load_image(const std::string& name, DirectX::ScratchImage* image)
@@ -192,7 +248,12 @@ namespace zonetool::h1
 	GfxImage* gfx_image::parse_custom(const std::string& name, zone_memory* mem)
 	{
 		GfxImage* image = nullptr;
-		image = directxtex::parse(name, mem);
+		image = dds::parse(name, mem);
+		if (!image)
+		{
+			image = directxtex::parse(name, mem);
+		}
+
 		if (!image)
 		{
 			image = iwi::parse(name, mem);
@@ -235,9 +296,16 @@ namespace zonetool::h1
 		const auto image_path = utils::string::va("streamed_images\\%s_stream%i.dds",
 			clean_name(name).data(), stream);
 
+		const auto full_path = filesystem::get_file_path(image_path) + image_path;
+		const utils::dds::file file(full_path);
+		if (file.is_valid())
+		{
+			return {std::string{file.get_payload()}};
+		}
+
+		// legacy layouts that need a pixel conversion
 		DirectX::ScratchImage image{};
 
-		const auto full_path = filesystem::get_file_path(image_path) + image_path;
 		const auto full_path_w = utils::string::convert(full_path);
 		const auto result = DirectX::LoadFromDDSFile(full_path_w.data(), DirectX::DDS_FLAGS_NONE, nullptr, image);
 		if (!SUCCEEDED(result))
@@ -466,6 +534,8 @@ namespace zonetool::h1
 
 		buf->pop_stream();
 
+		image_budget::add_image(this->name(), data, this->image_stream_files);
+
 		if (data->streamed)
 		{
 			// add stream file to header
@@ -478,6 +548,10 @@ namespace zonetool::h1
 
 	void dump_streamed_image(GfxImage* image, bool is_self = false, bool dump_dds = false)
 	{
+		const std::string image_name = image->name;
+		const auto name = clean_name(image->name);
+		const auto parent_path = filesystem::get_dump_path() + "streamed_images\\";
+
 		for (auto i = 0u; i < 4; i++)
 		{
 			const auto stream_file = &stream_files[*stream_file_index + i];
@@ -504,54 +578,62 @@ namespace zonetool::h1
 			imagefile.seekg(stream_file->offset);
 			imagefile.read(buffer.data(), size);
 
-			try
-			{
-				auto pixel_data = compression::lz4::decompress_lz4_block(buffer);
-				const auto name = clean_name(image->name);
+			const auto width = image->streams[i].width;
+			const auto height = image->streams[i].height;
+			const auto format = DXGI_FORMAT(image->imageFormat);
 
-				{
-					std::string parent_path = filesystem::get_dump_path() + "streamed_images\\";
-					std::string raw_path = utils::string::va("%s%s_stream%i.pixels", parent_path.data(), name.data(), i);
-					utils::io::write_file(raw_path, pixel_data, false);
-				}
+			// taken before buffer is moved into the task, the order arguments are evaluated in is unspecified
+			const auto buffer_size = buffer.size();
 
-				if (dump_dds)
+			// decompressing and writing happens on the writer pool so the loader thread isn't held up
+			dump_writer::enqueue(buffer_size, [=, buffer = std::move(buffer)]
+			{
+				try
 				{
-					DirectX::Image img = {};
-
-					img.width = image->streams[i].width;
-					img.height = image->streams[i].height;
-					img.pixels = reinterpret_cast<uint8_t*>(pixel_data.data());
-					img.format = DXGI_FORMAT(image->imageFormat);
-
-					size_t row_pitch{};
-					size_t slice_pitch{};
-
-					DirectX::ComputePitch(img.format, img.width, img.height, row_pitch, slice_pitch);
-
-					img.rowPitch = row_pitch;
-					img.slicePitch = slice_pitch;
+					auto pixel_data = compression::lz4::decompress_lz4_block(buffer);
 
-					const auto parent_path = filesystem::get_dump_path() + "streamed_images\\";
-					const std::string spath = utils::string::va("%s\\%s_stream%i.dds", parent_path.data(),
-						name.data(), i);
-					const std::wstring wpath(spath.begin(), spath.end());
-					if (!std::filesystem::exists(parent_path))
 					{
-						std::filesystem::create_directories(parent_path);
+						std::string raw_path = utils::string::va("%s%s_stream%i.pixels", parent_path.data(), name.data(), i);
+						utils::io::write_file(raw_path, pixel_data, false);
 					}
 
-					auto result = DirectX::SaveToDDSFile(img, DirectX::DDS_FLAGS_NONE, wpath.data());
-					if (FAILED(result))
+					if (dump_dds)
 					{
-						ZONETOOL_WARNING("Failed to dump image \"%s.dds\"", image->name);
+						DirectX::Image img = {};
+
+						img.width = width;
+						img.height = height;
+						img.pixels = reinterpret_cast<uint8_t*>(pixel_data.data());
+						img.format = format;
+
+						size_t row_pitch{};
+						size_t slice_pitch{};
+
+						DirectX::ComputePitch(img.format, img.width, img.height, row_pitch, slice_pitch);
+
+						img.rowPitch = row_pitch;
+						img.slicePitch = slice_pitch;
+
+						const std::string spath = utils::string::va("%s\\%s_stream%i.dds", parent_path.data(),
+							name.data(), i);
+						const std::wstring wpath(spath.begin(), spath.end());
+						if (!std::filesystem::exists(parent_path))
+						{
+							std::filesystem::create_directories(parent_path);
+						}
+
+						auto result = DirectX::SaveToDDSFile(img, DirectX::DDS_FLAGS_NONE, wpath.data());
+						if (FAILED(result))
+						{
+							ZONETOOL_WARNING("Failed to dump image \"%s.dds\"", image_name.data());
+						}
 					}
 				}
-			}
-			catch (...)
-			{
-				ZONETOOL_ERROR("Failed to dump streamed image \"%s\"", image->name);
-			}
+				catch (...)
+				{
+					ZONETOOL_ERROR("Failed to dump streamed image \"%s\"", image_name.data());
+				}
+			});
 		}
 
 		{
@@ -568,14 +650,8 @@ namespace zonetool::h1
 		}
 	}
 
-	void dump_image_dds(GfxImage* image)
+	void save_image_dds(GfxImage* image, const std::string& parent_path, const std::string& spath)
 	{
-		if (image->streamed)
-		{
-			dump_streamed_image(image, stream_files[*stream_file_index].fileIndex == 96, true);
-			return;
-		}
-
 		auto* data = image->pixelData;
 		std::size_t data_used = 0;
 
@@ -638,8 +714,6 @@ namespace zonetool::h1
 			mdata.miscFlags |= DirectX::TEX_MISC_FLAG::TEX_MISC_TEXTURECUBE;
 		}
 
-		std::string parent_path = filesystem::get_dump_path() + "images\\";
-		std::string spath = parent_path + clean_name(image->name) + ".dds";
 		std::wstring wpath(spath.begin(), spath.end());
 
 		if (!std::filesystem::exists(parent_path))
@@ -654,6 +728,38 @@ namespace zonetool::h1
 		}
 	}
 
+	void dump_image_dds(GfxImage* image)
+	{
+		if (image->streamed)
+		{
+			dump_streamed_image(image, stream_files[*stream_file_index].fileIndex == 96, true);
+			return;
+		}
+
+		if (!image->pixelData)
+		{
+			ZONETOOL_WARNING("Failed to dump image \"%s.dds\"", image->name);
+			return;
+		}
+
+		const auto parent_path = filesystem::get_dump_path() + "images\\";
+		const auto spath = parent_path + clean_name(image->name) + ".dds";
+
+		// the writer pool owns a copy of the pixels, the zone may be unloaded before it runs
+		std::string pixels(reinterpret_cast<const char*>(image->pixelData), image->dataLen1);
+		std::string name = image->name;
+
+		// taken before pixels is moved into the task, the order arguments are evaluated in is unspecified
+		const auto pixels_size = pixels.size();
+		dump_writer::enqueue(pixels_size, [image_copy = *image, pixels = std::move(pixels),
+			name = std::move(name), parent_path, spath]() mutable
+		{
+			image_copy.pixelData = reinterpret_cast<unsigned char*>(pixels.data());
+			image_copy.name = name.data();
+			save_image_dds(&image_copy, parent_path, spath);
+		});
+	}
+
 	void gfx_image::dump(GfxImage* asset)
 	{
 		if (utils::flags::has_flag("dds"))
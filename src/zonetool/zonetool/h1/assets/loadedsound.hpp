@@ -1,6 +1,8 @@
 #pragma once
 #include "../zonetool.hpp"
 
+#include "zonetool/utils/audio_ingest.hpp"
+
 namespace zonetool::h1
 {
 	class loaded_sound : public asset_interface
@@ -8,10 +10,10 @@ namespace zonetool::h1
 	private:
 		std::string name_;
 		LoadedSound* asset_ = nullptr;
+		std::shared_ptr<audio_ingest::sound_file> sound_file_;
 
 	public:
-		LoadedSound* parse_flac(const std::string& name, zone_memory* mem);
-		LoadedSound* parse_wav(const std::string& name, zone_memory* mem);
+		LoadedSound* parse_sound_file(const std::shared_ptr<audio_ingest::sound_file>& sound, zone_memory* mem);
 		LoadedSound* parse(const std::string& name, zone_memory* mem);
 
 		void init(const std::string& name, zone_memory* mem) override;
@@ -24,7 +26,7 @@ namespace zonetool::h1
 		std::int32_t type() override;
 		void write(zone_base* zone, zone_buffer* buffer) override;
 
-		static void dump_data(LoadedSound* asset, char* data, size_t size, const std::string& extension = "");
+		static void dump_data(LoadedSound* asset, const char* data, size_t size, const std::string& extension = "");
 		static void dump(LoadedSound* asset);
 	};
 }
\ No newline at end of file
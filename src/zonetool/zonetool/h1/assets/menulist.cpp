@@ -1,6 +1,8 @@
 #include <std_include.hpp>
 #include "menulist.hpp"
 
+#include <utils/io.hpp>
+
 //#define VER_1_4
 
 // trash code, ignore all warnings
@@ -1343,6 +1345,63 @@ namespace zonetool::h1
 	std::vector<parse_menudef_func> p_md_funcs;
 	std::vector<parse_itemdef_func> p_id_funcs;
 
+	// lowercase keyword -> parse func, keywords are matched case-insensitively like _stricmp
+	std::unordered_map<std::string, parse_menudef_func*> p_md_keywords;
+	std::unordered_map<std::string, parse_itemdef_func*> p_id_keywords;
+
+	std::string get_keyword_key(const char* keyword)
+	{
+		std::string key = keyword;
+		std::transform(key.begin(), key.end(), key.begin(), [](const unsigned char c)
+		{
+			return static_cast<char>(std::tolower(c));
+		});
+		return key;
+	}
+
+	template <typename T>
+	void build_keyword_table(std::vector<T>& funcs, std::unordered_map<std::string, T*>& table)
+	{
+		table.reserve(funcs.size());
+		for (auto& func : funcs)
+		{
+			// the first registration wins, same as the linear search this replaces
+			table.try_emplace(get_keyword_key(func.keyword), &func);
+		}
+	}
+
+	// only set by menu_list::benchmark, which runs on the command thread while no other menu is parsed.
+	// the lexer state is global anyway, so menus are never parsed concurrently
+	namespace
+	{
+		// parses the way the lexer did before tokens were recycled and keywords were hashed,
+		// so the benchmark can compare both on the same menus
+		bool reference_parser = false;
+
+		// keeps the per-file log line out of the benchmark timings
+		bool benchmarking = false;
+	}
+
+	template <typename T>
+	T* find_keyword(std::vector<T>& funcs, const std::unordered_map<std::string, T*>& table, const char* keyword)
+	{
+		if (reference_parser)
+		{
+			for (auto& func : funcs)
+			{
+				if (!_stricmp(keyword, func.keyword))
+				{
+					return &func;
+				}
+			}
+
+			return nullptr;
+		}
+
+		const auto iter = table.find(get_keyword_key(keyword));
+		return iter != table.end() ? iter->second : nullptr;
+	}
+
 	//list with global defines added to every source loaded
 	define_s* globaldefines;
 
@@ -1357,6 +1416,7 @@ namespace zonetool::h1
 		std::vector<std::uint8_t> buffer_;
 		std::size_t mem_pos_;
 		std::recursive_mutex mutex_;
+		token_s* free_tokens_ = nullptr;
 
 		void allocate_memory(std::size_t size)
 		{
@@ -1425,6 +1485,29 @@ namespace zonetool::h1
 			// return pointer
 			return reinterpret_cast<T*>(pointer);
 		}
+
+		// every unread copies a token, so freed ones are reused instead of growing the buffer
+		token_s* allocate_token()
+		{
+			std::lock_guard<std::recursive_mutex> g(this->mutex_);
+
+			if (!this->free_tokens_)
+			{
+				return this->allocate<token_s>();
+			}
+
+			auto* token = this->free_tokens_;
+			this->free_tokens_ = token->next;
+			return token;
+		}
+
+		void free_token(token_s* token)
+		{
+			std::lock_guard<std::recursive_mutex> g(this->mutex_);
+
+			token->next = this->free_tokens_;
+			this->free_tokens_ = token;
+		}
 	};
 	menu_memory* mmem;
 	zone_memory* zmem;
@@ -1595,6 +1678,50 @@ namespace zonetool::h1
 		token->linescrossed = 0;
 	}
 
+	// tokens carry a MAX_TOKEN string buffer, only clear and copy the part that is in use
+	void PC_ClearToken(token_s* token)
+	{
+		if (reference_parser)
+		{
+			memset(token, 0, sizeof(token_s));
+			return;
+		}
+
+		token->string[0] = 0;
+		token->string[MAX_TOKEN - 1] = 0;
+		token->type = 0;
+		token->subtype = 0;
+		token->intvalue = 0;
+		token->floatvalue = 0;
+		token->whitespace_p = 0;
+		token->endwhitespace_p = 0;
+		token->line = 0;
+		token->linescrossed = 0;
+		token->next = 0;
+	}
+
+	void PC_CopyTokenData(token_s* dest, const token_s* src)
+	{
+		if (reference_parser)
+		{
+			memcpy(dest, src, sizeof(token_s));
+			return;
+		}
+
+		const auto len = strnlen(src->string, MAX_TOKEN - 1);
+		memcpy(dest->string, src->string, len);
+		dest->string[len] = 0;
+		dest->type = src->type;
+		dest->subtype = src->subtype;
+		dest->intvalue = src->intvalue;
+		dest->floatvalue = src->floatvalue;
+		dest->whitespace_p = src->whitespace_p;
+		dest->endwhitespace_p = src->endwhitespace_p;
+		dest->line = src->line;
+		dest->linescrossed = src->linescrossed;
+		dest->next = src->next;
+	}
+
 	int PS_ReadEscapeCharacter(script_s* script, char* cha)
 	{
 		char c, val, i;
@@ -1764,7 +1891,7 @@ namespace zonetool::h1
 		}
 		token->string[len] = 0;
 		//copy the token into the script structure
-		memcpy(&script->token, token, sizeof(token_s));
+		PC_CopyTokenData(&script->token, token);
 		//primitive reading successfull
 		return 1;
 	}
@@ -1775,7 +1902,7 @@ namespace zonetool::h1
 		const char* p;
 		punctuation_s* punc;
 
-		for (punc = script->punctuationtable[(unsigned int)*script->script_p]; punc; punc = punc->next)
+		for (punc = script->punctuationtable[static_cast<unsigned char>(*script->script_p)]; punc; punc = punc->next)
 		{
 			p = punc->p;
 			len = strlen(p);
@@ -1993,12 +2120,12 @@ namespace zonetool::h1
 		if (script->tokenavailable)
 		{
 			script->tokenavailable = 0;
-			memcpy(token, &script->token, sizeof(token_s));
+			PC_CopyTokenData(token, &script->token);
 			return 1;
 		}
 		script->lastscript_p = script->script_p;
 		script->lastline = script->line;
-		memset(token, 0, sizeof(token_s));
+		PC_ClearToken(token);
 		script->whitespace_p = script->script_p;
 		token->whitespace_p = script->script_p;
 		if (!PS_ReadWhiteSpace(script))
@@ -2048,7 +2175,7 @@ namespace zonetool::h1
 		{
 			return 0;
 		}
-		memcpy(&script->token, token, sizeof(script->token));
+		PC_CopyTokenData(&script->token, token);
 		return 1;
 	}
 
@@ -2092,7 +2219,9 @@ namespace zonetool::h1
 
 	void PC_FreeToken(token_s* token)
 	{
-		//FreeMemory(token);
+		//the reference parser never reused tokens
+		if (!reference_parser)
+			mmem->free_token(token);
 		--numtokens;
 	}
 
@@ -2127,7 +2256,7 @@ namespace zonetool::h1
 			//FreeScript(script);
 		}
 		//copy the already available token
-		memcpy_s(token, sizeof(token_s), source->tokens, sizeof(token_s));
+		PC_CopyTokenData(token, source->tokens);
 		//free the read token
 		t = source->tokens;
 		source->tokens = source->tokens->next;
@@ -2139,10 +2268,10 @@ namespace zonetool::h1
 	{
 		token_s* copy;
 
-		copy = mmem->allocate<token_s>();
+		copy = mmem->allocate_token();
 		if (copy)
 		{
-			memcpy(copy, token, sizeof(token_s));
+			PC_CopyTokenData(copy, token);
 			copy->next = 0;
 			++numtokens;
 		}
@@ -3510,31 +3639,27 @@ namespace zonetool::h1
 		return size;
 	}
 
-	void __cdecl PS_CreatePunctuationTable(script_s* script, punctuation_s* punctuations)
+	void __cdecl PS_CreatePunctuationTable(punctuation_s** punctuationtable, punctuation_s* punctuations)
 	{
 		punctuation_s* lastp;
 		int i;
 		punctuation_s* newp;
 		punctuation_s* p;
 
-		if (!script->punctuationtable)
-			script->punctuationtable = mmem->allocate<punctuation_s*>(256);
-		//memset((unsigned __int8*)script->punctuationtable, 0, 0x400u);
-		for (i = 0; punctuations[i].p; ++i)
+		//the list ends with an empty punctuation
+		for (i = 0; punctuations[i].p && *punctuations[i].p; ++i)
 		{
 			newp = &punctuations[i];
 			lastp = 0;
-			for (p = script->punctuationtable[*punctuations[i].p]; p; p = p->next)
+			for (p = punctuationtable[static_cast<unsigned char>(*newp->p)]; p; p = p->next)
 			{
-				newp->p;
-				p->p;
 				if (strlen(p->p) < strlen(newp->p))
 				{
 					newp->next = p;
 					if (lastp)
 						lastp->next = newp;
 					else
-						script->punctuationtable[*newp->p] = newp;
+						punctuationtable[static_cast<unsigned char>(*newp->p)] = newp;
 					break;
 				}
 				lastp = p;
@@ -3545,14 +3670,22 @@ namespace zonetool::h1
 				if (lastp)
 					lastp->next = newp;
 				else
-					script->punctuationtable[*newp->p] = newp;
+					punctuationtable[static_cast<unsigned char>(*newp->p)] = newp;
 			}
 		}
 	}
 
 	void SetScriptPunctuations(script_s* script)
 	{
-		PS_CreatePunctuationTable(script, default_punctuations);
+		//the table links the default punctuations together, so every script shares one built on first use
+		static punctuation_s* punctuationtable[256]{};
+		static std::once_flag once;
+		std::call_once(once, []
+		{
+			PS_CreatePunctuationTable(punctuationtable, default_punctuations);
+		});
+
+		script->punctuationtable = punctuationtable;
 		script->punctuations = default_punctuations;
 	}
 
@@ -3567,8 +3700,8 @@ namespace zonetool::h1
 		auto file = filesystem::file(pathname);
 		file.open("rb");
 		fp = file.get_fp();
-		length = file.size();
 		if (!fp) return 0;
+		length = static_cast<int>(file.size());
 		script = mmem->manual_allocate<script_s>(length + sizeof(script_s) + 1);
 		strcpy(script->filename, filename);
 		script->buffer = (char*)script + sizeof(script_s);
@@ -3581,7 +3714,7 @@ namespace zonetool::h1
 		script->line = 1;
 		script->lastline = 1;
 		SetScriptPunctuations(script);
-		memcpy(script->buffer, file.read_bytes(length).data(), length);
+		file.read(script->buffer, length, 1);
 		file.close();
 		script->length = Com_Compress(script->buffer);
 		return script;
@@ -4350,7 +4483,7 @@ namespace zonetool::h1
 			if (!PC_ExpandDefineIntoSource(source, token, define))
 				return 0;
 		}
-		memcpy(&source->token, token, sizeof(source->token));
+		PC_CopyTokenData(&source->token, token);
 		return 1;
 	}
 
@@ -4378,7 +4511,9 @@ namespace zonetool::h1
 		if (!sourceFile)
 			return 0;
 		ret = PC_ReadToken(sourceFile, &token); // PC_ReadToken(sourceFiles[handle], &token);
-		memcpy(pc_token->string, token.string, 0x400);
+		const auto len = strnlen(token.string, sizeof(pc_token->string) - 1);
+		memcpy(pc_token->string, token.string, len);
+		pc_token->string[len] = 0;
 		pc_token->type = token.type;
 		pc_token->subtype = token.subtype;
 		pc_token->intvalue = token.intvalue;
@@ -7587,16 +7722,11 @@ namespace zonetool::h1
 			p_id_funcs.push_back({ "newsfeed", ItemParse_newsfeed });
 			p_id_funcs.push_back({ "glowColor", ItemParse_glowColor });
 			p_id_funcs.push_back({ "decodeEffect", ItemParse_decodeEffect });
-		}
 
-		for (auto i = 0; i < p_id_funcs.size(); i++)
-		{
-			if (!_stricmp(keyword, p_id_funcs.at(i).keyword))
-			{
-				return &p_id_funcs.at(i);
-			}
+			build_keyword_table(p_id_funcs, p_id_keywords);
 		}
-		return nullptr;
+
+		return find_keyword(p_id_funcs, p_id_keywords, keyword);
 	}
 
 	int Item_Parse(/*int handle,*/ itemDef_t* item)
@@ -7706,16 +7836,11 @@ namespace zonetool::h1
 			p_md_funcs.push_back({ "hiddenDuringUI", MenuParse_hiddenDuringUI });
 			p_md_funcs.push_back({ "allowedBinding", MenuParse_allowedBinding });
 			p_md_funcs.push_back({ "textOnlyFocus", MenuParse_textOnlyFocus });
-		}
 
-		for (auto i = 0; i < p_md_funcs.size(); i++)
-		{
-			if (!_stricmp(keyword, p_md_funcs.at(i).keyword))
-			{
-				return &p_md_funcs.at(i);
-			}
+			build_keyword_table(p_md_funcs, p_md_keywords);
 		}
-		return nullptr;
+
+		return find_keyword(p_md_funcs, p_md_keywords, keyword);
 	}
 
 	int Menu_Parse(/*int handle,*/ menuDef_t* menu)
@@ -7807,7 +7932,10 @@ namespace zonetool::h1
 		builtinDefines[0] = "PC";
 		builtinDefines[1] = 0;
 
-		ZONETOOL_INFO("Parsing menu '%s'...", menuFile);
+		if (!benchmarking)
+		{
+			ZONETOOL_INFO("Parsing menu '%s'...", menuFile);
+		}
 
 		handle = PC_LoadSourceHandle(menuFile, builtinDefines);
 
@@ -8640,6 +8768,17 @@ namespace zonetool::h1
 		emit_menu_def(asset);
 	}
 
+	void menu_list::emit_menu_list(MenuList* asset)
+	{
+		indentCounter = 0;
+		push_indent();
+		for (int i = 0; i < asset->menuCount; i++)
+		{
+			dump_menudef(asset->menus[i]);
+		}
+		pop_indent();
+	}
+
 	void menu_list::dump(MenuList* asset)
 	{
 		const auto path = asset->name;
@@ -8650,16 +8789,157 @@ namespace zonetool::h1
 		if (fp)
 		{
 			ZONETOOL_INFO("Dumping menu \"%s\"...", asset->name);
-			indentCounter = 0;
-			push_indent();
-			for (int i = 0; i < asset->menuCount; i++)
+			emit_menu_list(asset);
+		}
+
+		file.close();
+	}
+
+	void menu_list::benchmark(const std::string& folder, const int iterations)
+	{
+		if (!utils::io::directory_exists(folder))
+		{
+			ZONETOOL_ERROR("Menu folder \"%s\" does not exist", folder.data());
+			return;
+		}
+
+		// both parses are emitted the way they are dumped, so mismatches can be diffed
+		const std::filesystem::path output = "dump/menu_benchmark";
+		const auto output_dir = std::filesystem::absolute(output);
+
+		// dumped menu lists start with the brace that opens the list
+		std::vector<std::filesystem::path> files;
+		for (const auto& entry : std::filesystem::recursive_directory_iterator(folder))
+		{
+			if (!entry.is_regular_file())
 			{
-				dump_menudef(asset->menus[i]);
+				continue;
+			}
+
+			// skip the output of earlier runs
+			const auto path = std::filesystem::absolute(entry.path());
+			if (std::mismatch(output_dir.begin(), output_dir.end(), path.begin(), path.end()).first == output_dir.end())
+			{
+				continue;
+			}
+
+			const auto data = utils::io::read_file(entry.path().string());
+			const auto start = data.find_first_not_of(" \t\r\n");
+			if (start != std::string::npos && data[start] == '{')
+			{
+				files.emplace_back(entry.path());
 			}
-			pop_indent();
 		}
 
-		file.close();
+		if (files.empty())
+		{
+			ZONETOOL_ERROR("No menu files found in \"%s\"", folder.data());
+			return;
+		}
+
+		// only holds the parsed menus, the lexer has its own menu_memory
+		constexpr std::size_t memory_size = 1024 * 1024 * 128;
+		zone_memory reference_mem(memory_size);
+		zone_memory current_mem(memory_size);
+
+		std::chrono::steady_clock::duration reference_time{};
+		std::chrono::steady_clock::duration current_time{};
+		auto menus = 0;
+		auto mismatches = 0;
+
+		benchmarking = true;
+		const auto _ = gsl::finally([]
+		{
+			benchmarking = false;
+			reference_parser = false;
+		});
+
+		const auto parse_timed = [&](const std::string& name, const bool reference, zone_memory& mem,
+			std::chrono::steady_clock::duration& time) -> MenuList*
+		{
+			reference_parser = reference;
+			const auto _ = gsl::finally([]
+			{
+				reference_parser = false;
+			});
+
+			MenuList* result = nullptr;
+			for (auto i = 0; i < iterations; i++)
+			{
+				mem.clear();
+
+				const auto start = std::chrono::steady_clock::now();
+				result = parse(name, &mem);
+				time += std::chrono::steady_clock::now() - start;
+			}
+
+			return result;
+		};
+
+		const auto emit = [](MenuList* asset, const std::filesystem::path& path)
+		{
+			std::filesystem::create_directories(path.parent_path());
+
+			fp = nullptr;
+			fopen_s(&fp, path.string().data(), "wb");
+			if (!fp)
+			{
+				ZONETOOL_ERROR("Could not write \"%s\"", path.string().data());
+				return std::string{};
+			}
+
+			if (asset)
+			{
+				emit_menu_list(asset);
+			}
+
+			fclose(fp);
+			fp = nullptr;
+
+			return utils::io::read_file(path.string());
+		};
+
+		for (const auto& file : files)
+		{
+			const auto name = file.generic_string();
+			const auto relative = std::filesystem::relative(file, folder);
+
+			auto* reference = parse_timed(name, true, reference_mem, reference_time);
+			auto* current = parse_timed(name, false, current_mem, current_time);
+
+			const auto reference_path = output / "reference" / relative;
+			const auto current_path = output / "current" / relative;
+
+			const auto reference_text = emit(reference, reference_path);
+			const auto current_text = emit(current, current_path);
+
+			if (!reference || !current || reference_text != current_text)
+			{
+				ZONETOOL_ERROR("Menu \"%s\" parses differently, compare \"%s\" with \"%s\"",
+					name.data(), reference_path.string().data(), current_path.string().data());
+				mismatches++;
+				continue;
+			}
+
+			menus += current->menuCount;
+		}
+
+		const auto to_ms = [](const std::chrono::steady_clock::duration& time)
+		{
+			return std::chrono::duration<double, std::milli>(time).count();
+		};
+
+		ZONETOOL_INFO("Parsed %zu menu file(s) %d time(s): reference %.2f ms, current %.2f ms",
+			files.size(), iterations, to_ms(reference_time), to_ms(current_time));
+
+		if (mismatches)
+		{
+			ZONETOOL_ERROR("%d of %zu menu file(s) differ from the reference parser", mismatches, files.size());
+		}
+		else
+		{
+			ZONETOOL_INFO("All %d menuDef(s) match the reference parser", menus);
+		}
 	}
 }
 
@@ -13,6 +13,7 @@ namespace zonetool::h1
 		static FILE* fp;
 
 		static void dump_menudef(menuDef_t* asset);
+		static void emit_menu_list(MenuList* asset);
 
 		static void emit_menu_def(menuDef_t* asset);
 		static void emit_item_def(itemDef_t* item);
@@ -62,5 +63,9 @@ namespace zonetool::h1
 		void write(zone_base* zone, zone_buffer* buffer) override;
 
 		static void dump(MenuList* asset);
+
+		// parses every dumped menu list under folder with the reference and the current parser,
+		// compares the emitted menuDefs and times both
+		static void benchmark(const std::string& folder, int iterations);
 	};
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include "zonetool/s1/assets/mapents.hpp"
 
 #include "zonetool/utils/gsc.hpp"
+#include "zonetool/utils/mapents.hpp"
 
 namespace zonetool::h1
 {
@@ -16,27 +17,26 @@ namespace zonetool::h1
 			{
 				std::string out_buffer;
 
-				const auto lines = utils::string::split(source, '\n');
+				::mapents::line_reader reader(source);
+				std::string_view line;
 
-				for (auto i = 0; i < lines.size(); i++)
+				while (reader.next(line))
 				{
 					const auto _0 = gsl::finally([&]
 					{
 						out_buffer.append("\n");
 					});
 
-					const auto& line = lines[i];
-
-					std::regex expr(R"~((.+) "(.*)")~");
-					std::smatch match{};
-					if (!line.starts_with("0 ") && std::regex_search(line, match, expr))
+					std::string_view key_view;
+					std::string_view value_view;
+					if (!line.starts_with("0 ") && ::mapents::split_key_value(line, key_view, value_view))
 					{
-						const auto value = match[2].str();
+						const std::string value{value_view};
 
-						const auto id = std::atoi(match[1].str().data());
+						const auto id = std::atoi(std::string{key_view}.data());
 						if (id == 0) // invalid id
 						{
-							out_buffer.append(line.data());
+							out_buffer.append(line);
 							continue;
 						}
 
@@ -3,6 +3,7 @@
 #include "zone.hpp"
 #include "zonetool/utils/utils.hpp"
 #include "zonetool/utils/imagefile.hpp"
+#include "zonetool/utils/image_budget.hpp"
 
 #include <utils/flags.hpp>
 #include <utils/io.hpp>
@@ -82,6 +83,42 @@ namespace zonetool::h1
 			}
 		}
 
+		this->add_asset_by_pointer(type, pointer, name);
+	}
+
+	void zone_interface::add_assets_of_type_by_pointer(std::int32_t type, const std::vector<void*>& pointers)
+	{
+		// collect the existing names once, scanning m_assets for every entry is quadratic for large batches
+		std::unordered_set<std::string> names;
+		for (const auto& asset : m_assets)
+		{
+			if (asset->type() == type)
+			{
+				names.emplace(asset->name());
+			}
+		}
+
+		m_assets.reserve(m_assets.size() + pointers.size());
+
+		for (const auto pointer : pointers)
+		{
+			if (!pointer)
+			{
+				continue;
+			}
+
+			const std::string name = get_asset_name(XAssetType(type), pointer);
+			if (!names.emplace(name).second)
+			{
+				continue;
+			}
+
+			this->add_asset_by_pointer(type, pointer, name);
+		}
+	}
+
+	void zone_interface::add_asset_by_pointer(std::int32_t type, void* pointer, const std::string& name)
+	{
 #define ADD_ASSET_PTR(__type__, ___) \
 		if (type == __type__) \
 		{ \
@@ -116,7 +153,7 @@ namespace zonetool::h1
 		}
 
 		// add ignore assets as referenced
-		if (ignore_assets.find(std::make_pair(static_cast<std::uint32_t>(type), name)) != ignore_assets.end())
+		if (ignore_assets.contains(static_cast<std::uint32_t>(type), name))
 		{
 			if (!name.starts_with(","))
 			{
@@ -540,6 +577,8 @@ namespace zonetool::h1
 		// pop stream
 		buf->pop_stream();
 
+		image_budget::report(this->name_);
+
 		// update zone header
 		zone->size = static_cast<std::uint64_t>(buf->size() - headersize);
 		zone->externalsize = 0;
@@ -10,6 +10,8 @@ namespace zonetool::h1
 		std::vector<std::shared_ptr<asset_interface>> m_assets;
 		std::shared_ptr<zone_memory> m_zonemem;
 
+		void add_asset_by_pointer(std::int32_t type, void* pointer, const std::string& name);
+
 	public:
 		zone_interface(std::string name);
 		~zone_interface();
@@ -19,6 +21,7 @@ namespace zonetool::h1
 		void* get_asset_pointer(std::int32_t type, const std::string& name) override;
 
 		void add_asset_of_type_by_pointer(std::int32_t type, void* pointer) override;
+		void add_assets_of_type_by_pointer(std::int32_t type, const std::vector<void*>& pointers) override;
 
 		void add_asset_of_type(std::int32_t type, const std::string& name) override;
 		void add_asset_of_type(const std::string& type, const std::string& name) override;
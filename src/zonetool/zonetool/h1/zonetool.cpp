@@ -5,8 +5,13 @@
 
 #include "../utils/gsc.hpp"
 #include "../utils/csv_generator.hpp"
+#include "../utils/zone_source.hpp"
+#include "../utils/dump_writer.hpp"
+#include "../utils/sound_pak.hpp"
+#include "../utils/audio_ingest.hpp"
 
 #include <utils/io.hpp>
+#include <utils/flags.hpp>
 
 namespace zonetool::h1
 {
@@ -22,7 +27,14 @@ namespace zonetool::h1
 	std::vector<std::pair<XAssetType, std::string>> referenced_assets;
 	std::unordered_set<XAssetType> asset_type_filter;
 
-	std::unordered_set<std::pair<std::uint32_t, std::string>, pair_hash<std::uint32_t, std::string>> ignore_assets;
+	asset_manifest::asset_set ignore_assets;
+
+	// assets of common zones that map dumps skip, loaded from manifests
+	asset_manifest::asset_set common_assets;
+
+	asset_manifest::builder manifest_builder;
+	std::string manifest_zone;
+	std::atomic_bool building_manifest{};
 
 	const char* get_asset_name(XAssetType type, void* pointer)
 	{
@@ -476,6 +488,11 @@ namespace zonetool::h1
 			ZONETOOL_INFO("Loading asset \"%s\" of type %s.", get_asset_name(asset), type_to_string(asset->type));
 		}
 
+		if (building_manifest)
+		{
+			manifest_builder.add(asset->type, get_asset_name(asset));
+		}
+
 		if (globals.dump_csv)
 		{
 			if (globals.csv_file.get_fp() == nullptr)
@@ -507,6 +524,11 @@ namespace zonetool::h1
 			return;
 		}
 
+		if (common_assets.contains(asset->type, get_asset_name(asset)))
+		{
+			return;
+		}
+
 		const auto dump_func = dump_functions.find(globals.target_game);
 		if (dump_func == dump_functions.end())
 		{
@@ -534,6 +556,11 @@ namespace zonetool::h1
 
 			const auto asset_name = &asset.second[1];
 
+			if (common_assets.contains(asset.first, asset_name))
+			{
+				continue;
+			}
+
 			if (asset.first == ASSET_TYPE_IMAGE)
 			{
 				ZONETOOL_WARNING("Not dumping referenced asset \"%s\" of type \"%s\"", asset_name, type_to_string(asset.first));
@@ -566,6 +593,16 @@ namespace zonetool::h1
 	{
 		globals.verify = false;
 
+		if (building_manifest)
+		{
+			if (manifest_builder.write(manifest_zone))
+			{
+				ZONETOOL_INFO("Manifest for zone \"%s\" written (%llu assets)", manifest_zone.data(), manifest_builder.size());
+			}
+
+			building_manifest = false;
+		}
+
 		if (globals.dump_csv)
 		{
 			globals.csv_file.close();
@@ -579,12 +616,54 @@ namespace zonetool::h1
 		}
 
 		dump_refs();
+		sound_pak::flush();
+
+		// wait for images still being written by the dump writer pool
+		dump_writer::flush();
 
 		ZONETOOL_INFO("Zone \"%s\" dumped.", filesystem::get_fastfile().data());
 
 		globals.dump = false;
 	}
 
+	namespace
+	{
+		// reflection probe pixels have to outlive the zone they were loaded from since the gfxworld converter
+		// reads them later on, chunks are kept for the lifetime of the process
+		class probe_pixel_store
+		{
+		public:
+			unsigned char* store(const unsigned char* data, const std::size_t size)
+			{
+				std::lock_guard _(this->mutex_);
+
+				if (this->chunks_.empty() || this->chunk_pos_ + size > this->chunk_size_)
+				{
+					// probes larger than a chunk get a dedicated allocation
+					this->chunk_size_ = std::max(chunk_size, size);
+					this->chunks_.emplace_back(std::make_unique<unsigned char[]>(this->chunk_size_));
+					this->chunk_pos_ = 0;
+				}
+
+				const auto ptr = &this->chunks_.back()[this->chunk_pos_];
+				std::memcpy(ptr, data, size);
+				this->chunk_pos_ += size;
+
+				return ptr;
+			}
+
+		private:
+			static constexpr std::size_t chunk_size = 1024 * 1024 * 32; // 32mb
+
+			std::mutex mutex_;
+			std::vector<std::unique_ptr<unsigned char[]>> chunks_;
+			std::size_t chunk_size_ = 0;
+			std::size_t chunk_pos_ = 0;
+		};
+
+		probe_pixel_store reflection_probe_pixels;
+	}
+
 	utils::hook::detour db_link_x_asset_entry1_hook;
 	XAssetEntry* db_link_x_asset_entry1(XAssetType type, XAssetHeader* header)
 	{
@@ -602,21 +681,10 @@ namespace zonetool::h1
 			if (globals.dump && globals.target_game == game::game_mode::iw7 && 
 				std::string(asset->name).find("*reflection_probe") != std::string::npos)
 			{
-				constexpr auto buffer_size = 1024 * 1024 * 32; // 32mb
-				static std::uint8_t pixel_buffer[buffer_size];
-				static std::uint32_t pixel_buffer_index = 0;
-
-				if (pixel_buffer_index + asset->dataLen1 >= buffer_size)
-				{
-					ZONETOOL_FATAL("reflection probe pixeldata buffer is full...");
-				}
-
-				memcpy(&pixel_buffer[pixel_buffer_index], asset->pixelData, asset->dataLen1);
+				const auto pixel_data = reflection_probe_pixels.store(asset->pixelData, asset->dataLen1);
 
 				auto ret = db_link_x_asset_entry1_hook.invoke<XAssetEntry*>(type, header);
-				ret->asset.header.image->pixelData = &pixel_buffer[pixel_buffer_index];
-
-				pixel_buffer_index += asset->dataLen1;
+				ret->asset.header.image->pixelData = pixel_data;
 
 				//dump_asset(&xasset); // gfxworld generates reflection_probe array, no need to dump
 
@@ -671,7 +739,9 @@ namespace zonetool::h1
 
 		wait_for_database();
 
-		if (!globals.dump && !globals.verify)
+		// dumping, verifying and building a manifest need the assets of the zone to pass through
+		// db_add_xasset again, so zones that are already loaded are loaded once more
+		if (!globals.dump && !globals.verify && !building_manifest)
 		{
 			for (auto i = 0u; i < *g_zoneCount; i++)
 			{
@@ -742,6 +812,36 @@ namespace zonetool::h1
 		}
 	}
 
+	bool build_manifest(const std::string& name)
+	{
+		if (!zone_exists(name.data()))
+		{
+			ZONETOOL_INFO("Zone \"%s\" could not be found!", name.data());
+			return false;
+		}
+
+		wait_for_database();
+
+		ZONETOOL_INFO("Building manifest for zone \"%s\"...", name.data());
+
+		manifest_builder = {};
+		manifest_zone = name;
+
+		building_manifest = true;
+		if (!load_zone(name, DB_LOAD_ASYNC, false))
+		{
+			building_manifest = false;
+			return false;
+		}
+
+		while (building_manifest)
+		{
+			Sleep(1);
+		}
+
+		return true;
+	}
+
 	void dump_csv(const std::string& name)
 	{
 		if (!zone_exists(name.data()))
@@ -832,134 +932,82 @@ namespace zonetool::h1
 
 	void parse_csv_file_ignore(const std::string& fastfile, const std::string& csv)
 	{
-		auto path = "zone_source\\" + csv + ".csv";
-		auto parser = csv::parser(path.data(), ',');
-
-		if (!parser.valid())
+		const auto source = zone_source::get(csv);
+		if (!source)
 		{
-			throw std::runtime_error(utils::string::va("Could not find csv file \"%s\"", csv.data()));
-		}
-
-		auto rows = parser.get_rows();
-		if (rows == nullptr)
-		{
-			return;
-		}
-
-		for (auto row_index = 0; row_index < parser.get_num_rows(); row_index++)
-		{
-			auto* row = rows[row_index];
-			if (row == nullptr)
+			// zones without a csv can still be ignored through their manifest
+			if (ignore_assets.add_manifest(csv))
 			{
-				continue;
-			}
-
-			if (!row->fields)
-			{
-				continue;
+				return;
 			}
 
-			if ((strlen(row->fields[0]) >= 1 && row->fields[0][0] == '#') || (strlen(row->fields[0]) >= 2 && row->
-				fields[0][0] == '/' && row->fields[0][1] == '/'))
-			{
-				// comment line, go to next line.
-				continue;
-			}
-			if (!strlen(row->fields[0]))
-			{
-				// empty line, go to next line.
-				continue;
-			}
+			throw std::runtime_error(utils::string::va("Could not find csv file \"%s\"", csv.data()));
+		}
 
-			if (row->num_fields < 2 || !is_valid_asset_type(row->fields[0]))
+		for (const auto& instruction : source->instructions)
+		{
+			if (instruction.num_fields() < 2 || !is_valid_asset_type(instruction.field(0)))
 			{
 				continue;
 			}
 
 			std::string name;
-			if ((!row->fields[1] || !strlen(row->fields[1]) && row->fields[2] && strlen(row->fields[2])))
+			if (instruction.field(1).empty() && !instruction.field(2).empty())
 			{
 				continue;
 			}
 			else
 			{
-				name = row->fields[1];
+				name = instruction.field(1);
 			}
 
-			const auto type = static_cast<std::uint32_t>(type_to_int(row->fields[0]));
-			ignore_assets.insert(std::make_pair(type, name));
+			const auto type = static_cast<std::uint32_t>(type_to_int(instruction.field(0)));
+			ignore_assets.insert(type, name);
 		}
 	}
 
 	void parse_csv_file(zone_base* zone, const std::string& fastfile, const std::string& csv)
 	{
-		auto path = "zone_source\\" + csv + ".csv";
-		auto parser = csv::parser(path.data(), ',');
-
-		if (!parser.valid())
+		const auto source = zone_source::get(csv);
+		if (!source)
 		{
 			throw std::runtime_error(utils::string::va("Could not find csv file \"%s\" to build zone!", csv.data()));
 		}
 
+		const zone_source::include_scope include_scope(csv);
+
 		auto is_referencing = false;
-		auto rows = parser.get_rows();
-		if (rows == nullptr)
-		{
-			return;
-		}
 
-		for (auto row_index = 0; row_index < parser.get_num_rows(); row_index++)
+		for (const auto& instruction : source->instructions)
 		{
-			auto* row = rows[row_index];
-			if (row == nullptr)
+			if (instruction.type == zone_source::instruction_type::require)
 			{
-				continue;
-			}
-
-			if (!row->fields)
-			{
-				continue;
-			}
-
-			if ((strlen(row->fields[0]) >= 1 && row->fields[0][0] == '#') || (strlen(row->fields[0]) >= 2 && row->
-				fields[0][0] == '/' && row->fields[0][1] == '/'))
-			{
-				// comment line, go to next line.
-				continue;
-			}
-			if (!strlen(row->fields[0]))
-			{
-				// empty line, go to next line.
-				continue;
-			}
-			if (row->fields[0] == "require"s)
-			{
-				load_zone(row->fields[1], DB_LOAD_ASYNC);
+				load_zone(instruction.field(1), DB_LOAD_ASYNC);
 				wait_for_database();
 			}
-			else if (row->fields[0] == "include"s)
+			else if (instruction.type == zone_source::instruction_type::include)
 			{
-				parse_csv_file(zone, fastfile, row->fields[1]);
+				parse_csv_file(zone, fastfile, instruction.field(1));
 			}
-			else if (row->fields[0] == "ignore"s)
+			else if (instruction.type == zone_source::instruction_type::ignore)
 			{
-				parse_csv_file_ignore(fastfile, row->fields[1]);
+				parse_csv_file_ignore(fastfile, instruction.field(1));
 			}
 			// this allows us to reference assets instead of rewriting them
-			else if (row->fields[0] == "reference"s)
+			else if (instruction.type == zone_source::instruction_type::reference)
 			{
-				if (row->num_fields >= 2)
+				if (instruction.num_fields() >= 2)
 				{
-					is_referencing = row->fields[1] == "true"s;
+					is_referencing = instruction.field(1) == "true"s;
 				}
 			}
 			// this will use a directory iterator to automatically add assets
-			else if (row->fields[0] == "iterate"s)
+			else if (instruction.type == zone_source::instruction_type::iterate)
 			{
-				if (row->num_fields >= 2)
+				if (instruction.num_fields() >= 2)
 				{
-					auto type = row->fields[1];
-					auto iterate_all = row->fields[1] == "true"s;
+					auto type = instruction.field(1);
+					auto iterate_all = instruction.field(1) == "true"s;
 
 					try
 					{
@@ -987,52 +1035,53 @@ namespace zonetool::h1
 				}
 			}
 			// add paths
-			else if ((row->fields[0] == "addpath"s || row->fields[0] == "addpaths"s) && row->num_fields >= 2)
+			else if ((instruction.type == zone_source::instruction_type::addpath || instruction.type == zone_source::instruction_type::addpaths) &&
+				instruction.num_fields() >= 2)
 			{
-				bool insert_at_beginning = row->num_fields >= 3 && row->fields[2] == "true"s;
+				bool insert_at_beginning = instruction.num_fields() >= 3 && instruction.field(2) == "true"s;
 
-				if (row->fields[0] == "addpath"s)
-					filesystem::add_path(row->fields[1], insert_at_beginning);
+				if (instruction.type == zone_source::instruction_type::addpath)
+					filesystem::add_path(instruction.field(1), insert_at_beginning);
 				else
-					filesystem::add_paths_from_directory(row->fields[1], insert_at_beginning);
+					filesystem::add_paths_from_directory(instruction.field(1), insert_at_beginning);
 			}
 			// if entry is not an option, it should be an asset.
 			else
 			{
-				if (row->fields[0] == "localize"s && row->num_fields >= 2 &&
-					filesystem::file("localizedstrings/"s + row->fields[1] + ".str").exists())
+				if (instruction.field(0) == "localize"s && instruction.num_fields() >= 2 &&
+					filesystem::file("localizedstrings/"s + instruction.field(1) + ".str").exists())
 				{
-					localize::parse_localizedstrings_file(zone, row->fields[1]);
+					localize::parse_localizedstrings_file(zone, instruction.field(1));
 				}
-				else if (row->fields[0] == "localize"s && row->num_fields >= 2 &&
-					filesystem::file("localizedstrings/"s + row->fields[1] + ".json").exists())
+				else if (instruction.field(0) == "localize"s && instruction.num_fields() >= 2 &&
+					filesystem::file("localizedstrings/"s + instruction.field(1) + ".json").exists())
 				{
-					localize::parse_localizedstrings_json(zone, row->fields[1]);
+					localize::parse_localizedstrings_json(zone, instruction.field(1));
 				}
 				else
 				{
-					if (!is_valid_asset_type(row->fields[0]))
+					if (!is_valid_asset_type(instruction.field(0)))
 					{
 						continue;
 					}
 
 					std::string name;
-					if (row->num_fields > 1)
+					if (instruction.num_fields() > 1)
 					{
-						if (row->num_fields > 2 && (!row->fields[1] || !strlen(row->fields[1]) && row->fields[2] && strlen(row->fields[2])))
+						if (instruction.num_fields() > 2 && (instruction.field(1).empty() && !instruction.field(2).empty()))
 						{
-							name = ","s + row->fields[2];
+							name = ","s + instruction.field(2);
 						}
 						else
 						{
-							name = ((is_referencing) ? ","s : ""s) + row->fields[1];
+							name = ((is_referencing) ? ","s : ""s) + instruction.field(1);
 						}
 					}
 
 					try
 					{
 						zone->add_asset_of_type(
-							row->fields[0],
+							instruction.field(0),
 							name
 						);
 					}
@@ -1045,6 +1094,188 @@ namespace zonetool::h1
 		}
 	}
 
+	namespace
+	{
+		struct sound_entry
+		{
+			// sound alias lists are expanded into the loaded sounds listed in their json
+			bool is_alias;
+			audio_ingest::request request;
+		};
+
+		// walks the csv like parse_csv_file does, each sound keeps the search paths it will be added with
+		void collect_sounds(const std::string& csv, std::vector<std::string>& search_paths, std::vector<sound_entry>& entries)
+		{
+			const auto source = zone_source::get(csv);
+			if (!source)
+			{
+				return;
+			}
+
+			const zone_source::include_scope include_scope(csv);
+
+			audio_ingest::search_paths paths;
+			auto is_referencing = false;
+
+			for (const auto& instruction : source->instructions)
+			{
+				if (instruction.type == zone_source::instruction_type::include)
+				{
+					collect_sounds(instruction.field(1), search_paths, entries);
+					paths.reset();
+				}
+				else if (instruction.type == zone_source::instruction_type::reference)
+				{
+					if (instruction.num_fields() >= 2)
+					{
+						is_referencing = instruction.field(1) == "true"s;
+					}
+				}
+				else if ((instruction.type == zone_source::instruction_type::addpath || instruction.type == zone_source::instruction_type::addpaths) &&
+					instruction.num_fields() >= 2)
+				{
+					const auto insert_at_beginning = instruction.num_fields() >= 3 && instruction.field(2) == "true"s;
+
+					std::vector<std::string> new_paths;
+					if (instruction.type == zone_source::instruction_type::addpaths)
+					{
+						new_paths = filesystem::load_extra_search_paths(instruction.field(1));
+					}
+					else if (!instruction.field(1).empty())
+					{
+						new_paths.emplace_back(instruction.field(1) + "\\");
+					}
+
+					search_paths.insert(insert_at_beginning ? search_paths.begin() : search_paths.end(), new_paths.begin(), new_paths.end());
+					paths.reset();
+				}
+				else if (instruction.type == zone_source::instruction_type::asset && instruction.num_fields() >= 2)
+				{
+					// referenced assets are never parsed
+					if (is_referencing || instruction.field(1).empty())
+					{
+						continue;
+					}
+
+					const auto type = type_to_int(instruction.field(0));
+					if (type != ASSET_TYPE_SOUND && type != ASSET_TYPE_LOADED_SOUND)
+					{
+						continue;
+					}
+
+					if (!paths)
+					{
+						paths = std::make_shared<const std::vector<std::string>>(search_paths);
+					}
+
+					entries.emplace_back(sound_entry{type == ASSET_TYPE_SOUND, {instruction.field(1), paths}});
+				}
+			}
+		}
+
+		std::vector<std::string> get_alias_loaded_sounds(const std::string& name, const std::vector<std::string>& search_paths)
+		{
+			const auto path = audio_ingest::find_path("sounds\\"s + name + ".json"s, search_paths);
+			if (!path.has_value())
+			{
+				return {};
+			}
+
+			std::vector<std::string> names;
+
+			try
+			{
+				const auto data = json::parse(utils::io::read_file(path.value()));
+				for (const auto& head : data.at("head"))
+				{
+					const auto& soundfile = head.at("soundfile");
+					if (soundfile.at("type").get<snd_alias_type_t>() == SAT_LOADED)
+					{
+						names.emplace_back(soundfile.at("name").get<std::string>());
+					}
+				}
+			}
+			catch (const std::exception&)
+			{
+				// sound::parse reports broken files when the zone gets built
+			}
+
+			return names;
+		}
+
+		// reads and converts the zone's loaded sounds on worker threads while the csv is processed
+		void queue_loaded_sounds(const std::string& fastfile)
+		{
+			if (utils::flags::has_flag("no_audio_ingest"))
+			{
+				return;
+			}
+
+			std::vector<sound_entry> entries;
+
+			try
+			{
+				auto search_paths = filesystem::get_search_paths();
+				collect_sounds(fastfile, search_paths, entries);
+			}
+			catch (const std::exception&)
+			{
+				// parse_csv_file reports broken csvs
+				return;
+			}
+
+			std::vector<std::vector<std::string>> alias_sounds(entries.size());
+			std::atomic_size_t next_entry{};
+
+			const auto parse_aliases = [&]
+			{
+				for (auto i = next_entry++; i < entries.size(); i = next_entry++)
+				{
+					if (entries[i].is_alias)
+					{
+						alias_sounds[i] = get_alias_loaded_sounds(entries[i].request.name, *entries[i].request.paths);
+					}
+				}
+			};
+
+			const auto num_threads = std::min(entries.size(), static_cast<std::size_t>(std::max(1u, std::thread::hardware_concurrency())));
+
+			std::vector<std::thread> threads;
+			for (auto i = 1u; i < num_threads; i++)
+			{
+				threads.emplace_back(parse_aliases);
+			}
+
+			parse_aliases();
+
+			for (auto& thread : threads)
+			{
+				thread.join();
+			}
+
+			std::vector<audio_ingest::request> requests;
+			for (auto i = 0u; i < entries.size(); i++)
+			{
+				if (!entries[i].is_alias)
+				{
+					requests.emplace_back(entries[i].request);
+					continue;
+				}
+
+				for (const auto& name : alias_sounds[i])
+				{
+					requests.emplace_back(audio_ingest::request{name, entries[i].request.paths});
+				}
+			}
+
+			if (!requests.empty())
+			{
+				ZONETOOL_INFO("Reading %llu loaded sounds in the background...", requests.size());
+				audio_ingest::start(requests);
+			}
+		}
+	}
+
 	std::shared_ptr<zone_base> alloc_zone(const std::string& zone)
 	{
 		auto ptr = std::make_shared<zone_interface>(zone);
@@ -1144,6 +1375,12 @@ namespace zonetool::h1
 			return;
 		}
 
+		queue_loaded_sounds(fastfile);
+		const auto _0 = gsl::finally([]
+		{
+			audio_ingest::clear();
+		});
+
 		try
 		{
 			parse_csv_file(zone.get(), fastfile, fastfile);
@@ -1237,6 +1474,18 @@ namespace zonetool::h1
 			verify_zone(params.get(1));
 		});
 
+		::h1::command::add("benchmarkmenus", [](const ::h1::command::params& params)
+		{
+			if (params.size() < 2 || params.size() > 3)
+			{
+				ZONETOOL_ERROR("usage: benchmarkmenus <folder> [iterations]");
+				return;
+			}
+
+			const auto iterations = params.size() == 3 ? std::max(1, std::atoi(params.get(2))) : 1;
+			menu_list::benchmark(params.get(1), iterations);
+		});
+
 		::h1::command::add("dumpcsv", [](const ::h1::command::params& params)
 		{
 			if (params.size() != 2)
@@ -1248,6 +1497,17 @@ namespace zonetool::h1
 			dump_csv(params.get(1));
 		});
 
+		::h1::command::add("buildmanifest", [](const ::h1::command::params& params)
+		{
+			if (params.size() != 2)
+			{
+				ZONETOOL_ERROR("usage: buildmanifest <zone>");
+				return;
+			}
+
+			build_manifest(params.get(1));
+		});
+
 		::h1::command::add("dumpzone", [](const ::h1::command::params& params)
 		{
 			if (params.size() < 2)
@@ -1394,6 +1654,7 @@ namespace zonetool::h1
 			asset.header = header;
 			globals.target_game = game::h1;
 			dump_asset(&asset);
+			sound_pak::flush();
 
 			ZONETOOL_INFO("Dumped to dump/assets");
 		});
@@ -1464,11 +1725,17 @@ namespace zonetool::h1
 				{"techsets_common_core_mp", techset_filter},
 			};
 
+			common_assets.clear();
+
 			for (const auto& zone : common_zones)
 			{
 				if (skip_common)
 				{
-					load_zone(zone.first);
+					// common zones are only loaded once to produce their manifest, and again when the zone file changed
+					if (!common_assets.add_manifest(zone.first) && build_manifest(zone.first))
+					{
+						common_assets.add_manifest(zone.first);
+					}
 				}
 				else
 				{
@@ -1483,6 +1750,8 @@ namespace zonetool::h1
 			dump_zone_(dump_params.zone + "_load", dump_params.filter);
 			dump_zone_(dump_params.zone);
 
+			common_assets.clear();
+
 			ZONETOOL_INFO("Map \"%s\" dumped", dump_params.zone.data());
 		});
 
@@ -1493,6 +1762,12 @@ namespace zonetool::h1
 			return gsc::h1::gsc_ctx->token_name(id);
 		}));
 
+		::h1::command::add("generatepackcsv", csv_generator::create_pack_command
+			<::h1::command::params>([](const uint32_t id)
+		{
+			return gsc::h1::gsc_ctx->token_name(id);
+		}));
+
 		::h1::command::add("iteratezones", []()
 		{
 			iterate_zones();
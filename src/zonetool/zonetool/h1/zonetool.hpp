@@ -10,6 +10,8 @@
 #include "functions.hpp"
 #include "variables.hpp"
 
+#include "../utils/asset_manifest.hpp"
+
 #include "zonetool/utils/utils.hpp"
 #include "zonetool/shared/shared.hpp"
 
@@ -85,7 +87,7 @@
 
 namespace zonetool::h1
 {
-	extern std::unordered_set<std::pair<std::uint32_t, std::string>, pair_hash<std::uint32_t, std::string>> ignore_assets;
+	extern asset_manifest::asset_set ignore_assets;
 
 	XAssetHeader db_find_x_asset_header(XAssetType type, const char* name, int create_default);
 	XAssetHeader db_find_x_asset_header_safe(XAssetType type, const std::string& name);
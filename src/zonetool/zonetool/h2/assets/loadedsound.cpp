@@ -1,206 +1,10 @@
 #include <std_include.hpp>
 #include "loadedsound.hpp"
 
-#include <utils/bit_buffer.hpp>
-
 #define SIZEOF_SNDFILE_WAVE_HEADER 46
 
-#define APPLICATION_ID "fsiz"
-#define CONSTANT_BLOCKSIZE 0x400
-
 namespace zonetool::h2
 {
-	namespace
-	{
-		enum block_type_t
-		{
-			streaminfo,
-			padding,
-			application,
-			seektable,
-			vorbis_comment,
-			cuesheet,
-			picture,
-			count
-		};
-
-		struct metadata_block_header_t
-		{
-			bool is_last;
-			block_type_t type;
-			int length;
-		};
-
-		struct metadata_block_t
-		{
-			metadata_block_header_t header;
-			char* data;
-			char* start;
-		};
-
-		metadata_block_t parse_metadata_block(char* buffer)
-		{
-			/*
-				// https://xiph.org/flac/format.html#metadata_block_header
-
-				bits | description
-				   1   is last block
-				   7   block type
-				  24   block length (header not included)
-			*/
-
-			const auto header = _byteswap_ulong(*reinterpret_cast<uint32_t*>(
-				reinterpret_cast<uint64_t>(buffer)));
-
-			const auto is_last = static_cast<bool>(header >> (8 * 3 + 7));
-			const auto block_type = static_cast<block_type_t>((header << 1) >> (8 * 3 + 1));
-			const auto block_length = (header << 8) >> 8;
-
-			metadata_block_t block{};
-			block.header.is_last = is_last;
-			block.header.type = block_type;
-			block.header.length = block_length;
-			block.data = buffer + 4;
-			block.start = buffer;
-
-			return block;
-		}
-
-		void parse_metadata_block(char* buffer, metadata_block_t* block)
-		{
-			*block = parse_metadata_block(buffer);
-		}
-
-		bool check_signature(const std::string& buffer)
-		{
-			static std::vector<uint8_t> signature = {'f', 'L', 'a', 'C'};
-
-			if (buffer.size() < signature.size())
-			{
-				return false;
-			}
-
-			for (auto i = 0; i < signature.size(); i++)
-			{
-				if (buffer[i] != signature[i])
-				{
-					return false;
-				}
-			}
-
-			return true;
-		}
-
-		bool check_signature(const char* buffer)
-		{
-			return check_signature(std::string(buffer, 4));
-		}
-
-		void verify_streaminfo_block(const metadata_block_t& block)
-		{
-			const auto minimum = _byteswap_ushort(*reinterpret_cast<uint16_t*>(block.data));
-			const auto maximum = _byteswap_ushort(*reinterpret_cast<uint16_t*>(block.data + 2));
-
-			if (maximum != CONSTANT_BLOCKSIZE || minimum != CONSTANT_BLOCKSIZE)
-			{
-				ZONETOOL_WARNING(
-					"Stream must have a constant blocksize of 1024! (was min: %i, max: %i)",
-					minimum, maximum);
-			}
-		}
-
-		std::string convert_flac(std::string& data, LoadedSoundInfo* info)
-		{
-			const auto start_pos = data.data();
-			const auto end_pos = start_pos + data.size();
-
-			if (!check_signature(start_pos))
-			{
-				ZONETOOL_FATAL("File is not a flac file");
-			}
-
-			auto pos = start_pos;
-			pos += 4; // skip "fLaC"
-
-			metadata_block_t block{};
-
-			auto num_blocks = 0;
-			auto has_seektable = false;
-			auto has_application = false;
-
-			while (!block.header.is_last && pos < end_pos)
-			{
-				parse_metadata_block(pos, &block);
-				num_blocks++;
-
-				if (!block.header.is_last)
-				{
-					pos = block.data + block.header.length;
-				}
-
-				if (block.header.type == block_type_t::application)
-				{
-					const auto application_id = std::string{block.data, 4};
-					if (application_id == APPLICATION_ID)
-					{
-						has_application = true;
-					}
-				}
-
-				if (block.header.type == block_type_t::streaminfo)
-				{
-					verify_streaminfo_block(block);
-
-					utils::bit_buffer buffer({block.data, static_cast<size_t>(block.header.length)});
-
-					info->sampleRate = buffer.read_bits<unsigned int>(80, 20);
-					info->channels = buffer.read_bits<char>(100, 3) + 1;
-					info->numBits = buffer.read_bits<char>(103, 5) + 1; // bps
-					info->numSamples = buffer.read_bits<unsigned int>(108, 36);
-				}
-
-				if (block.header.type == block_type_t::seektable)
-				{
-					has_seektable = true;
-				}
-			}
-
-			const auto frame_section_size = (start_pos + data.size()) - (block.data + block.header.length);
-			auto insert_pos = static_cast<size_t>(pos - start_pos);
-			auto insert_header = _byteswap_ulong(0x02000008); // application block, length 8
-
-			if (num_blocks == 1)
-			{
-				const auto header_ptr = reinterpret_cast<uint32_t*>(block.start);
-				const auto header = _byteswap_ulong(*header_ptr);
-				*header_ptr = _byteswap_ulong((header << 1) >> 1);
-
-				insert_header = _byteswap_ulong(0x82000008);
-				insert_pos = static_cast<size_t>(block.data - start_pos + block.header.length);
-			}
-
-			std::string insert_data{};
-
-			if (!has_seektable)
-			{
-				const auto seektable_ = _byteswap_ulong(0x03000000);
-				insert_data.append(reinterpret_cast<const char*>(&seektable_), 4);
-			}
-
-			if (!has_application)
-			{
-				insert_data.append(reinterpret_cast<const char*>(&insert_header), 4); // header
-				insert_data.append(APPLICATION_ID); // data (application id)
-				insert_data.append(reinterpret_cast<const char*>(&frame_section_size), 4); // data (frame section size)
-			}
-
-			std::string new_data = data;
-			new_data.insert(insert_pos, insert_data);
-			return new_data;
-		}
-
-	}
-
 	LoadedSound* loaded_sound::parse_flac(const std::string& name, zone_memory* mem)
 	{
 		ZONETOOL_INFO("Parsing loaded_sound \"%s\"...", name.data());
@@ -212,22 +16,31 @@ namespace zonetool::h2
 		auto* result = mem->allocate<LoadedSound>();
 		result->name = mem->duplicate_string(name);
 
-		const auto size = static_cast<int>(file.size());
+		const auto size = file.size();
 		const auto data = mem->allocate<char>(size);
 		file.read(data, size, 1);
+		file.close();
+
+		// the patched header and the original frames are written to the zone one after another, see write
+		this->flac_stream_ = flac::patch_stream({data, size});
+		const auto& info = this->flac_stream_->info;
+
+		if (info.min_block_size != flac::constant_block_size || info.max_block_size != flac::constant_block_size)
+		{
+			ZONETOOL_WARNING("Stream must have a constant blocksize of 1024! (was min: %i, max: %i)",
+				info.min_block_size, info.max_block_size);
+		}
 
 		result->info.blockAlign = 0;
 		result->info.format = 6; // idk, seems to always be 6
+		result->info.sampleRate = info.sample_rate;
+		result->info.channels = static_cast<unsigned char>(info.channels);
+		result->info.numBits = static_cast<unsigned char>(info.bits_per_sample);
+		result->info.numSamples = info.num_samples;
 
-		std::string data_str{data, static_cast<size_t>(size)};
-		const auto converted = convert_flac(data_str, &result->info);
-
-		result->info.data = mem->allocate<char>(converted.size());
-		std::memcpy(result->info.data, converted.data(), converted.size());
-		result->info.loadedSize = static_cast<int>(converted.size());
+		result->info.loadedSize = static_cast<int>(this->flac_stream_->size());
 		result->info.dataByteCount = result->info.loadedSize;
 
-		file.close();
 		return result;
 	}
 
@@ -420,7 +233,14 @@ namespace zonetool::h2
 			}
 		}
 
-		if (data->info.data)
+		if (this->flac_stream_.has_value())
+		{
+			buf->align(0);
+			buf->write_stream(this->flac_stream_->header.data(), this->flac_stream_->header.size());
+			buf->write_stream(this->flac_stream_->frames.data(), this->flac_stream_->frames.size());
+			buf->clear_pointer(&dest->info.data);
+		}
+		else if (data->info.data)
 		{
 			buf->align(0);
 			buf->write(data->info.data, data->info.loadedSize);
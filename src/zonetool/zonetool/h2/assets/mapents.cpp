@@ -1,6 +1,8 @@
 #include <std_include.hpp>
 #include "mapents.hpp"
 
+#include "zonetool/utils/mapents.hpp"
+
 #include <xsk/gsc/engine/h2.hpp>
 
 namespace zonetool::h2
@@ -11,17 +13,18 @@ namespace zonetool::h2
 		{
 			std::string out_buffer{};
 
-			const auto lines = utils::string::split(source, '\n');
+			::mapents::line_reader reader(source);
+			std::string_view line;
 			auto in_map_ent = false;
 			auto empty = false;
 			auto in_comment = false;
 
-			for (auto i = 0; i < lines.size(); i++)
+			while (reader.next(line))
 			{
-				auto line = lines[i];
+				const auto i = reader.line_index();
 				if (line.ends_with('\r'))
 				{
-					line.pop_back();
+					line.remove_suffix(1);
 				}
 
 				if (line.starts_with("/*") || line.ends_with("/*"))
@@ -59,7 +62,7 @@ namespace zonetool::h2
 					{
 						out_buffer.append("\n}\n");
 					}
-					else if (i < static_cast<int>(lines.size()) - 1)
+					else if (!reader.at_end())
 					{
 						out_buffer.append("}\n");
 					}
@@ -84,20 +87,20 @@ namespace zonetool::h2
 					continue;
 				}
 
-				std::regex expr(R"~((.+) "(.*)")~");
-				std::smatch match{};
-				if (!std::regex_search(line, match, expr))
+				std::string_view key_view;
+				std::string_view value_view;
+				if (!::mapents::split_key_value(line, key_view, value_view))
 				{
-					ZONETOOL_WARNING("Failed to parse line %i (%s)", i, line.data());
+					ZONETOOL_WARNING("Failed to parse line %i (%s)", i, std::string{line}.data());
 					continue;
 				}
 
-				auto key = utils::string::to_lower(match[1].str());
-				const auto value = match[2].str();
+				auto key = utils::string::to_lower(std::string{key_view});
+				const std::string value{value_view};
 
 				if (key.size() <= 0)
 				{
-					ZONETOOL_WARNING("Invalid key ('%s') on line %i (%s)", key.data(), i, line.data());
+					ZONETOOL_WARNING("Invalid key ('%s') on line %i (%s)", key.data(), i, std::string{line}.data());
 					continue;
 				}
 
@@ -122,7 +125,7 @@ namespace zonetool::h2
 
 				if (id == 0)
 				{
-					ZONETOOL_WARNING("Key '%s' not found, on line %i (%s)", key_.data(), i, line.data());
+					ZONETOOL_WARNING("Key '%s' not found, on line %i (%s)", key_.data(), i, std::string{line}.data());
 					continue;
 				}
 
@@ -3,5 +3,5 @@
 
 namespace zonetool::h2
 {
-	REGISTER_TEMPLATED_ASSET(scriptfile, ScriptFile, ASSET_TYPE_SCRIPTFILE);
+	REGISTER_TEMPLATED_ASSET(scriptfile, ScriptFile, ASSET_TYPE_SCRIPTFILE, gsc_cache::game::h2);
 }
\ No newline at end of file
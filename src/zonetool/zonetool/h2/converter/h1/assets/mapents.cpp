@@ -6,6 +6,7 @@
 
 #include "zonetool/h2/functions.hpp"
 #include "zonetool/utils/gsc.hpp"
+#include "zonetool/utils/mapents.hpp"
 
 namespace zonetool::h2
 {
@@ -16,9 +17,10 @@ namespace zonetool::h2
 			std::string replace_mapents_keys(const std::string& data)
 			{
 				std::string buffer{};
-				const auto lines = utils::string::split(data, '\n');
+				::mapents::line_reader reader(data);
+				std::string_view line;
 
-				for (const auto& line : lines)
+				while (reader.next(line))
 				{
 					const auto _0 = gsl::finally([&]
 					{
@@ -37,7 +39,7 @@ namespace zonetool::h2
 						continue;
 					}
 
-					const auto id = static_cast<unsigned int>(std::atoi(line.substr(0, first_space).data()));
+					const auto id = static_cast<unsigned int>(std::atoi(std::string{line.substr(0, first_space)}.data()));
 					if (id == 0) // 0 "key" "value"
 					{
 						buffer.append(line);
@@ -47,7 +49,7 @@ namespace zonetool::h2
 					const auto token = gsc::h2::gsc_ctx->token_name(static_cast<std::uint16_t>(id));
 					const auto key = "\"" + token + "\"";
 
-					const auto new_line = key + line.substr(first_space);
+					const auto new_line = key + std::string{line.substr(first_space)};
 					buffer.append(new_line);
 				}
 
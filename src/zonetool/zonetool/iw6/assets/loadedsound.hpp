@@ -1,6 +1,8 @@
 #pragma once
 #include "../zonetool.hpp"
 
+#include "zonetool/utils/flac.hpp"
+
 namespace zonetool::iw6
 {
 	class loaded_sound : public asset_interface
@@ -8,6 +10,7 @@ namespace zonetool::iw6
 	private:
 		std::string name_;
 		LoadedSound* asset_ = nullptr;
+		std::optional<flac::patched_stream> flac_stream_;
 
 	public:
 		LoadedSound* parse_flac(const std::string& name, zone_memory* mem);
@@ -7,6 +7,7 @@
 #include "zonetool/iw6/functions.hpp"
 
 #include "zonetool/utils/gsc.hpp"
+#include "zonetool/utils/mapents.hpp"
 
 namespace zonetool::iw6
 {
@@ -18,17 +19,18 @@ namespace zonetool::iw6
 			{
 				std::string out_buffer{};
 
-				const auto lines = utils::string::split(source, '\n');
+				::mapents::line_reader reader(source);
+				std::string_view line;
 				auto in_map_ent = false;
 				auto empty = false;
 				auto in_comment = false;
 
-				for (auto i = 0; i < lines.size(); i++)
+				while (reader.next(line))
 				{
-					auto line = lines[i];
+					const auto i = reader.line_index();
 					if (line.ends_with('\r'))
 					{
-						line.pop_back();
+						line.remove_suffix(1);
 					}
 
 					if (line.starts_with("/*") || line.ends_with("/*"))
@@ -66,7 +68,7 @@ namespace zonetool::iw6
 						{
 							out_buffer.append("\n}\n");
 						}
-						else if (i < static_cast<int>(lines.size()) - 1)
+						else if (!reader.at_end())
 						{
 							out_buffer.append("}\n");
 						}
@@ -91,20 +93,20 @@ namespace zonetool::iw6
 						continue;
 					}
 
-					std::regex expr(R"~((.+) "(.*)")~");
-					std::smatch match{};
-					if (!std::regex_search(line, match, expr))
+					std::string_view key_view;
+					std::string_view value_view;
+					if (!::mapents::split_key_value(line, key_view, value_view))
 					{
-						ZONETOOL_WARNING("Failed to parse line %i (%s)", i, line.data());
+						ZONETOOL_WARNING("Failed to parse line %i (%s)", i, std::string{line}.data());
 						continue;
 					}
 
-					auto key = utils::string::to_lower(match[1].str());
-					const auto value = match[2].str();
+					auto key = utils::string::to_lower(std::string{key_view});
+					const std::string value{value_view};
 
 					if (key.size() <= 0)
 					{
-						ZONETOOL_WARNING("Invalid key ('%s') on line %i (%s)", key.data(), i, line.data());
+						ZONETOOL_WARNING("Invalid key ('%s') on line %i (%s)", key.data(), i, std::string{line}.data());
 						continue;
 					}
 
@@ -126,7 +128,7 @@ namespace zonetool::iw6
 					const auto id = gsc::iw6::gsc_ctx->token_id(key_);
 					if (id == 0)
 					{
-						ZONETOOL_WARNING("Key '%s' not found, on line %i (%s)", key_.data(), i, line.data());
+						ZONETOOL_WARNING("Key '%s' not found, on line %i (%s)", key_.data(), i, std::string{line}.data());
 						continue;
 					}
 
@@ -140,23 +142,22 @@ namespace zonetool::iw6
 			{
 				std::string out_buffer;
 
-				const auto lines = utils::string::split(source, '\n');
+				::mapents::line_reader reader(source);
+				std::string_view line;
 
-				for (auto i = 0; i < lines.size(); i++)
+				while (reader.next(line))
 				{
 					const auto _0 = gsl::finally([&]
 					{
 						out_buffer.append("\n");
 					});
 
-					const auto& line = lines[i];
-
-					std::regex expr(R"~((.+) "(.*)")~");
-					std::smatch match{};
-					if (!line.starts_with("0 ") && std::regex_search(line, match, expr))
+					std::string_view key_view;
+					std::string_view value_view;
+					if (!line.starts_with("0 ") && ::mapents::split_key_value(line, key_view, value_view))
 					{
-						const auto id = std::atoi(match[1].str().data());
-						const auto value = match[2].str();
+						const auto id = std::atoi(std::string{key_view}.data());
+						const std::string value{value_view};
 
 						std::string key = gsc::iw6::gsc_ctx->token_name(
 							static_cast<std::uint16_t>(id));
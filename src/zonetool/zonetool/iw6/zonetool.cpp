@@ -11,6 +11,7 @@
 
 #include "../utils/gsc.hpp"
 #include "../utils/csv_generator.hpp"
+#include "../utils/zone_source.hpp"
 
 namespace zonetool::iw6
 {
@@ -809,70 +810,43 @@ namespace zonetool::iw6
 
 	void parse_csv_file(zone_base* zone, const std::string& fastfile, const std::string& csv)
 	{
-		auto path = "zone_source\\" + csv + ".csv";
-		auto parser = csv::parser(path.data(), ',');
-
-		if (!parser.valid())
+		const auto source = zone_source::get(csv);
+		if (!source)
 		{
 			ZONETOOL_ERROR("Could not find csv file \"%s\" to build zone!", csv.data());
 			return;
 		}
 
+		const zone_source::include_scope include_scope(csv);
+
 		auto is_referencing = false;
-		auto rows = parser.get_rows();
-		if (rows == nullptr)
-		{
-			return;
-		}
 
-		for (auto row_index = 0; row_index < parser.get_num_rows(); row_index++)
+		for (const auto& instruction : source->instructions)
 		{
-			auto* row = rows[row_index];
-			if (row == nullptr)
-			{
-				continue;
-			}
-
-			if (!row->fields)
-			{
-				continue;
-			}
-
-			if ((strlen(row->fields[0]) >= 1 && row->fields[0][0] == '#') || (strlen(row->fields[0]) >= 2 && row->
-				fields[0][0] == '/' && row->fields[0][1] == '/'))
-			{
-				// comment line, go to next line.
-				continue;
-			}
-			if (!strlen(row->fields[0]))
-			{
-				// empty line, go to next line.
-				continue;
-			}
-			if (row->fields[0] == "require"s)
+			if (instruction.type == zone_source::instruction_type::require)
 			{
-				load_zone(row->fields[1], DB_LOAD_ASYNC);
+				load_zone(instruction.field(1), DB_LOAD_ASYNC);
 				wait_for_database();
 			}
-			else if (row->fields[0] == "include"s)
+			else if (instruction.type == zone_source::instruction_type::include)
 			{
-				parse_csv_file(zone, fastfile, row->fields[1]);
+				parse_csv_file(zone, fastfile, instruction.field(1));
 			}
 			// this allows us to reference assets instead of rewriting them
-			else if (row->fields[0] == "reference"s)
+			else if (instruction.type == zone_source::instruction_type::reference)
 			{
-				if (row->num_fields >= 2)
+				if (instruction.num_fields() >= 2)
 				{
-					is_referencing = row->fields[1] == "true"s;
+					is_referencing = instruction.field(1) == "true"s;
 				}
 			}
 			// this will use a directory iterator to automatically add assets
-			else if (row->fields[0] == "iterate"s)
+			else if (instruction.type == zone_source::instruction_type::iterate)
 			{
-				if (row->num_fields >= 2)
+				if (instruction.num_fields() >= 2)
 				{
-					auto type = row->fields[1];
-					auto iterate_all = row->fields[1] == "true"s;
+					auto type = instruction.field(1);
+					auto iterate_all = instruction.field(1) == "true"s;
 
 					try
 					{
@@ -900,49 +874,50 @@ namespace zonetool::iw6
 				}
 			}
 			// add paths
-			else if ((row->fields[0] == "addpath"s || row->fields[0] == "addpaths"s) && row->num_fields >= 2)
+			else if ((instruction.type == zone_source::instruction_type::addpath || instruction.type == zone_source::instruction_type::addpaths) &&
+				instruction.num_fields() >= 2)
 			{
-				bool insert_at_beginning = row->num_fields >= 3 && row->fields[2] == "true"s;
+				bool insert_at_beginning = instruction.num_fields() >= 3 && instruction.field(2) == "true"s;
 
-				if (row->fields[0] == "addpath"s)
-					filesystem::add_path(row->fields[1], insert_at_beginning);
+				if (instruction.type == zone_source::instruction_type::addpath)
+					filesystem::add_path(instruction.field(1), insert_at_beginning);
 				else
-					filesystem::add_paths_from_directory(row->fields[1], insert_at_beginning);
+					filesystem::add_paths_from_directory(instruction.field(1), insert_at_beginning);
 			}
 			// if entry is not an option, it should be an asset.
 			else
 			{
-				if (row->fields[0] == "localize"s && row->num_fields >= 2 &&
-					filesystem::file("localizedstrings/"s + row->fields[1] + ".str").exists())
+				if (instruction.field(0) == "localize"s && instruction.num_fields() >= 2 &&
+					filesystem::file("localizedstrings/"s + instruction.field(1) + ".str").exists())
 				{
-					localize::parse_localizedstrings_file(zone, row->fields[1]);
+					localize::parse_localizedstrings_file(zone, instruction.field(1));
 				}
-				else if (row->fields[0] == "localize"s && row->num_fields >= 2 &&
-					filesystem::file("localizedstrings/"s + row->fields[1] + ".json").exists())
+				else if (instruction.field(0) == "localize"s && instruction.num_fields() >= 2 &&
+					filesystem::file("localizedstrings/"s + instruction.field(1) + ".json").exists())
 				{
-					localize::parse_localizedstrings_json(zone, row->fields[1]);
+					localize::parse_localizedstrings_json(zone, instruction.field(1));
 				}
 				else
 				{
-					if (row->num_fields < 2 || !is_valid_asset_type(row->fields[0]))
+					if (instruction.num_fields() < 2 || !is_valid_asset_type(instruction.field(0)))
 					{
 						continue;
 					}
 
 					std::string name;
-					if ((!row->fields[1] || !strlen(row->fields[1]) && row->fields[2] && strlen(row->fields[2])))
+					if (instruction.field(1).empty() && !instruction.field(2).empty())
 					{
-						name = ","s + row->fields[2];
+						name = ","s + instruction.field(2);
 					}
 					else
 					{
-						name = ((is_referencing) ? ","s : ""s) + row->fields[1];
+						name = ((is_referencing) ? ","s : ""s) + instruction.field(1);
 					}
 
 					try
 					{
 						zone->add_asset_of_type(
-							row->fields[0],
+							instruction.field(0),
 							name
 						);
 					}
@@ -1103,6 +1078,12 @@ namespace zonetool::iw6
 		{
 			return gsc::iw6::gsc_ctx->token_name(id);
 		}));
+
+		::iw6::command::add("generatepackcsv", csv_generator::create_pack_command
+			<::iw6::command::params>([](const uint32_t id)
+		{
+			return gsc::iw6::gsc_ctx->token_name(id);
+		}));
 	}
 
 	std::vector<std::string> get_command_line_arguments()
@@ -242,9 +242,8 @@ namespace zonetool::iw7
 
 		if (data->havokWorldShapeData)
 		{
-			buf->align(15);
-			buf->write(data->havokWorldShapeData, data->havokWorldShapeDataSize);
-			buf->clear_pointer(&dest->havokWorldShapeData);
+			// blobs shared between assets are only written once
+			dest->havokWorldShapeData = buf->write_s(15, data->havokWorldShapeData, data->havokWorldShapeDataSize);
 		}
 
 		if (data->collisionHeatmap)
@@ -1,6 +1,8 @@
 #include <std_include.hpp>
 #include "ddl.hpp"
 
+#include "zonetool/utils/ddl_source.hpp"
+
 //#define DUMP_DDL_JSON
 
 namespace zonetool::iw7
@@ -529,30 +531,6 @@ namespace zonetool::iw7
 		{"uint16", DDL_UINT16_TYPE_FIXUP},
 	};
 
-	static inline std::string trim(std::string s)
-	{
-		auto not_space = [](unsigned char c) { return !std::isspace(c); };
-		s.erase(s.begin(), std::find_if(s.begin(), s.end(), not_space));
-		s.erase(std::find_if(s.rbegin(), s.rend(), not_space).base(), s.end());
-		return s;
-	}
-
-	static inline std::vector<std::string> split_csv_commas(const std::string& s)
-	{
-		std::vector<std::string> out;
-		size_t start = 0;
-		while (start <= s.size())
-		{
-			size_t comma = s.find(',', start);
-			std::string tok = (comma == std::string::npos) ? s.substr(start) : s.substr(start, comma - start);
-			tok = trim(tok);
-			if (!tok.empty()) out.push_back(tok);
-			if (comma == std::string::npos) break;
-			start = comma + 1;
-		}
-		return out;
-	}
-
 	static inline int ceil_div_int(int a, int b)
 	{
 		return (a + b - 1) / b;
@@ -567,448 +545,343 @@ namespace zonetool::iw7
 		return n;
 	}
 
-	DDLFile parseDDLFile(const std::string& input, const std::string& name, zone_memory* mem)
+	// expects a version that passed ddl_source::validate, every type and array enum resolves
+	DDLDef buildDDLDef(const ddl_source::version_def& version, const std::string& fileName, char* name, zone_memory* mem)
 	{
-		DDLFile out{};
-		out.name = mem->duplicate_string(name);
-		std::vector<DDLDef> defs;
-
-		// Split input into lines
-		std::istringstream iss(input);
-		std::vector<std::string> lines;
-		std::string line;
-		while (std::getline(iss, line)) lines.push_back(line);
-
-		// Line index
-		size_t i = 0;
-		size_t lastVersionLineIndex = 0;
-		while (i < lines.size())
+		// Base def flags (per version)
+		struct DefBase { std::uint8_t flags = 0; int userFlagsSize = 0; int reserveSize = 0; unsigned int checksum; } defBase{};
+
+		for (const auto& decoration : version.decorations)
 		{
-			const std::string& l = lines[i];
-			if (i + 1 < lines.size() && l.find("version") != std::string::npos && lines[i + 1].find("{") != std::string::npos)
+			const auto value = decoration.value.value_or(0);
+
+			if (decoration.name == "userflags")
 			{
-				// Parse version number
-				unsigned short versionNumber = static_cast<unsigned short>(std::stoi(l.substr(l.find("version") + 7)));
+				defBase.flags |= DDLFlags::DDL_FLAG_USER_FLAGS;
+				defBase.userFlagsSize = static_cast<int>(value);
+			}
+			else if (decoration.name == "reserve")
+			{
+				defBase.flags |= DDLFlags::DDL_FLAG_RESERVE;
+				defBase.reserveSize = static_cast<int>(value);
+			}
+			else if (decoration.name == "codeversion") defBase.flags |= DDLFlags::DDL_FLAG_CODE_VERSION;
+			else if (decoration.name == "nopadding")   defBase.flags |= DDLFlags::DDL_FLAG_NO_PADDING;
+			else if (decoration.name == "checksum")    defBase.flags |= DDLFlags::DDL_FLAG_CHECKSUM;
+			else if (decoration.name == "ddlchecksum") defBase.flags |= DDLFlags::DDL_FLAG_DDL_CHECKSUM;
+			else if (decoration.name == "defchecksum") defBase.checksum = static_cast<unsigned int>(value);
+		}
 
-				// --- Extract header for this version ---
-				std::string headerPart;
-				for (size_t h = lastVersionLineIndex; h < i + 1; ++h)
-				{
-					if (lines[h].find("version") != std::string::npos && lines[h + 1].find("{") != std::string::npos)
-						break; // stop at previous version block
-					headerPart += lines[h] + "\n";
-				}
+		// Header bit size (per version)
+		int headerBits = 16;
+		if (defBase.flags & DDLFlags::DDL_FLAG_CHECKSUM)     headerBits += 32;
+		if (defBase.flags & DDLFlags::DDL_FLAG_DDL_CHECKSUM) headerBits += 32;
+		if (defBase.flags & DDLFlags::DDL_FLAG_CODE_VERSION) headerBits += 16;
+		if (defBase.flags & DDLFlags::DDL_FLAG_USER_FLAGS)   headerBits += defBase.userFlagsSize * 8;
+		if (defBase.flags & DDLFlags::DDL_FLAG_RESERVE)      headerBits += defBase.reserveSize * 8;
+
+		// --- Build DDLDef with per-version header ---
+		DDLDef def{};
+		def.name = name;
+		def.version = version.version;
+		def.flags = defBase.flags;
+		def.headerBitSize = headerBits;
+		def.headerByteSize = ceil_div_int(headerBits, 8);
+		def.reserveSize = defBase.reserveSize;
+		def.userFlagsSize = defBase.userFlagsSize;
+		def.paddingUsed = !(def.flags & DDLFlags::DDL_FLAG_NO_PADDING);
+
+		// use base checksum if present, otherwise we should compute it ourselves from the version block?
+		def.checksum = defBase.checksum;
+
+		// --- Enums ---
+		std::vector<DDLEnum> enums;
+		std::unordered_map<std::string, int> enumNameToIndex;
+		for (const auto& source : version.enums)
+		{
+			DDLEnum e{};
+			e.name = mem->duplicate_string(source.name);
+			e.memberCount = static_cast<int>(source.members.size());
+			e.members = mem->allocate<const char*>(e.memberCount);
+			for (int mi = 0; mi < e.memberCount; ++mi)
+				e.members[mi] = mem->duplicate_string(source.members[mi]);
+
+			// duplicates stay in the list, lookups resolve to the first definition
+			enumNameToIndex.try_emplace(source.name, static_cast<int>(enums.size()));
+			enums.push_back(std::move(e));
+		}
 
-				// Base def flags (per version)
-				struct DefBase { std::uint8_t flags = 0; int userFlagsSize = 0; int reserveSize = 0; unsigned int checksum; } defBase{};
+		// Struct index mapping
+		std::unordered_map<std::string, int> structNameToIndex;
+		for (size_t si_ = 0; si_ < version.structs.size(); ++si_)
+		{
+			structNameToIndex.try_emplace(version.structs[si_].name, static_cast<int>(si_));
+		}
 
-				std::smatch m;
-				if (std::regex_search(headerPart, m, std::regex(R"(\[userflags\s+(\d+)\])")))
+		// structs are built on first use so members can reference structs declared after them
+		std::vector<DDLStruct> structs(version.structs.size());
+		std::vector<bool> builtStructs(version.structs.size());
+
+		std::function<const DDLStruct& (int)> buildStruct;
+		buildStruct = [&](const int structIndex) -> const DDLStruct&
+		{
+			if (builtStructs[structIndex]) return structs[structIndex];
+
+			const auto& source = version.structs[structIndex];
+
+			// a duplicate struct is a copy of the first definition with that name
+			if (const auto firstIndex = structNameToIndex.at(source.name); firstIndex != structIndex)
+			{
+				structs[structIndex] = buildStruct(firstIndex);
+				builtStructs[structIndex] = true;
+				return structs[structIndex];
+			}
+
+			DDLStruct st{};
+			st.name = mem->duplicate_string(source.name);
+			st.bitSize = 0;
+			std::vector<DDLMember> members;
+			int offset = 0, index = 0;
+
+			for (const auto& field : source.members)
+			{
+				const std::string& rawType = field.type;
+				const std::string& fieldName = field.name;
+				auto rawLimit = field.limit;
+
+				// Resolve type and external index
+				int dtype = DDLType::DDL_BYTE_TYPE;
+				int externalIndex = 0;
+				if (auto itT = type_names_reverse.find(rawType); itT != type_names_reverse.end()) dtype = itT->second;
+				else if (enumNameToIndex.contains(rawType))
 				{
-					defBase.flags |= DDLFlags::DDL_FLAG_USER_FLAGS;
-					defBase.userFlagsSize = std::stoi(m[1].str());
+					dtype = DDLType::DDL_ENUM_TYPE;
+					externalIndex = enumNameToIndex[rawType];
 				}
-				if (std::regex_search(headerPart, m, std::regex(R"(\[reserve\s+(\d+)\])")))
+				else
 				{
-					defBase.flags |= DDLFlags::DDL_FLAG_RESERVE;
-					defBase.reserveSize = std::stoi(m[1].str());
+					dtype = DDLType::DDL_STRUCT_TYPE;
+					externalIndex = structNameToIndex.at(rawType);
 				}
-				if (std::regex_search(headerPart, std::regex(R"(\[codeversion\])"))) defBase.flags |= DDLFlags::DDL_FLAG_CODE_VERSION;
-				if (std::regex_search(headerPart, std::regex(R"(\[nopadding\])")))   defBase.flags |= DDLFlags::DDL_FLAG_NO_PADDING;
-				if (std::regex_search(headerPart, std::regex(R"(\[checksum\])")))    defBase.flags |= DDLFlags::DDL_FLAG_CHECKSUM;
-				if (std::regex_search(headerPart, std::regex(R"(\[ddlchecksum\])"))) defBase.flags |= DDLFlags::DDL_FLAG_DDL_CHECKSUM;
 
-				if (std::regex_search(headerPart, m, std::regex(R"(\[defchecksum\s+(\d+)\])")))
-				{
-					defBase.checksum = std::stoul(m[1].str());
-				}
+				// Handle size overrides (string/int/uint with explicit limit)
+				int sizeOverride = -1;
 
-				// Header bit size (per version)
-				int headerBits = 16;
-				if (defBase.flags & DDLFlags::DDL_FLAG_CHECKSUM)     headerBits += 32;
-				if (defBase.flags & DDLFlags::DDL_FLAG_DDL_CHECKSUM) headerBits += 32;
-				if (defBase.flags & DDLFlags::DDL_FLAG_CODE_VERSION) headerBits += 16;
-				if (defBase.flags & DDLFlags::DDL_FLAG_USER_FLAGS)   headerBits += defBase.userFlagsSize * 8;
-				if (defBase.flags & DDLFlags::DDL_FLAG_RESERVE)      headerBits += defBase.reserveSize * 8;
-
-				// --- Collect block lines with brace counting ---
-				size_t braceCount = 1;
-				std::string versionBody;
-				size_t j = i + 1;
-				for (; j < lines.size() && braceCount > 0; ++j)
+				// Handle limit override
+				if (rawLimit.has_value())
 				{
-					versionBody += lines[j] + "\n";
-					braceCount += std::count(lines[j].begin(), lines[j].end(), '{');
-					braceCount -= std::count(lines[j].begin(), lines[j].end(), '}');
-					if (braceCount == 1) break;
+					if (rawType == "string")
+					{
+						sizeOverride = static_cast<int>(rawLimit.value()) * 8;
+						rawLimit.reset();
+					}
 				}
 
-				// --- Build DDLDef with per-version header ---
-				DDLDef def{};
-				def.name = out.name;
-				def.version = versionNumber;
-				def.flags = defBase.flags;
-				def.headerBitSize = headerBits;
-				def.headerByteSize = ceil_div_int(headerBits, 8);
-				def.reserveSize = defBase.reserveSize;
-				def.userFlagsSize = defBase.userFlagsSize;
-				def.paddingUsed = !(def.flags & DDLFlags::DDL_FLAG_NO_PADDING);
-				
-				// use base checksum if present, otherwise we should compute it ourselves from the version block?
-				def.checksum = defBase.checksum;
-
-				std::vector<DDLEnum> enums;
-				std::unordered_map<std::string, int> enumNameToIndex;
-
-				// --- Parse enums ---
-				size_t k = 0;
-				while (k < versionBody.size())
+				// Handle bit size override
+				if (field.bits.has_value())
 				{
-					std::smatch em;
-					std::string remaining = versionBody.substr(k);
-					std::regex enumLine(R"(enum\s+(\w+)\s*\{)");
-					if (!std::regex_search(remaining, em, enumLine)) break;
-
-					std::string enumName = em[1].str();
-					size_t enumStart = em.position() + em.length();
-					int enumBrace = 1;
-					size_t idx = enumStart;
-					while (idx < remaining.size() && enumBrace > 0)
-					{
-						if (remaining[idx] == '{') enumBrace++;
-						else if (remaining[idx] == '}') enumBrace--;
-						idx++;
-					}
-					std::string membersCsv = remaining.substr(enumStart, idx - enumStart - 1);
-					DDLEnum e{};
-					e.name = mem->duplicate_string(enumName);
-					auto mems = split_csv_commas(membersCsv);
-					e.memberCount = static_cast<int>(mems.size());
-					e.members = mem->allocate<const char*>(e.memberCount);
-					for (int mi = 0; mi < e.memberCount; ++mi)
-						e.members[mi] = mem->duplicate_string(trim(mems[mi]));
-
-					if (!enumNameToIndex.contains(e.name))
+					if (dtype != DDLType::DDL_STRUCT_TYPE &&
+						dtype != DDLType::DDL_ENUM_TYPE &&
+						dtype != DDLType::DDL_STRING_TYPE)
 					{
-						enumNameToIndex[e.name] = static_cast<int>(enums.size());
+						sizeOverride = static_cast<int>(field.bits.value());
+						if (sizeOverride > type_limits[dtype])
+						{
+							ZONETOOL_WARNING("%s:%zu: Field %s in struct %s has bit size override %d exceeding type limit %llu, clamping",
+								fileName.data(), field.line, fieldName.data(), source.name.data(), sizeOverride, type_limits[dtype]);
+							sizeOverride = static_cast<int>(type_limits[dtype]);
+						}
 					}
 					else
 					{
-						enumNameToIndex[e.name + "_dup_"s + std::to_string(enums.size())] = static_cast<int>(enums.size());
-						ZONETOOL_WARNING("Duplicate enum name: %s in version %d", e.name, def.version);
+						ZONETOOL_WARNING("%s:%zu: Field %s in struct %s has bit size override %llu but type %s does not support it, ignoring",
+							fileName.data(), field.line, fieldName.data(), source.name.data(), field.bits.value(), rawType.data());
 					}
+				}
 
-					enums.push_back(std::move(e));
-					k += idx;
+				// Compute type size in bits
+				int typeSizeBits = 0;
+				if (dtype == DDLType::DDL_STRUCT_TYPE)
+				{
+					typeSizeBits = buildStruct(externalIndex).bitSize;
+				}
+				else if (dtype == DDLType::DDL_ENUM_TYPE)
+				{
+					const DDLEnum& e = enums[externalIndex];
+					int count = static_cast<int>(e.memberCount);
+					int bitsNeeded = std::max(1, ceil_log2_int(count));
+					typeSizeBits = (count == 2) ? 1 : ceil_div_int(bitsNeeded, 8) * 8;
+				}
+				else
+				{
+					typeSizeBits = (sizeOverride >= 0) ? sizeOverride : type_sizes[dtype];
 				}
 
-				// --- Parse structs ---
-				std::vector<std::pair<std::string, std::string>> structBodies;
+				// Resolve array size
+				int arraySize = 1;
+				if (field.array_size.has_value())
 				{
-					std::regex structLine(R"(struct\s+(\w+)\s*\{)");
-					size_t pos = 0;
-					while (pos < versionBody.size())
-					{
-						std::smatch sm;
-						std::string remaining = versionBody.substr(pos);
-						if (!std::regex_search(remaining, sm, structLine)) break;
-
-						std::string structName = sm[1].str();
-						size_t structStart = sm.position() + sm.length();
-						int structBrace = 1;
-						size_t idx = structStart;
-						while (idx < remaining.size() && structBrace > 0)
-						{
-							if (remaining[idx] == '{') structBrace++;
-							else if (remaining[idx] == '}') structBrace--;
-							idx++;
-						}
-						structBodies.emplace_back(structName, remaining.substr(structStart, idx - structStart - 1));
-						pos += idx;
-					}
+					arraySize = static_cast<int>(field.array_size.value());
 				}
+				else if (!field.array_enum.empty())
+				{
+					arraySize = enums[enumNameToIndex.at(field.array_enum)].memberCount;
+				}
+
+				// Resolve range/limits
+				size_t limit = rawLimit.has_value() ? static_cast<size_t>(rawLimit.value())
+					: (type_limits.count(dtype) ? type_limits[dtype] : 0);
+
+				const auto maxSigned = [](int bits)
+				{
+					if (bits >= 32) return INT32_MAX;
+					return static_cast<int32_t>((1ULL << (bits - 1)) - 1);
+				};
 
-				// Struct index mapping
-				std::unordered_map<std::string, int> structNameToIndex;
-				int sidx = 0;
-				for (const auto& kv : structBodies)
+				const auto maxUnsigned = [](int bits)
 				{
-					if (!structNameToIndex.contains(kv.first))
+					if (bits >= 32) return UINT32_MAX;
+					return static_cast<uint32_t>((1ULL << bits) - 1);
+				};
+
+				if (!rawLimit.has_value())
+				{
+					if (dtype == DDLType::DDL_UINT_TYPE)
 					{
-						structNameToIndex[kv.first] = sidx++;
+						limit = maxUnsigned(typeSizeBits);
 					}
-					else
+					else if (dtype == DDLType::DDL_INT_TYPE)
 					{
-						structNameToIndex[kv.first + "_dup_"s + std::to_string(sidx)] = sidx++;
-						ZONETOOL_WARNING("Duplicate struct name: %s in version %d", kv.first.data(), def.version);
+						limit = maxSigned(typeSizeBits);
 					}
 				}
 
-				// Parsed struct cache
-				std::unordered_map<std::string, DDLStruct> parsedStructs;
-
-				std::function<DDLStruct& (const std::string&)> parseStruct;
-				parseStruct = [&](const std::string& name) -> DDLStruct&
+				if (!sizeOverride && 
+					dtype != DDLType::DDL_FLOAT_TYPE &&
+					dtype != DDLType::DDL_STRUCT_TYPE &&
+					dtype != DDLType::DDL_ENUM_TYPE &&
+					dtype != DDLType::DDL_STRING_TYPE)
 				{
-					auto itc = parsedStructs.find(name);
-					if (itc != parsedStructs.end()) return itc->second;
-
-					auto itBody = std::find_if(
-						structBodies.begin(), structBodies.end(),
-						[&name](const auto& pair) { return pair.first == name; }
-					);
-					if (itBody == structBodies.end())
-						throw std::runtime_error("Struct " + name + " not found");
-
-					DDLStruct st{};
-					st.name = mem->duplicate_string(name);
-					st.bitSize = 0;
-					std::vector<DDLMember> members;
-					int offset = 0, index = 0;
-
-					std::regex fieldRe(R"(^\s*([\w]+)(?::(\d+))?(?:\((\d+)\))?\s+(\w+)(?:\[\s*(\w+)\s*\])?;)");
-					std::string& body = itBody->second;
-					for (std::sregex_iterator fit(body.begin(), body.end(), fieldRe), fend; fit != fend; ++fit)
-					{
-						auto fm = *fit;
-						std::string rawType = fm[1].str();
-						std::string rawBits = fm[2].matched ? fm[2].str() : "";
-						std::string rawLimit = fm[3].matched ? fm[3].str() : "";
-						std::string fieldName = fm[4].str();
-						std::string arrayLen = fm[5].matched ? fm[5].str() : "";
-
-						// Resolve type and external index
-						int dtype = DDLType::DDL_BYTE_TYPE;
-						int externalIndex = 0;
-						if (auto itT = type_names_reverse.find(rawType); itT != type_names_reverse.end()) dtype = itT->second;
-						else if (enumNameToIndex.contains(rawType))
-						{
-							dtype = DDLType::DDL_ENUM_TYPE;
-							externalIndex = enumNameToIndex[rawType];
-						}
-						else if (structNameToIndex.contains(rawType))
-						{
-							dtype = DDLType::DDL_STRUCT_TYPE;
-							externalIndex = structNameToIndex[rawType];
-						}
-
-						// Handle size overrides (string/int/uint with explicit limit)
-						int sizeOverride = -1;
-
-						// Handle limit override
-						if (!rawLimit.empty())
-						{
-							if (rawType == "string")
-							{
-								sizeOverride = std::stoi(rawLimit) * 8;
-								rawLimit.clear();
-							}
-						}
-
-						// Handle bit size override
-						if (!rawBits.empty())
-						{
-							if (dtype != DDLType::DDL_STRUCT_TYPE &&
-								dtype != DDLType::DDL_ENUM_TYPE &&
-								dtype != DDLType::DDL_STRING_TYPE)
-							{
-								sizeOverride = std::stoi(rawBits);
-								if (sizeOverride > type_limits[dtype])
-								{
-									ZONETOOL_WARNING("Field %s in struct %s has bit size override %d exceeding type limit %llu, clamping",
-										fieldName.data(), name.data(), sizeOverride, type_limits[dtype]);
-									sizeOverride = static_cast<int>(type_limits[dtype]);
-								}
-							}
-							else
-							{
-								ZONETOOL_WARNING("Field %s in struct %s has bit size override %d but type %s does not support it, ignoring",
-									fieldName.data(), name.data(), std::stoi(rawBits), rawType.data());
-							}
-						}
-
-						// Compute type size in bits
-						int typeSizeBits = 0;
-						if (dtype == DDLType::DDL_STRUCT_TYPE)
-						{
-							typeSizeBits = parseStruct(rawType).bitSize;
-						}
-						else if (dtype == DDLType::DDL_ENUM_TYPE)
-						{
-							const DDLEnum& e = enums[externalIndex];
-							int count = static_cast<int>(e.memberCount);
-							int bitsNeeded = std::max(1, ceil_log2_int(count));
-							typeSizeBits = (count == 2) ? 1 : ceil_div_int(bitsNeeded, 8) * 8;
-						}
-						else
-						{
-							typeSizeBits = (sizeOverride >= 0) ? sizeOverride : type_sizes[dtype];
-						}
-
-						// Resolve array size
-						int arraySize = 1;
-						if (!arrayLen.empty())
-						{
-							try
-							{
-								arraySize = std::stoi(arrayLen);
-							}
-							catch (...)
-							{
-								if (enumNameToIndex.count(arrayLen))
-								{
-									arraySize = enums[enumNameToIndex[arrayLen]].memberCount;
-								}
-							}
-						}
-
-						// Resolve range/limits
-						size_t limit = (!rawLimit.empty()) ? std::stoi(rawLimit)
-							: (type_limits.count(dtype) ? type_limits[dtype] : 0);
-
-						const auto maxSigned = [](int bits)
-						{
-							if (bits >= 32) return INT32_MAX;
-							return static_cast<int32_t>((1ULL << (bits - 1)) - 1);
-						};
-
-						const auto maxUnsigned = [](int bits)
-						{
-							if (bits >= 32) return UINT32_MAX;
-							return static_cast<uint32_t>((1ULL << bits) - 1);
-						};
+					int bitsNeeded = ceil_log2_int(limit + 1);
+					typeSizeBits = std::max(typeSizeBits, bitsNeeded);
+				}
 
-						if (rawLimit.empty())
-						{
-							if (dtype == DDLType::DDL_UINT_TYPE)
-							{
-								limit = maxUnsigned(typeSizeBits);
-							}
-							else if (dtype == DDLType::DDL_INT_TYPE)
-							{
-								limit = maxSigned(typeSizeBits);
-							}
-						}
+				// Compute total bit size
+				int bitSize = arraySize * typeSizeBits;
 
-						if (!sizeOverride && 
-							dtype != DDLType::DDL_FLOAT_TYPE &&
-							dtype != DDLType::DDL_STRUCT_TYPE &&
-							dtype != DDLType::DDL_ENUM_TYPE &&
-							dtype != DDLType::DDL_STRING_TYPE)
-						{
-							int bitsNeeded = ceil_log2_int(limit + 1);
-							typeSizeBits = std::max(typeSizeBits, bitsNeeded);
-						}
+				DDLMember member{};
+				member.name = mem->duplicate_string(fieldName);
+				member.index = (dtype == DDLType::DDL_ENUM_TYPE || dtype == DDLType::DDL_STRUCT_TYPE) ? 0 : index;
+				member.bitSize = bitSize;
+				member.limitSize = 0;
+				member.offset = offset;
+				member.externalIndex = externalIndex;
+				member.rangeLimit = static_cast<unsigned int>(limit);
+				member.serverDelta = static_cast<unsigned int>(limit);
+				member.clientDelta = static_cast<unsigned int>(limit);
+				member.arraySize = arraySize;
+				member.enumIndex = 0;
+				member.permission = 3;
+
+				member.type = 
+					dtype == DDL_BOOL_TYPE_FIXUP ? DDLType::DDL_UINT_TYPE :
+					dtype == DDL_INT8_TYPE_FIXUP ? DDLType::DDL_UINT_TYPE :
+					dtype == DDL_UINT8_TYPE_FIXUP ? DDLType::DDL_UINT_TYPE :
+					dtype == DDL_INT16_TYPE_FIXUP ? DDLType::DDL_UINT_TYPE :
+					dtype == DDL_UINT16_TYPE_FIXUP ? DDLType::DDL_UINT_TYPE :
+					dtype;
+
+				if (dtype != DDLType::DDL_STRUCT_TYPE && dtype != DDLType::DDL_ENUM_TYPE && dtype != DDLType::DDL_STRING_TYPE)
+				{
+					member.limitSize = typeSizeBits;
+					if (member.type == DDLType::DDL_UINT_TYPE)
+					{
+						member.limitSize = ceil_log2_int(limit + 1);
+					}
+				}
 
-						// Compute total bit size
-						int bitSize = arraySize * typeSizeBits;
-
-						DDLMember member{};
-						member.name = mem->duplicate_string(fieldName);
-						member.index = (dtype == DDLType::DDL_ENUM_TYPE || dtype == DDLType::DDL_STRUCT_TYPE) ? 0 : index;
-						member.bitSize = bitSize;
-						member.limitSize = 0;
-						member.offset = offset;
-						member.externalIndex = externalIndex;
-						member.rangeLimit = static_cast<unsigned int>(limit);
-						member.serverDelta = static_cast<unsigned int>(limit);
-						member.clientDelta = static_cast<unsigned int>(limit);
-						member.arraySize = arraySize;
-						member.enumIndex = 0;
-						member.permission = 3;
-
-						member.type = 
-							dtype == DDL_BOOL_TYPE_FIXUP ? DDLType::DDL_UINT_TYPE :
-							dtype == DDL_INT8_TYPE_FIXUP ? DDLType::DDL_UINT_TYPE :
-							dtype == DDL_UINT8_TYPE_FIXUP ? DDLType::DDL_UINT_TYPE :
-							dtype == DDL_INT16_TYPE_FIXUP ? DDLType::DDL_UINT_TYPE :
-							dtype == DDL_UINT16_TYPE_FIXUP ? DDLType::DDL_UINT_TYPE :
-							dtype;
-
-						if (dtype != DDLType::DDL_STRUCT_TYPE && dtype != DDLType::DDL_ENUM_TYPE && dtype != DDLType::DDL_STRING_TYPE)
-						{
-							member.limitSize = typeSizeBits;
-							if (member.type == DDLType::DDL_UINT_TYPE)
-							{
-								member.limitSize = ceil_log2_int(limit + 1);
-							}
-						}
+				if (!field.array_enum.empty())
+					member.enumIndex = enumNameToIndex.at(field.array_enum);
+				else if (arraySize > 1)
+					member.enumIndex = -1;
 
-						if (!arrayLen.empty() && enumNameToIndex.count(arrayLen))
-							member.enumIndex = enumNameToIndex[arrayLen];
-						else if (arraySize > 1)
-							member.enumIndex = -1;
+				members.push_back(member);
+				offset += member.bitSize;
+				++index;
+			}
 
-						members.push_back(member);
-						offset += member.bitSize;
-						++index;
-					}
+			if (def.paddingUsed)
+			{
+				int padBits = (8 - (offset % 8)) % 8;
+				if (padBits > 0)
+				{
+					DDLMember pad{};
+					pad.name = "__pad";
+					pad.index = index++;
+					pad.bitSize = pad.limitSize = padBits;
+					pad.offset = offset;
+					pad.type = DDLType::DDL_PAD_TYPE;
+					pad.externalIndex = 0;
+					pad.rangeLimit = pad.serverDelta = pad.clientDelta = 0;
+					pad.arraySize = 1;
+					pad.enumIndex = 0;
+					pad.permission = 3;
+					members.push_back(pad);
+					offset += padBits;
+				}
+			}
 
-					if (def.paddingUsed)
-					{
-						int padBits = (8 - (offset % 8)) % 8;
-						if (padBits > 0)
-						{
-							DDLMember pad{};
-							pad.name = "__pad";
-							pad.index = index++;
-							pad.bitSize = pad.limitSize = padBits;
-							pad.offset = offset;
-							pad.type = DDLType::DDL_PAD_TYPE;
-							pad.externalIndex = 0;
-							pad.rangeLimit = pad.serverDelta = pad.clientDelta = 0;
-							pad.arraySize = 1;
-							pad.enumIndex = 0;
-							pad.permission = 3;
-							members.push_back(pad);
-							offset += padBits;
-						}
-					}
+			st.bitSize = offset;
+			st.memberCount = static_cast<int>(members.size());
+			st.members = mem->allocate<DDLMember>(st.memberCount);
+			for (size_t mi = 0; mi < st.memberCount; ++mi)
+				st.members[mi] = std::move(members[mi]);
 
-					st.bitSize = offset;
-					st.memberCount = static_cast<int>(members.size());
-					st.members = mem->allocate<DDLMember>(st.memberCount);
-					for (size_t mi = 0; mi < st.memberCount; ++mi)
-						st.members[mi] = std::move(members[mi]);
+			structs[structIndex] = std::move(st);
+			builtStructs[structIndex] = true;
+			return structs[structIndex];
+		};
 
-					auto [itIns, _] = parsedStructs.emplace(name, std::move(st));
-					return itIns->second;
-				};
+		for (int si_ = 0; si_ < static_cast<int>(structs.size()); ++si_) buildStruct(si_);
 
-				std::vector<DDLStruct> structs;
-				for (const auto& kv : structBodies) structs.push_back(parseStruct(kv.first));
+		def.bitSize = structs[structNameToIndex.at("root")].bitSize + def.headerBitSize;
+		def.byteSize = ceil_div_int(def.bitSize, 8);
 
-				auto itRoot = std::find_if(structs.begin(), structs.end(), [](const DDLStruct& s) { return s.name == "root"s; });
-				if (itRoot == structs.end()) throw std::runtime_error("Root struct not found");
+		// Copy structs
+		def.structCount = static_cast<int>(structs.size());
+		def.structList = mem->allocate<DDLStruct>(def.structCount);
+		for (int si_ = 0; si_ < def.structCount; ++si_) def.structList[si_] = std::move(structs[si_]);
 
-				def.bitSize = itRoot->bitSize + def.headerBitSize;
-				def.byteSize = ceil_div_int(def.bitSize, 8);
+		// Copy enums
+		def.enumCount = static_cast<int>(enums.size());
+		def.enumList = mem->allocate<DDLEnum>(def.enumCount);
+		for (int ei_ = 0; ei_ < def.enumCount; ++ei_) def.enumList[ei_] = std::move(enums[ei_]);
 
-				// Copy structs
-				def.structCount = static_cast<int>(structs.size());
-				def.structList = mem->allocate<DDLStruct>(def.structCount);
-				for (int si_ = 0; si_ < def.structCount; ++si_) def.structList[si_] = std::move(structs[si_]);
+		// Generate hash tables
+		generateHashTables(&def, mem);
 
-				// Copy enums
-				def.enumCount = static_cast<int>(enums.size());
-				def.enumList = mem->allocate<DDLEnum>(def.enumCount);
-				for (int ei_ = 0; ei_ < def.enumCount; ++ei_) def.enumList[ei_] = std::move(enums[ei_]);
+		return def;
+	}
 
-				// Generate hash tables
-				generateHashTables(&def, mem);
+	DDLFile parseDDLFile(const std::string& input, const std::string& name, zone_memory* mem)
+	{
+		const auto source = ddl_source::parse(input, name);
 
-				defs.push_back(std::move(def));
-				i = j; // skip to end of version block
-				lastVersionLineIndex = i;
-			}
-			else ++i;
+		std::vector<std::string> warnings;
+		ddl_source::validate(source, name, &warnings);
+		for (const auto& warning : warnings)
+		{
+			ZONETOOL_WARNING("%s", warning.data());
 		}
 
-		out.ddlDef = mem->allocate<DDLDef>(defs.size());
-		for (size_t di_ = 0; di_ < defs.size(); ++di_)
+		DDLFile out{};
+		out.name = mem->duplicate_string(name);
+
+		out.ddlDef = mem->allocate<DDLDef>(source.versions.size());
+		for (size_t di_ = 0; di_ < source.versions.size(); ++di_)
 		{
-			out.ddlDef[di_] = std::move(defs[di_]);
-			out.ddlDef[di_].next = (di_ + 1 < defs.size()) ? &out.ddlDef[di_ + 1] : nullptr;
+			out.ddlDef[di_] = buildDDLDef(source.versions[di_], name, out.name, mem);
+			out.ddlDef[di_].next = (di_ + 1 < source.versions.size()) ? &out.ddlDef[di_ + 1] : nullptr;
 		}
 
 		return out;
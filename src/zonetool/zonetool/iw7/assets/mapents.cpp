@@ -708,9 +708,8 @@ namespace zonetool::iw7
 
 		if (data->havokEntsShapeData)
 		{
-			buf->align(15);
-			buf->write(data->havokEntsShapeData, data->havokEntsShapeDataSize);
-			buf->clear_pointer(&dest->havokEntsShapeData);
+			// blobs shared between assets are only written once
+			dest->havokEntsShapeData = buf->write_s(15, data->havokEntsShapeData, data->havokEntsShapeDataSize);
 		}
 
 		if (data->cmodels)
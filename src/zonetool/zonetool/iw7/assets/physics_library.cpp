@@ -93,9 +93,8 @@ namespace zonetool::iw7
 
 		if (data->havokData)
 		{
-			buf->align(15);
-			buf->write(data->havokData, data->havokDataSize);
-			buf->clear_pointer(&dest->havokData);
+			// blobs shared between assets are only written once
+			dest->havokData = buf->write_s(15, data->havokData, data->havokDataSize);
 		}
 
 		buf->pop_stream();
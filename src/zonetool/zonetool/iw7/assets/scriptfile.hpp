@@ -3,5 +3,5 @@
 
 namespace zonetool::iw7
 {
-	REGISTER_TEMPLATED_ASSET(scriptfile, ScriptFile, ASSET_TYPE_SCRIPTFILE);
+	REGISTER_TEMPLATED_ASSET(scriptfile, ScriptFile, ASSET_TYPE_SCRIPTFILE, gsc_cache::game::iw7);
 }
\ No newline at end of file
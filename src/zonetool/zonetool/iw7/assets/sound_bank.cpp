@@ -2,6 +2,7 @@
 #include "sound_bank.hpp"
 
 #include "../common/sound.hpp"
+#include "../common/sound_alias_index.hpp"
 
 #include "utils/io.hpp"
 #include "utils/bit_buffer.hpp"
@@ -210,6 +211,39 @@ namespace zonetool::iw7
 			writer.save(get_path(asset));
 		}
 
+		struct alias_value_tables
+		{
+			value_index_table volmods{VOLMODS};
+			value_index_table entchannels{ENTCHANNELS};
+			value_index_table load_types{LOAD_TYPES};
+			value_index_table loop_types{LOOP_TYPES};
+			value_index_table vf_curves{vf_curves_s};
+			value_index_table lpf_curves{lpf_curves_s};
+			value_index_table hpf_curves{hpf_curves_s};
+			value_index_table rvb_curves{rvb_curves_s};
+			value_index_table speaker_maps{speaker_maps_s};
+			value_index_table full_dry_level{FULLDRYLEVEL};
+			value_index_table shapes{SHAPES};
+			value_index_table false_true{FALSE_TRUE};
+			value_index_table occlusion_shapes{occlusion_shapes_s};
+			value_index_table doppler_presets{doppler_presets_s};
+			value_index_table music_content{MUSIC_CONTENT};
+			value_index_table gpad_output{GPAD_OUTPUT};
+
+			unsigned char default_vf_curve = vf_curves.get<unsigned char>("default");
+			unsigned char default_lpf_curve = lpf_curves.get<unsigned char>("default");
+			unsigned char default_hpf_curve = hpf_curves.get<unsigned char>("default");
+			unsigned char default_reverb_send_curve = rvb_curves.get<unsigned char>("default");
+			unsigned char default_speaker_map = speaker_maps.get<unsigned char>("default");
+			unsigned char default_occlusion_shape = occlusion_shapes.get<unsigned char>("default");
+		};
+
+		const alias_value_tables& get_alias_value_tables()
+		{
+			static const alias_value_tables tables;
+			return tables;
+		}
+
 		void parse_file(SndBank* asset, const std::string& path, std::vector<SndAlias*>& aliases, std::set<std::string>& ducks, zone_memory* mem)
 		{
 			ZONETOOL_INFO("Parsing sound alias csv \"%s\"...", path.data());
@@ -228,6 +262,7 @@ namespace zonetool::iw7
 			}
 
 			const auto rows = parser.get_rows();
+			const auto& tables = get_alias_value_tables();
 
 			for (auto i = 1; i < row_count; i++)
 			{
@@ -280,36 +315,26 @@ namespace zonetool::iw7
 
 				alias->volMin = get_value<float>(get());
 				alias->volMax = get_value<float>(get());
-				alias->volModIndex = get_value_index<int>(get(), VOLMODS, std::extent_v<decltype(VOLMODS)>);
+				alias->volModIndex = tables.volmods.get<int>(get());
 				alias->pitchMin = get_value<float>(get());
 				alias->pitchMax = get_value<float>(get());
 				alias->donutFadeEnd = get_value<float>(get());
 				alias->distMin = get_value<float>(get());
 				alias->distMax = get_value<float>(get());
 				alias->velocityMin = get_value<float>(get());
-				alias->flags.channel = get_value_index<unsigned int>(get(), ENTCHANNELS, std::extent_v<decltype(ENTCHANNELS)>);
-				alias->flags.type = get_value_index<unsigned int>(get(), LOAD_TYPES, std::extent_v<decltype(LOAD_TYPES)>);
-				alias->flags.looping = get_value_index<unsigned int>(get(), LOOP_TYPES, std::extent_v<decltype(LOOP_TYPES)>);
+				alias->flags.channel = tables.entchannels.get<unsigned int>(get());
+				alias->flags.type = tables.load_types.get<unsigned int>(get());
+				alias->flags.looping = tables.loop_types.get<unsigned int>(get());
 				alias->probability = get_value<float>(get());
 
-				const auto default_vf_curve = get_value_index<unsigned char>("default", vf_curves_s, std::extent_v<decltype(vf_curves_s)>, 0);
-				alias->volumeFalloffCurveIndex = get_value_index<unsigned char>(get(), vf_curves_s, std::extent_v<decltype(vf_curves_s)>, default_vf_curve);
-
-				const auto default_lpf_curve = get_value_index<unsigned char>("default", lpf_curves_s, std::extent_v<decltype(lpf_curves_s)>, 0);
-				alias->lpfCurveIndex = get_value_index<unsigned char>(get(), lpf_curves_s, std::extent_v<decltype(lpf_curves_s)>, default_lpf_curve);
-
-				const auto default_hpf_curve = get_value_index<unsigned char>("default", hpf_curves_s, std::extent_v<decltype(hpf_curves_s)>, 0);
-				alias->hpfCurveIndex = get_value_index<unsigned char>(get(), hpf_curves_s, std::extent_v<decltype(hpf_curves_s)>, default_hpf_curve);
-
-				const auto default_reverb_send_curve = get_value_index<unsigned char>("default", rvb_curves_s, std::extent_v<decltype(rvb_curves_s)>, 0);
-				alias->reverbSendCurveIndex = get_value_index<unsigned char>(get(), rvb_curves_s, std::extent_v<decltype(rvb_curves_s)>, default_reverb_send_curve);
+				alias->volumeFalloffCurveIndex = tables.vf_curves.get<unsigned char>(get(), tables.default_vf_curve);
+				alias->lpfCurveIndex = tables.lpf_curves.get<unsigned char>(get(), tables.default_lpf_curve);
+				alias->hpfCurveIndex = tables.hpf_curves.get<unsigned char>(get(), tables.default_hpf_curve);
+				alias->reverbSendCurveIndex = tables.rvb_curves.get<unsigned char>(get(), tables.default_reverb_send_curve);
 
 				alias->startDelay = get_value<int>(get());
-
-				const auto default_speaker_map = get_value_index<unsigned char>("default", speaker_maps_s, std::extent_v<decltype(speaker_maps_s)>, 0);
-				alias->speakerMapIndex = get_value_index<unsigned char>(get(), speaker_maps_s, std::extent_v<decltype(speaker_maps_s)>, default_speaker_map);
-
-				alias->flags.reverb = get_value_index<unsigned int>(get(), FULLDRYLEVEL, std::extent_v<decltype(FULLDRYLEVEL)>);
+				alias->speakerMapIndex = tables.speaker_maps.get<unsigned char>(get(), tables.default_speaker_map);
+				alias->flags.reverb = tables.full_dry_level.get<unsigned int>(get());
 				alias->reverbMultiplier = get_value<float>(get());
 				alias->farReverbMultiplier = get_value<float>(get());
 				alias->lfePercentage = get_value<float>(get());
@@ -317,14 +342,10 @@ namespace zonetool::iw7
 				alias->envelopMin = get_value<float>(get());
 				alias->envelopMax = get_value<float>(get());
 				alias->envelopPercentage = get_value<float>(get());
-				alias->flags.shape = get_value_index<unsigned int>(get(), SHAPES, std::extent_v<decltype(SHAPES)>);
-				alias->flags.ignoreDistanceCheck = get_value_index<unsigned int>(get(), FALSE_TRUE, std::extent_v<decltype(FALSE_TRUE)>);
-
-				const auto default_occlusion_shape = get_value_index<unsigned char>("default", occlusion_shapes_s, std::extent_v<decltype(occlusion_shapes_s)>, 0);
-				alias->occlusionShapeIndex = get_value_index<unsigned char>(get(), occlusion_shapes_s, std::extent_v<decltype(occlusion_shapes_s)>, default_occlusion_shape);
-
-				alias->dopplerPresetIndex = get_value_index<unsigned char>(get(), doppler_presets_s, std::extent_v<decltype(doppler_presets_s)>, 0xFF);
-
+				alias->flags.shape = tables.shapes.get<unsigned int>(get());
+				alias->flags.ignoreDistanceCheck = tables.false_true.get<unsigned int>(get());
+				alias->occlusionShapeIndex = tables.occlusion_shapes.get<unsigned char>(get(), tables.default_occlusion_shape);
+				alias->dopplerPresetIndex = tables.doppler_presets.get<unsigned char>(get(), 0xFF);
 				alias->smartPanDistance2d = get_value<float>(get());
 				alias->smartPanDistance3d = get_value<float>(get());
 				alias->smartPanAttenuation2d = get_value<float>(get());
@@ -334,7 +355,7 @@ namespace zonetool::iw7
 				alias->stereoSpreadMaxAngle = get_value<int>(get());
 				alias->contextType = snd_hash_name(get());
 				alias->contextValue = snd_hash_name(get());
-				alias->flags.precached = get_value_index<unsigned int>(get(), FALSE_TRUE, std::extent_v<decltype(FALSE_TRUE)>);
+				alias->flags.precached = tables.false_true.get<unsigned int>(get());
 
 				auto duck = get_string();
 				if (duck)
@@ -343,9 +364,9 @@ namespace zonetool::iw7
 					alias->duck = snd_hash_name(duck);
 				}
 
-				alias->flags.MusicContent = get_value_index<unsigned int>(get(), MUSIC_CONTENT, std::extent_v<decltype(MUSIC_CONTENT)>);
-				alias->flags.GPadOutput = get_value_index<unsigned int>(get(), GPAD_OUTPUT, std::extent_v<decltype(GPAD_OUTPUT)>);
-				alias->flags.ForceSubtitle = get_value_index<unsigned int>(get(), FALSE_TRUE, std::extent_v<decltype(FALSE_TRUE)>);
+				alias->flags.MusicContent = tables.music_content.get<unsigned int>(get());
+				alias->flags.GPadOutput = tables.gpad_output.get<unsigned int>(get());
+				alias->flags.ForceSubtitle = tables.false_true.get<unsigned int>(get());
 				alias->masterPriority = get_value<int>(get());
 				alias->masterPercentage = get_value<float>(get());
 				alias->slavePercentage = get_value<float>(get());
@@ -354,6 +375,31 @@ namespace zonetool::iw7
 			}
 		}
 
+		void build_alias_index(SndBank* asset, zone_memory* mem)
+		{
+			static_assert(sizeof(SndIndexEntry) == sizeof(sound_alias_index::entry));
+
+			const auto count = asset->aliasCount;
+			asset->aliasIndex = mem->allocate<SndIndexEntry>(count);
+
+			std::vector<std::uint32_t> ids(count);
+			for (auto i = 0u; i < count; i++)
+			{
+				ids[i] = asset->alias[i].id;
+			}
+
+			auto* index = reinterpret_cast<sound_alias_index::entry*>(asset->aliasIndex);
+
+			try
+			{
+				sound_alias_index::build(ids.data(), count, index);
+			}
+			catch (const std::exception& e)
+			{
+				ZONETOOL_FATAL("%s", e.what());
+			}
+		}
+
 		void parse(SndBank* asset, zone_memory* mem, ordered_json& paths)
 		{
 			if (!paths.is_array() || !paths.size()) return;
@@ -436,64 +482,7 @@ namespace zonetool::iw7
 			}
 			alias_list.clear();
 
-			// create alias index list
-			asset->aliasIndex = mem->allocate<SndIndexEntry>(asset->aliasCount);
-			memset(asset->aliasIndex, 0xFF, sizeof(SndIndexEntry) * asset->aliasCount);
-
-			const auto setAliasIndexList = std::make_unique<bool[]>(asset->aliasCount);
-			memset(setAliasIndexList.get(), false, asset->aliasCount);
-
-			for (unsigned short i = 0; i < asset->aliasCount; i++)
-			{
-				const auto idx = asset->alias[i].id % asset->aliasCount;
-				if (asset->aliasIndex[idx].value == std::numeric_limits<unsigned short>::max())
-				{
-					asset->aliasIndex[idx].value = i;
-					asset->aliasIndex[idx].next = std::numeric_limits<unsigned short>::max();
-					setAliasIndexList[i] = true;
-				}
-			}
-
-			for (unsigned short i = 0u; i < asset->aliasCount; i++)
-			{
-				if (setAliasIndexList[i])
-					continue;
-
-				unsigned short idx = static_cast<unsigned short>(asset->alias[i].id % asset->aliasCount);
-				while (asset->aliasIndex[idx].next != std::numeric_limits<unsigned short>::max())
-				{
-					idx = asset->aliasIndex[idx].next;
-				}
-
-				unsigned short offset = 1u;
-				auto freeIdx = std::numeric_limits<unsigned short>::max();
-				while (true)
-				{
-					freeIdx = (idx + offset) % asset->aliasCount;
-					if (asset->aliasIndex[freeIdx].value == std::numeric_limits<unsigned short>::max())
-						break;
-
-					freeIdx = (idx + static_cast<unsigned short>(asset->aliasCount) - offset) % static_cast<unsigned short>(asset->aliasCount);
-					if (asset->aliasIndex[freeIdx].value == std::numeric_limits<unsigned short>::max())
-						break;
-
-					offset++;
-					freeIdx = std::numeric_limits<unsigned short>::max();
-
-					if (offset >= asset->aliasCount)
-						break;
-				}
-
-				if (freeIdx == std::numeric_limits<unsigned short>::max())
-				{
-					ZONETOOL_FATAL("Unable to allocate sound bank alias index list");
-				}
-
-				asset->aliasIndex[idx].next = freeIdx;
-				asset->aliasIndex[freeIdx].value = i;
-				asset->aliasIndex[freeIdx].next = std::numeric_limits<unsigned short>::max();
-				setAliasIndexList[i] = true;
-			}
+			build_alias_index(asset, mem);
 		}
 	}
 
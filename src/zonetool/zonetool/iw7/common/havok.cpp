@@ -2,6 +2,8 @@
 #include "zonetool/utils/utils.hpp"
 #include "havok.hpp"
 
+#include <utils/flags.hpp>
+
 namespace zonetool::iw7
 {
 	namespace havok
@@ -44,63 +46,101 @@ namespace zonetool::iw7
 				short predicateArraySizePlusPadding;
 			};
 
-			bool validate_header(hkxHeaderData* header)
+			namespace
+			{
+				// a blob is shared by every asset of the zone that carries the same data
+				struct blob
+				{
+					char* data;
+					unsigned int size;
+				};
+
+				std::unordered_multimap<std::uint64_t, blob> zone_blobs;
+
+				// hash and size of every blob dumped for the current zone, and the file it went to
+				std::mutex dumped_blobs_mutex;
+				std::map<std::pair<std::uint64_t, unsigned int>, std::string> dumped_blobs;
+			}
+
+			std::uint64_t hash_blob(const char* data, const std::size_t size)
+			{
+				// fnv-1a
+				auto hash = 0xCBF29CE484222325ull;
+				for (auto i = 0u; i < size; i++)
+				{
+					hash ^= static_cast<std::uint8_t>(data[i]);
+					hash *= 0x100000001B3;
+				}
+
+				return hash;
+			}
+
+			std::string get_ref_path(const std::string& path)
+			{
+				return std::filesystem::path(path).replace_extension(havok_ref_file_ext).string();
+			}
+
+			bool validate_header(const char* data, const std::size_t size, const std::string& path)
 			{
-				if (!header)
+				if (!data || size < sizeof(hkxHeaderData))
 				{
-					ZONETOOL_ERROR("Pointer is null");
+					ZONETOOL_ERROR("Havok data \"%s\" is too small to be a packfile", path.data());
 					return false;
 				}
 
+				const auto* header = reinterpret_cast<const hkxHeaderData*>(data);
+
 				if (header->magic1 != hk_magic1 || header->magic2 != hk_magic2)
 				{
-					ZONETOOL_ERROR("Missing packfile magic header. Is this from a binary file?");
+					ZONETOOL_ERROR("Havok data \"%s\" is missing the packfile magic header. Is this from a binary file?", path.data());
 					return false;
 				}
 
 				if (header->pointerSize != sizeof(std::uintptr_t))
 				{
-					ZONETOOL_ERROR("Trying to process a binary file with a different pointer size than this platform.");
+					ZONETOOL_ERROR("Havok data \"%s\" has a different pointer size than this platform.", path.data());
 					return false;
 				}
 
 				if (header->littleEndian != true)
 				{
-					ZONETOOL_ERROR("Trying to process a binary file with a different endian than this platform.");
+					ZONETOOL_ERROR("Havok data \"%s\" has a different endian than this platform.", path.data());
 					return false;
 				}
 
 				if (header->reuseBaseClassPadding != false)
 				{
-					ZONETOOL_ERROR("Trying to process a binary file with a different padding optimization than this platform.");
+					ZONETOOL_ERROR("Havok data \"%s\" has a different padding optimization than this platform.", path.data());
 					return false;
 				}
 
 				if (header->emptyBaseClassOptimization != true)
 				{
-					ZONETOOL_ERROR("Trying to process a binary file with a different empty base class optimization than this platform.");
+					ZONETOOL_ERROR("Havok data \"%s\" has a different empty base class optimization than this platform.", path.data());
 					return false;
 				}
 
 				if (header->contentsVersion[0] != -1)
 				{
-					if (!strcmp(header->contentsVersion, get_version()))
+					if (!strncmp(header->contentsVersion, get_version(), sizeof(header->contentsVersion)))
 					{
 						return true;
 					}
 					else
 					{
-						ZONETOOL_ERROR("Packfile contents are not up to date");
+						ZONETOOL_ERROR("Havok data \"%s\" packfile contents are not up to date", path.data());
 						return false;
 					}
 				}
 
-				ZONETOOL_ERROR("Packfile file format is too old");
+				ZONETOOL_ERROR("Havok data \"%s\" packfile format is too old", path.data());
 				return false;
 			}
 
 			char* parse_havok_data(std::string path, unsigned int* size, zone_memory* mem)
 			{
+				*size = 0;
+
 				if (!path.ends_with(havok_file_ext))
 				{
 					path.append(havok_file_ext);
@@ -109,23 +149,59 @@ namespace zonetool::iw7
 				auto file = filesystem::file(path);
 				if (!file.exists())
 				{
-					*size = 0;
-					return nullptr;
+					// duplicates are dumped as a reference to the first asset that had the data
+					const auto ref_path = get_ref_path(path);
+					auto ref = filesystem::file(ref_path);
+					if (!ref.exists())
+					{
+						return nullptr;
+					}
+
+					ref.open("rb");
+					const auto target = ref.read_bytes(ref.size());
+					ref.close();
+
+					path.assign(target.begin(), target.end());
+					file = filesystem::file(path);
+					if (!file.exists())
+					{
+						ZONETOOL_ERROR("Havok data \"%s\" referenced by \"%s\" does not exist", path.data(), ref_path.data());
+						return nullptr;
+					}
 				}
 
 				file.open("rb");
-				*size = static_cast<unsigned int>(file.size());
 				auto bytes = file.read_bytes(file.size());
 				file.close();
 
-				if (!validate_header(reinterpret_cast<hkxHeaderData*>(bytes.data())))
+				if (bytes.size() > std::numeric_limits<unsigned int>::max())
 				{
-					*size = 0;
+					ZONETOOL_ERROR("Havok data \"%s\" is too big", path.data());
 					return nullptr;
 				}
 
+				const auto* bytes_data = reinterpret_cast<const char*>(bytes.data());
+				if (!validate_header(bytes_data, bytes.size(), path))
+				{
+					return nullptr;
+				}
+
+				*size = static_cast<unsigned int>(bytes.size());
+
+				const auto hash = hash_blob(bytes_data, bytes.size());
+				const auto [begin, end] = zone_blobs.equal_range(hash);
+				for (auto iter = begin; iter != end; ++iter)
+				{
+					if (iter->second.size == *size && !std::memcmp(iter->second.data, bytes_data, *size))
+					{
+						return iter->second.data;
+					}
+				}
+
 				auto* data = mem->allocate<char>(*size);
-				memcpy(data, bytes.data(), *size);
+				std::memcpy(data, bytes_data, *size);
+
+				zone_blobs.emplace(hash, blob{data, *size});
 
 				return data;
 			}
@@ -142,16 +218,60 @@ namespace zonetool::iw7
 					return;
 				}
 
-				if (!validate_header(reinterpret_cast<binary::hkxHeaderData*>(data)))
+				// still dumped so the data isn't lost, building it again will report the same error
+				if (!validate_header(data, size, path))
 				{
-					__debugbreak();
+					ZONETOOL_ERROR("Dumping havok data \"%s\" with an invalid header", path.data());
 				}
 
+				const auto ref_path = get_ref_path(path);
+				const auto remove_dumped = [](const std::string& file)
+				{
+					std::error_code ec;
+					std::filesystem::remove(filesystem::get_dump_path() + file, ec);
+				};
+
+				static const auto dedup = !utils::flags::has_flag("no_havok_dedup");
+				if (dedup)
+				{
+					std::string first_path;
+
+					{
+						std::lock_guard _(dumped_blobs_mutex);
+						first_path = dumped_blobs.try_emplace({hash_blob(data, size), size}, path).first->second;
+					}
+
+					if (first_path != path)
+					{
+						remove_dumped(path);
+
+						auto file = filesystem::file(ref_path);
+						file.open("wb");
+						file.write(first_path);
+						file.close();
+						return;
+					}
+				}
+
+				// a reference left over from an earlier dump would point somewhere else
+				remove_dumped(ref_path);
+
 				auto file = filesystem::file(path);
 				file.open("wb");
 				file.write(data, size, 1);
 				file.close();
 			}
+
+			void clear_zone_blobs()
+			{
+				zone_blobs.clear();
+			}
+
+			void clear_dumped_blobs()
+			{
+				std::lock_guard _(dumped_blobs_mutex);
+				dumped_blobs.clear();
+			}
 		}
 	}
 }
\ No newline at end of file
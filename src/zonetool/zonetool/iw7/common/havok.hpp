@@ -12,9 +12,16 @@ namespace zonetool::iw7
 		namespace binary
 		{
 			constexpr auto havok_file_ext = ".hkx";
+			constexpr auto havok_ref_file_ext = ".hkxref";
 
+			// identical blobs of a zone share one allocation, so write_s emits them once
 			char* parse_havok_data(std::string path, unsigned int* size, zone_memory* mem);
+
+			// blobs already dumped for this zone are written as a .hkxref holding the path of the first copy
 			void dump_havok_data(std::string path, char* data, unsigned int size);
+
+			void clear_zone_blobs();
+			void clear_dumped_blobs();
 		}
 	}
 }
\ No newline at end of file
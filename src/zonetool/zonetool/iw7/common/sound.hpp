@@ -67,6 +67,43 @@ namespace zonetool::iw7
 		return default_value;
 	}
 
+	// hashed variant of get_value_index for tables that are looked up for every csv row,
+	// the first occurrence of a string wins just like the linear search
+	class value_index_table
+	{
+	public:
+		value_index_table(const std::string* lookup_table, const std::size_t len)
+		{
+			this->indices_.reserve(len);
+			for (auto i = 0u; i < len; i++)
+			{
+				this->indices_.try_emplace(lookup_table[i], i);
+			}
+		}
+
+		template <std::size_t N>
+		value_index_table(const std::string (&lookup_table)[N])
+			: value_index_table(lookup_table, N)
+		{
+		}
+
+		template <typename T>
+		T get(const std::string_view& value, T default_value = 0) const
+		{
+			if (value.empty())
+				return default_value;
+
+			const auto iter = this->indices_.find(value);
+			if (iter == this->indices_.end())
+				return default_value;
+
+			return static_cast<T>(iter->second);
+		}
+
+	private:
+		std::unordered_map<std::string_view, std::size_t> indices_;
+	};
+
 	template<typename T>
 	T get_value(const std::string& value)
 	{
@@ -0,0 +1,141 @@
+#include <std_include.hpp>
+
+#include "sound_alias_index.hpp"
+
+namespace zonetool::iw7::sound_alias_index
+{
+	namespace
+	{
+		// nearest free slot lookups over a table where slots only ever get taken,
+		// path compression keeps every query amortized constant
+		class free_slot_finder
+		{
+		public:
+			free_slot_finder(const std::uint32_t count)
+				: count_(count)
+				, right_(count + 1)
+				, left_(count + 1)
+			{
+				for (auto i = 0u; i <= count; i++)
+				{
+					this->right_[i] = i;
+					this->left_[i] = i;
+				}
+			}
+
+			void take(const std::uint32_t slot)
+			{
+				this->right_[slot] = slot + 1;
+				this->left_[slot + 1] = slot;
+			}
+
+			// first free slot at or after index, count_ if there is none
+			std::uint32_t find_right(const std::uint32_t index)
+			{
+				return find(this->right_, index);
+			}
+
+			// last free slot at or before index, count_ if there is none
+			std::uint32_t find_left(const std::uint32_t index)
+			{
+				const auto slot = find(this->left_, index + 1);
+				return slot == 0 ? this->count_ : slot - 1;
+			}
+
+		private:
+			std::uint32_t count_;
+			std::vector<std::uint32_t> right_;
+			std::vector<std::uint32_t> left_; // shifted by one, 0 means none
+
+			static std::uint32_t find(std::vector<std::uint32_t>& parents, std::uint32_t index)
+			{
+				auto root = index;
+				while (parents[root] != root)
+				{
+					root = parents[root];
+				}
+
+				while (parents[index] != root)
+				{
+					index = std::exchange(parents[index], root);
+				}
+
+				return root;
+			}
+		};
+
+		void clear(entry* index, const std::uint32_t count)
+		{
+			std::memset(index, 0xFF, sizeof(entry) * count);
+		}
+	}
+
+	void build(const std::uint32_t* ids, const std::uint32_t count, entry* index)
+	{
+		clear(index, count);
+
+		if (count == 0)
+		{
+			return;
+		}
+
+		free_slot_finder free_slots(count);
+
+		// chains never merge into a node that already has a predecessor,
+		// so each chain is tracked by the slot of its current tail
+		std::vector<std::uint32_t> chain(count);
+		std::vector<std::uint32_t> chain_tail(count);
+
+		std::vector<std::uint32_t> collisions;
+		for (auto i = 0u; i < count; i++)
+		{
+			const auto idx = ids[i] % count;
+			if (index[idx].value != empty)
+			{
+				collisions.emplace_back(i);
+				continue;
+			}
+
+			index[idx].value = static_cast<unsigned short>(i);
+			free_slots.take(idx);
+			chain[idx] = idx;
+			chain_tail[idx] = idx;
+		}
+
+		for (const auto i : collisions)
+		{
+			const auto bucket = ids[i] % count;
+			const auto tail = chain_tail[chain[bucket]];
+
+			// search forward and backward from the tail, wrapping around the table
+			auto next = free_slots.find_right(tail + 1 < count ? tail + 1 : 0);
+			if (next == count)
+			{
+				next = free_slots.find_right(0);
+			}
+
+			auto prev = free_slots.find_left(tail > 0 ? tail - 1 : count - 1);
+			if (prev == count)
+			{
+				prev = free_slots.find_left(count - 1);
+			}
+
+			if (next == count || prev == count)
+			{
+				throw std::runtime_error("Unable to allocate sound bank alias index list");
+			}
+
+			const auto forward_distance = (next + count - tail) % count;
+			const auto backward_distance = (tail + count - prev) % count;
+			const auto slot = forward_distance <= backward_distance ? next : prev;
+
+			index[tail].next = static_cast<unsigned short>(slot);
+			index[slot].value = static_cast<unsigned short>(i);
+			index[slot].next = empty;
+			free_slots.take(slot);
+
+			chain[slot] = chain[bucket];
+			chain_tail[chain[bucket]] = slot;
+		}
+	}
+}
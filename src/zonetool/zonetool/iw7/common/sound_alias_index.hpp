@@ -0,0 +1,21 @@
+#pragma once
+
+// only depends on the standard library so it can be built and tested on its own
+namespace zonetool::iw7::sound_alias_index
+{
+	// same layout as SndIndexEntry
+	struct entry
+	{
+		unsigned short value;
+		unsigned short next;
+	};
+
+	constexpr unsigned short empty = 0xFFFF;
+
+	// open hash with chained overflow, matching the layout the game expects:
+	// every alias whose bucket (id % count) is free becomes that bucket's head, the rest are appended
+	// to the end of their bucket's chain in the free slot closest to the chain tail (ties go to the
+	// slot after the tail, the search wraps around). fills count entries of index and throws
+	// std::runtime_error when no slot is left
+	void build(const std::uint32_t* ids, std::uint32_t count, entry* index);
+}
@@ -3,6 +3,7 @@
 #include "gfximage.hpp"
 
 #include "zonetool/h1/assets/gfximage.hpp"
+#include "zonetool/utils/dump_writer.hpp"
 
 #pragma warning( push )
 #pragma warning( disable : 4459 )
@@ -119,6 +120,10 @@ namespace zonetool::iw7
 
 			void dump_streamed_image(zonetool::h1::GfxImage* image, bool is_self = false, bool dump_dds = false)
 			{
+				const std::string image_name = image->name;
+				const auto name = clean_name(image->name);
+				const auto parent_path = filesystem::get_dump_path() + "streamed_images\\";
+
 				const auto index = (*g_streamZoneMem)->streamed_image_index;
 				for (auto i = 0u; i < 4; i++)
 				{
@@ -151,55 +156,63 @@ namespace zonetool::iw7
 
 					if (compress_header.compressor != DB_COMPRESSOR_BLOCK) __debugbreak();
 
-					try
-					{
-						auto pixel_data = decompress_lz4_block(buffer.data() + sizeof(XFileCompressorHeader), buffer.size() - sizeof(XFileCompressorHeader));
-						const auto name = clean_name(image->name);
-
-						if (dump_dds)
-						{
-							DirectX::Image img = {};
-
-							img.width = image->streams[i].width;
-							img.height = image->streams[i].height;
-							img.pixels = reinterpret_cast<uint8_t*>(pixel_data.data());
-							img.format = DXGI_FORMAT(image->imageFormat);
+					const auto width = image->streams[i].width;
+					const auto height = image->streams[i].height;
+					const auto format = DXGI_FORMAT(image->imageFormat);
 
-							size_t row_pitch{};
-							size_t slice_pitch{};
+					// taken before buffer is moved into the task, the order arguments are evaluated in is unspecified
+					const auto buffer_size = buffer.size();
 
-							DirectX::ComputePitch(img.format, img.width, img.height, row_pitch, slice_pitch);
-
-							img.rowPitch = row_pitch;
-							img.slicePitch = slice_pitch;
+					// decompressing and writing happens on the writer pool so the loader thread isn't held up
+					dump_writer::enqueue(buffer_size, [=, buffer = std::move(buffer)]
+					{
+						try
+						{
+							auto pixel_data = decompress_lz4_block(buffer.data() + sizeof(XFileCompressorHeader), buffer.size() - sizeof(XFileCompressorHeader));
 
-							const auto parent_path = filesystem::get_dump_path() + "streamed_images\\";
-							const std::string spath = utils::string::va("%s\\%s_stream%i.dds", parent_path.data(),
-								name.data(), i);
-							const std::wstring wpath(spath.begin(), spath.end());
-							if (!std::filesystem::exists(parent_path))
+							if (dump_dds)
 							{
-								std::filesystem::create_directories(parent_path);
+								DirectX::Image img = {};
+
+								img.width = width;
+								img.height = height;
+								img.pixels = reinterpret_cast<uint8_t*>(pixel_data.data());
+								img.format = format;
+
+								size_t row_pitch{};
+								size_t slice_pitch{};
+
+								DirectX::ComputePitch(img.format, img.width, img.height, row_pitch, slice_pitch);
+
+								img.rowPitch = row_pitch;
+								img.slicePitch = slice_pitch;
+
+								const std::string spath = utils::string::va("%s\\%s_stream%i.dds", parent_path.data(),
+									name.data(), i);
+								const std::wstring wpath(spath.begin(), spath.end());
+								if (!std::filesystem::exists(parent_path))
+								{
+									std::filesystem::create_directories(parent_path);
+								}
+
+								auto result = DirectX::SaveToDDSFile(img, DirectX::DDS_FLAGS_NONE, wpath.data());
+								if (FAILED(result))
+								{
+									ZONETOOL_WARNING("Failed to dump image \"%s.dds\"", image_name.data());
+								}
 							}
-
-							auto result = DirectX::SaveToDDSFile(img, DirectX::DDS_FLAGS_NONE, wpath.data());
-							if (FAILED(result))
+							else
 							{
-								ZONETOOL_WARNING("Failed to dump image \"%s.dds\"", image->name);
+								std::string raw_path = utils::string::va("%s%s_stream%i.pixels", parent_path.data(), name.data(), i);
+								std::string pixel_data_str = std::string(pixel_data.begin(), pixel_data.end());
+								utils::io::write_file(raw_path, pixel_data_str, false);
 							}
 						}
-						else
+						catch (...)
 						{
-							std::string parent_path = filesystem::get_dump_path() + "streamed_images\\";
-							std::string raw_path = utils::string::va("%s%s_stream%i.pixels", parent_path.data(), name.data(), i);
-							std::string pixel_data_str = std::string(pixel_data.begin(), pixel_data.end());
-							utils::io::write_file(raw_path, pixel_data_str, false);
+							ZONETOOL_ERROR("Failed to dump streamed image \"%s\"", image_name.data());
 						}
-					}
-					catch (...)
-					{
-						ZONETOOL_ERROR("Failed to dump streamed image \"%s\"", image->name);
-					}
+					});
 				}
 
 				{
@@ -216,14 +229,9 @@ namespace zonetool::iw7
 				}
 			}
 
-			void dump_image_dds(zonetool::h1::GfxImage* image, zonetool::iw7::MapType maptype)
+			void save_image_dds(zonetool::h1::GfxImage* image, zonetool::iw7::MapType maptype,
+				const std::string& parent_path, const std::string& spath)
 			{
-				if (image->streamed)
-				{
-					dump_streamed_image(image, (*g_streamZoneMem)->streamed_images[(*g_streamZoneMem)->streamed_image_index].fileIndex == 431, true);
-					return;
-				}
-
 				auto* data = image->pixelData;
 				std::size_t data_used = 0;
 
@@ -281,8 +289,6 @@ namespace zonetool::iw7
 					mdata.miscFlags |= DirectX::TEX_MISC_FLAG::TEX_MISC_TEXTURECUBE;
 				}
 
-				std::string parent_path = filesystem::get_dump_path() + "images\\";
-				std::string spath = parent_path + clean_name(image->name) + ".dds";
 				std::wstring wpath(spath.begin(), spath.end());
 
 				if (!std::filesystem::exists(parent_path))
@@ -297,6 +303,38 @@ namespace zonetool::iw7
 				}
 			}
 
+			void dump_image_dds(zonetool::h1::GfxImage* image, zonetool::iw7::MapType maptype)
+			{
+				if (image->streamed)
+				{
+					dump_streamed_image(image, (*g_streamZoneMem)->streamed_images[(*g_streamZoneMem)->streamed_image_index].fileIndex == 431, true);
+					return;
+				}
+
+				if (!image->pixelData)
+				{
+					ZONETOOL_WARNING("Failed to dump image \"%s.dds\"", image->name);
+					return;
+				}
+
+				const auto parent_path = filesystem::get_dump_path() + "images\\";
+				const auto spath = parent_path + clean_name(image->name) + ".dds";
+
+				// the writer pool owns a copy of the pixels, the zone may be unloaded before it runs
+				std::string pixels(reinterpret_cast<const char*>(image->pixelData), image->dataLen1);
+				std::string name = image->name;
+
+				// taken before pixels is moved into the task, the order arguments are evaluated in is unspecified
+				const auto pixels_size = pixels.size();
+				dump_writer::enqueue(pixels_size, [image_copy = *image, maptype, pixels = std::move(pixels),
+					name = std::move(name), parent_path, spath]() mutable
+				{
+					image_copy.pixelData = reinterpret_cast<unsigned char*>(pixels.data());
+					image_copy.name = name.data();
+					save_image_dds(&image_copy, maptype, parent_path, spath);
+				});
+			}
+
 			static std::unordered_map<std::uint8_t, std::uint8_t> mapped_semantic =
 			{
 				{zonetool::iw7::TextureSemantic::TS_2D, zonetool::h1::IMG_TS::TS_2D},
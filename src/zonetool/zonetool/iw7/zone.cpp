@@ -2,6 +2,8 @@
 #include "zonetool.hpp"
 #include "zone.hpp"
 #include "zonetool/utils/utils.hpp"
+#include "zonetool/utils/imagefile.hpp"
+#include "zonetool/utils/image_budget.hpp"
 
 #include <utils/io.hpp>
 #include <utils/cryptography.hpp>
@@ -361,6 +363,9 @@ namespace zonetool::iw7
 
 			std::vector<std::thread> threads;
 
+			const auto codec = utils::string::va("iwc_block:%i:%llu", XBLOCK_COMPRESSION_LZ4, compression::iwc::MAX_BLOCK_SIZE);
+			zonetool::imagefile::cache::reset_stats();
+
 			const auto start_thread = [&](const int index, const int count)
 			{
 				threads.emplace_back([&, index, count]
@@ -376,10 +381,14 @@ namespace zonetool::iw7
 								continue;
 							}
 
-							auto block = utils::io::read_file(path.value());
-							const auto compressed = compression::iwc::compress_block(reinterpret_cast<std::uint8_t*>(block.data()), block.size(), XBLOCK_COMPRESSION_LZ4);
-							const std::string compressed_str = { compressed.begin(), compressed.end() };
-							image->image_stream_blocks[o].emplace(compressed_str);
+							auto compressed = zonetool::imagefile::cache::get_compressed_block(path.value(), codec, [](const std::string& block)
+							{
+								const auto compressed = compression::iwc::compress_block(
+									reinterpret_cast<const std::uint8_t*>(block.data()), block.size(), XBLOCK_COMPRESSION_LZ4);
+								return std::string{compressed.begin(), compressed.end()};
+							});
+
+							image->image_stream_blocks[o].emplace(std::move(compressed));
 						}
 					}
 				});
@@ -402,6 +411,8 @@ namespace zonetool::iw7
 					thread.join();
 				}
 			}
+
+			zonetool::imagefile::cache::print_stats();
 		}
 
 		void generate(const std::string& fastfile, std::uint16_t index, int ff_version, const std::string& ff_magic,
@@ -535,6 +546,42 @@ namespace zonetool::iw7
 			}
 		}
 
+		this->add_asset_by_pointer(type, pointer, name);
+	}
+
+	void zone_interface::add_assets_of_type_by_pointer(std::int32_t type, const std::vector<void*>& pointers)
+	{
+		// collect the existing names once, scanning m_assets for every entry is quadratic for large batches
+		std::unordered_set<std::string> names;
+		for (const auto& asset : m_assets)
+		{
+			if (asset->type() == type)
+			{
+				names.emplace(asset->name());
+			}
+		}
+
+		m_assets.reserve(m_assets.size() + pointers.size());
+
+		for (const auto pointer : pointers)
+		{
+			if (!pointer)
+			{
+				continue;
+			}
+
+			const std::string name = get_asset_name(XAssetType(type), pointer);
+			if (!names.emplace(name).second)
+			{
+				continue;
+			}
+
+			this->add_asset_by_pointer(type, pointer, name);
+		}
+	}
+
+	void zone_interface::add_asset_by_pointer(std::int32_t type, void* pointer, const std::string& name)
+	{
 #define ADD_ASSET_PTR(__type__, ___) \
 		if (type == __type__) \
 		{ \
@@ -566,7 +613,7 @@ namespace zonetool::iw7
 		}
 
 		// add ignore assets as referenced
-		if (ignore_assets.find(std::make_pair(static_cast<std::uint32_t>(type), name)) != ignore_assets.end())
+		if (ignore_assets.contains(static_cast<std::uint32_t>(type), name))
 		{
 			if (!name.starts_with(","))
 			{
@@ -981,6 +1028,8 @@ namespace zonetool::iw7
 		// pop stream
 		buf->pop_stream();
 
+		image_budget::report(this->name_);
+
 #ifdef DEBUG
 		// Dump zone to disk (for debugging)
 		buf->save("zonetool\\_debug\\" + this->name_ + ".zone", false);
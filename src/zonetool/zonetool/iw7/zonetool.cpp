@@ -2,9 +2,12 @@
 #include "zonetool.hpp"
 
 #include "converter/converter.hpp"
+#include "common/havok.hpp"
 
 #include "../utils/gsc.hpp"
 #include "../utils/csv_generator.hpp"
+#include "../utils/zone_source.hpp"
+#include "../utils/dump_writer.hpp"
 
 #include <utils/io.hpp>
 #include <utils/flags.hpp>
@@ -23,7 +26,7 @@ namespace zonetool::iw7
 	std::vector<std::pair<XAssetType, std::string>> referenced_assets;
 	std::unordered_set<XAssetType> asset_type_filter;
 
-	std::unordered_set<std::pair<std::uint32_t, std::string>, pair_hash<std::uint32_t, std::string>> ignore_assets;
+	asset_manifest::asset_set ignore_assets;
 
 	const char* get_asset_name(XAssetType type, void* pointer)
 	{
@@ -384,6 +387,11 @@ namespace zonetool::iw7
 
 		dump_refs();
 
+		// wait for images still being written by the dump writer pool
+		dump_writer::flush();
+
+		havok::binary::clear_dumped_blobs();
+
 		ZONETOOL_INFO("Zone \"%s\" dumped.", filesystem::get_fastfile().data());
 
 		globals.dump = false;
@@ -646,136 +654,84 @@ namespace zonetool::iw7
 
 	void parse_csv_file_ignore(const std::string& fastfile, const std::string& csv)
 	{
-		auto path = "zone_source\\" + csv + ".csv";
-		auto parser = csv::parser(path.data(), ',');
-
-		if (!parser.valid())
-		{
-			throw std::runtime_error(utils::string::va("Could not find csv file \"%s\"", csv.data()));
-		}
-
-		auto rows = parser.get_rows();
-		if (rows == nullptr)
+		const auto source = zone_source::get(csv);
+		if (!source)
 		{
-			return;
-		}
-
-		for (auto row_index = 0; row_index < parser.get_num_rows(); row_index++)
-		{
-			auto* row = rows[row_index];
-			if (row == nullptr)
+			// zones without a csv can still be ignored through their manifest
+			if (ignore_assets.add_manifest(csv))
 			{
-				continue;
-			}
-
-			if (!row->fields)
-			{
-				continue;
+				return;
 			}
 
-			if ((strlen(row->fields[0]) >= 1 && row->fields[0][0] == '#') || (strlen(row->fields[0]) >= 2 && row->
-				fields[0][0] == '/' && row->fields[0][1] == '/'))
-			{
-				// comment line, go to next line.
-				continue;
-			}
-			if (!strlen(row->fields[0]))
-			{
-				// empty line, go to next line.
-				continue;
-			}
+			throw std::runtime_error(utils::string::va("Could not find csv file \"%s\"", csv.data()));
+		}
 
-			if (row->num_fields < 2 || !is_valid_asset_type(row->fields[0]))
+		for (const auto& instruction : source->instructions)
+		{
+			if (instruction.num_fields() < 2 || !is_valid_asset_type(instruction.field(0)))
 			{
 				continue;
 			}
 
 			std::string name;
-			if ((!row->fields[1] || !strlen(row->fields[1]) && row->fields[2] && strlen(row->fields[2])))
+			if (instruction.field(1).empty() && !instruction.field(2).empty())
 			{
 				continue;
 			}
 			else
 			{
-				name = row->fields[1];
+				name = instruction.field(1);
 			}
 
-			const auto type = static_cast<std::uint32_t>(type_to_int(row->fields[0]));
-			ignore_assets.insert(std::make_pair(type, name));
+			const auto type = static_cast<std::uint32_t>(type_to_int(instruction.field(0)));
+			ignore_assets.insert(type, name);
 		}
 	}
 
 	void parse_csv_file(zone_base* zone, const std::string& fastfile, const std::string& csv)
 	{
-		auto path = "zone_source\\" + csv + ".csv";
-		auto parser = csv::parser(path.data(), ',');
-
-		if (!parser.valid())
+		const auto source = zone_source::get(csv);
+		if (!source)
 		{
 			throw std::runtime_error(utils::string::va("Could not find csv file \"%s\" to build zone!", csv.data()));
 		}
 
+		const zone_source::include_scope include_scope(csv);
+
 		auto is_referencing = false;
-		auto rows = parser.get_rows();
-		if (rows == nullptr)
-		{
-			return;
-		}
 
-		for (auto row_index = 0; row_index < parser.get_num_rows(); row_index++)
+		for (const auto& instruction : source->instructions)
 		{
-			auto* row = rows[row_index];
-			if (row == nullptr)
+			if (instruction.type == zone_source::instruction_type::require)
 			{
-				continue;
-			}
-
-			if (!row->fields)
-			{
-				continue;
-			}
-
-			if ((strlen(row->fields[0]) >= 1 && row->fields[0][0] == '#') || (strlen(row->fields[0]) >= 2 && row->
-				fields[0][0] == '/' && row->fields[0][1] == '/'))
-			{
-				// comment line, go to next line.
-				continue;
-			}
-			if (!strlen(row->fields[0]))
-			{
-				// empty line, go to next line.
-				continue;
-			}
-			if (row->fields[0] == "require"s)
-			{
-				load_zone(row->fields[1], DB_LOAD_ASYNC);
+				load_zone(instruction.field(1), DB_LOAD_ASYNC);
 				wait_for_database();
 			}
-			else if (row->fields[0] == "include"s)
+			else if (instruction.type == zone_source::instruction_type::include)
 			{
-				filesystem::get_search_paths().push_back("zonetool\\"s + row->fields[1] + "\\");
-				parse_csv_file(zone, fastfile, row->fields[1]);
+				filesystem::get_search_paths().push_back("zonetool\\"s + instruction.field(1) + "\\");
+				parse_csv_file(zone, fastfile, instruction.field(1));
 				filesystem::get_search_paths().pop_back();
 			}
-			else if (row->fields[0] == "ignore"s)
+			else if (instruction.type == zone_source::instruction_type::ignore)
 			{
-				parse_csv_file_ignore(fastfile, row->fields[1]);
+				parse_csv_file_ignore(fastfile, instruction.field(1));
 			}
 			// this allows us to reference assets instead of rewriting them
-			else if (row->fields[0] == "reference"s)
+			else if (instruction.type == zone_source::instruction_type::reference)
 			{
-				if (row->num_fields >= 2)
+				if (instruction.num_fields() >= 2)
 				{
-					is_referencing = row->fields[1] == "true"s;
+					is_referencing = instruction.field(1) == "true"s;
 				}
 			}
 			// this will use a directory iterator to automatically add assets
-			else if (row->fields[0] == "iterate"s)
+			else if (instruction.type == zone_source::instruction_type::iterate)
 			{
-				if (row->num_fields >= 2)
+				if (instruction.num_fields() >= 2)
 				{
-					auto type = row->fields[1];
-					auto iterate_all = row->fields[1] == "true"s;
+					auto type = instruction.field(1);
+					auto iterate_all = instruction.field(1) == "true"s;
 
 					try
 					{
@@ -803,49 +759,50 @@ namespace zonetool::iw7
 				}
 			}
 			// add paths
-			else if ((row->fields[0] == "addpath"s || row->fields[0] == "addpaths"s) && row->num_fields >= 2)
+			else if ((instruction.type == zone_source::instruction_type::addpath || instruction.type == zone_source::instruction_type::addpaths) &&
+				instruction.num_fields() >= 2)
 			{
-				bool insert_at_beginning = row->num_fields >= 3 && row->fields[2] == "true"s;
+				bool insert_at_beginning = instruction.num_fields() >= 3 && instruction.field(2) == "true"s;
 
-				if (row->fields[0] == "addpath"s)
-					filesystem::add_path(row->fields[1], insert_at_beginning);
+				if (instruction.type == zone_source::instruction_type::addpath)
+					filesystem::add_path(instruction.field(1), insert_at_beginning);
 				else
-					filesystem::add_paths_from_directory(row->fields[1], insert_at_beginning);
+					filesystem::add_paths_from_directory(instruction.field(1), insert_at_beginning);
 			}
 			// if entry is not an option, it should be an asset.
 			else
 			{
-				if (row->fields[0] == "localize"s && row->num_fields >= 2 &&
-					filesystem::file("localizedstrings/"s + row->fields[1] + ".str").exists())
+				if (instruction.field(0) == "localize"s && instruction.num_fields() >= 2 &&
+					filesystem::file("localizedstrings/"s + instruction.field(1) + ".str").exists())
 				{
-					localize::parse_localizedstrings_file(zone, row->fields[1]);
+					localize::parse_localizedstrings_file(zone, instruction.field(1));
 				}
-				else if (row->fields[0] == "localize"s && row->num_fields >= 2 &&
-					filesystem::file("localizedstrings/"s + row->fields[1] + ".json").exists())
+				else if (instruction.field(0) == "localize"s && instruction.num_fields() >= 2 &&
+					filesystem::file("localizedstrings/"s + instruction.field(1) + ".json").exists())
 				{
-					localize::parse_localizedstrings_json(zone, row->fields[1]);
+					localize::parse_localizedstrings_json(zone, instruction.field(1));
 				}
 				else
 				{
-					if (row->num_fields < 2 || !is_valid_asset_type(row->fields[0]))
+					if (instruction.num_fields() < 2 || !is_valid_asset_type(instruction.field(0)))
 					{
 						continue;
 					}
 
 					std::string name;
-					if ((!row->fields[1] || !strlen(row->fields[1]) && row->fields[2] && strlen(row->fields[2])))
+					if (instruction.field(1).empty() && !instruction.field(2).empty())
 					{
-						name = ","s + row->fields[2];
+						name = ","s + instruction.field(2);
 					}
 					else
 					{
-						name = ((is_referencing) ? ","s : ""s) + row->fields[1];
+						name = ((is_referencing) ? ","s : ""s) + instruction.field(1);
 					}
 
 					try
 					{
 						zone->add_asset_of_type(
-							row->fields[0],
+							instruction.field(0),
 							name
 						);
 					}
@@ -936,6 +893,7 @@ namespace zonetool::iw7
 		material::fixed_nml_images_map.clear();
 		techset::vertexdecl_pointers.clear();
 		//xanim_parts::secondary_anims.clear();
+		havok::binary::clear_zone_blobs();
 	}
 
 	void build_zone(const std::string& fastfile)
@@ -1155,6 +1113,12 @@ namespace zonetool::iw7
 			return gsc::iw7::gsc_ctx->token_name(id);
 		}));
 
+		::iw7::command::add("generatepackcsv", csv_generator::create_pack_command
+			<::iw7::command::params>([](const uint32_t id)
+		{
+			return gsc::iw7::gsc_ctx->token_name(id);
+		}));
+
 		::iw7::command::add("iteratezones", []()
 		{
 			iterate_zones();
@@ -7,10 +7,12 @@
 #pragma warning( pop )
 
 #include "zonetool/utils/iwi.hpp"
+#include "zonetool/utils/image_budget.hpp"
 
 #include "zonetool/utils/compression.hpp"
 
 #include <utils/cryptography.hpp>
+#include <utils/dds.hpp>
 #include <utils/flags.hpp>
 #include <utils/io.hpp>
 
@@ -112,6 +114,59 @@ namespace zonetool::s1
 		}
 	}
 
+	namespace dds
+	{
+		GfxImage* parse(const std::string& name, zone_memory* mem)
+		{
+			const auto path = utils::string::va("images\\%s.dds", clean_name(name).data());
+			const auto folder = filesystem::get_file_path(path);
+			if (folder.empty())
+			{
+				return nullptr;
+			}
+
+			// pixel data is copied straight from the mapped file, layouts that need a conversion go through directxtex
+			const utils::dds::file file(folder + path);
+			if (!file.is_valid())
+			{
+				return nullptr;
+			}
+
+			ZONETOOL_INFO("Parsing custom image \"%s\"", name.data());
+
+			const auto& info = file.get_info();
+			const auto pixels = file.get_payload();
+
+			auto* image = mem->allocate<GfxImage>();
+
+			image->imageFormat = static_cast<DXGI_FORMAT>(info.format);
+			image->mapType = static_cast<MapType>(info.dimension);
+			image->semantic = TS_COLOR_MAP; // material changes this
+			image->category = IMG_CATEGORY_LOAD_FROM_FILE;
+			image->width = static_cast<unsigned short>(info.width);
+			image->height = static_cast<unsigned short>(info.height);
+			image->depth = static_cast<unsigned short>(info.depth);
+			image->numElements = static_cast<unsigned short>(info.array_size);
+			image->levelCount = static_cast<unsigned char>(info.mip_levels);
+			image->streamed = 0;
+			image->dataLen1 = static_cast<int>(pixels.size());
+			image->dataLen2 = static_cast<int>(pixels.size());
+			image->pixelData = mem->allocate<unsigned char>(pixels.size());
+			std::memcpy(image->pixelData, pixels.data(), pixels.size());
+			image->name = mem->duplicate_string(name);
+
+			if (info.is_cubemap)
+			{
+				image->mapType = MAPTYPE_CUBE;
+				image->numElements = 1;
+			}
+
+			add_loaded_image_flags(image);
+
+			return image;
+		}
+	}
+
 	namespace directxtex
 	{
 		bool load_image(const std::string& name, DirectX::ScratchImage* image)
@@ -203,7 +258,12 @@ namespace zonetool::s1
 	GfxImage* gfx_image::parse_custom(const std::string& name, zone_memory* mem)
 	{
 		GfxImage* image = nullptr;
-		image = directxtex::parse(name, mem);
+		image = dds::parse(name, mem);
+		if (!image)
+		{
+			image = directxtex::parse(name, mem);
+		}
+
 		if (!image)
 		{
 			image = iwi::parse(name, mem);
@@ -246,9 +306,16 @@ namespace zonetool::s1
 		const auto image_path = utils::string::va("streamed_images\\%s_stream%i.dds",
 			clean_name(name).data(), stream);
 
+		const auto full_path = filesystem::get_file_path(image_path) + image_path;
+		const utils::dds::file file(full_path);
+		if (file.is_valid())
+		{
+			return {std::string{file.get_payload()}};
+		}
+
+		// legacy layouts that need a pixel conversion
 		DirectX::ScratchImage image{};
 
-		const auto full_path = filesystem::get_file_path(image_path) + image_path;
 		const auto full_path_w = utils::string::convert(full_path);
 		const auto result = DirectX::LoadFromDDSFile(full_path_w.data(), DirectX::DDS_FLAGS_NONE, nullptr, image);
 		if (!SUCCEEDED(result))
@@ -476,6 +543,8 @@ namespace zonetool::s1
 
 		buf->pop_stream();
 
+		image_budget::add_image(this->name(), data, this->image_stream_files);
+
 		if (data->streamed)
 		{
 			// add stream file to header
@@ -1,6 +1,8 @@
 #pragma once
 #include "../zonetool.hpp"
 
+#include "zonetool/utils/flac.hpp"
+
 namespace zonetool::s1
 {
 	class loaded_sound : public asset_interface
@@ -8,6 +10,7 @@ namespace zonetool::s1
 	private:
 		std::string name_;
 		LoadedSound* asset_ = nullptr;
+		std::optional<flac::patched_stream> flac_stream_;
 
 	public:
 		LoadedSound* parse_flac(const std::string& name, zone_memory* mem);
@@ -24,7 +27,7 @@ namespace zonetool::s1
 		std::int32_t type() override;
 		void write(zone_base* zone, zone_buffer* buffer) override;
 
-		static void dump_data(LoadedSound* asset, char* data, size_t size, const std::string& extension = "");
+		static void dump_data(LoadedSound* asset, const char* data, size_t size, const std::string& extension = "");
 		static void dump(LoadedSound* asset);
 	};
 }
\ No newline at end of file
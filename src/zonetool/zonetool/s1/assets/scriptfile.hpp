@@ -3,5 +3,5 @@
 
 namespace zonetool::s1
 {
-	REGISTER_TEMPLATED_ASSET(scriptfile, ScriptFile, ASSET_TYPE_SCRIPTFILE);
+	REGISTER_TEMPLATED_ASSET(scriptfile, ScriptFile, ASSET_TYPE_SCRIPTFILE, gsc_cache::game::s1);
 }
\ No newline at end of file
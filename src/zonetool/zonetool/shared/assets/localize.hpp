@@ -10,6 +10,48 @@ namespace zonetool
 		S* asset_ = nullptr;
 
 	public:
+		using localized_entry = std::pair<std::string, std::string>;
+
+		static void add_localized_entries(zone_base* zone, const std::vector<localized_entry>& entries, const std::string& path)
+		{
+			const auto type = zone->get_type_by_name("localize");
+			if (type == -1)
+			{
+				ZONETOOL_ERROR("Could not translate typename localize to an integer!");
+				return;
+			}
+
+			std::vector<S> localized(entries.size());
+			std::vector<void*> pointers(entries.size());
+			for (std::size_t i = 0; i < entries.size(); i++)
+			{
+				localized[i].name = entries[i].first.data();
+				localized[i].value = entries[i].second.data();
+				pointers[i] = &localized[i];
+			}
+
+			try
+			{
+				zone->add_assets_of_type_by_pointer(type, pointers);
+			}
+			catch (const std::exception& e)
+			{
+				ZONETOOL_FATAL("A fatal exception occured while adding localizedstrings from file: \"%s\", exception was: \n%s",
+					path.data(), e.what());
+			}
+		}
+
+		static void print_parse_stats(const std::string& path, const std::size_t count, const std::size_t size,
+			const std::chrono::high_resolution_clock::time_point start)
+		{
+			const auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+				std::chrono::high_resolution_clock::now() - start).count();
+			const auto seconds = static_cast<double>(std::max<long long>(duration, 1)) / 1000000.0;
+
+			ZONETOOL_INFO("Parsed %zu localizedstrings from \"%s\" in %.2f msec (%.2f MB/s)", count, path.data(),
+				seconds * 1000.0, (static_cast<double>(size) / (1024.0 * 1024.0)) / seconds);
+		}
+
 		static bool parse_localizedstrings_json(zone_base* zone, const std::string& file_name)
 		{
 			const auto path = "localizedstrings\\"s + file_name + ".json";
@@ -23,41 +65,32 @@ namespace zonetool
 				return false;
 			}
 
+			ZONETOOL_INFO("Parsing localizedstrings \"%s.json\"...", file_name.data());
+
+			const auto start = std::chrono::high_resolution_clock::now();
+
 			const auto size = file.size();
 			const auto bytes = file.read_bytes(size);
-			const auto localize = json::parse(bytes);
+			file.close();
 
-			ZONETOOL_INFO("Parsing localizedstrings \"%s.json\"...", file_name.data());
+			const auto localize = json::parse(bytes);
 			if (!localize.is_object())
 			{
 				ZONETOOL_ERROR("Localized strings json file should be an object!");
 				return false;
 			}
 
+			std::vector<localized_entry> entries;
+			entries.reserve(localize.size());
+
 			for (const auto& [key, value] : localize.items())
 			{
-				const auto value_str = value.get<std::string>();
-
-				S loc{};
-				loc.name = key.data();
-				loc.value = value_str.data();
-
-				auto type = zone->get_type_by_name("localize");
-				if (type == -1)
-				{
-					ZONETOOL_ERROR("Could not translate typename localize to an integer!");
-				}
-				try
-				{
-					zone->add_asset_of_type_by_pointer(type, &loc);
-				}
-				catch (const std::exception& e)
-				{
-					ZONETOOL_FATAL("A fatal exception occured while adding localizedstring: \"%s\" from file: \"%s\", exception was: \n%s",
-						key.data(), path.data(), e.what());
-				}
+				entries.emplace_back(key, value.get<std::string>());
 			}
 
+			add_localized_entries(zone, entries, path);
+			print_parse_stats(path, entries.size(), size, start);
+
 			return true;
 		}
 
@@ -68,161 +101,168 @@ namespace zonetool
 			file.open("rb");
 
 			auto* fp = file.get_fp();
-			if (fp)
+			if (!fp)
 			{
-				ZONETOOL_INFO("Parsing localizedstrings \"%s.str\"...", file_name.data());
+				return false;
+			}
 
-				auto bytes = file.read_bytes(file.size());
-				std::string str = std::string(bytes.begin(), bytes.end());
+			ZONETOOL_INFO("Parsing localizedstrings \"%s.str\"...", file_name.data());
 
-				std::stringstream stringstream(str);
-				std::string string;
+			const auto start = std::chrono::high_resolution_clock::now();
 
-				char* data;
-				size_t size = 0;
+			const auto bytes = file.read_bytes(file.size());
+			file.close();
 
-				bool failed = false;
-				std::string name;
-				std::string value;
-				size_t line = 0;
-				size_t i = 0;
-				while (getline(stringstream, string))
+			const std::string_view buffer(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+
+			std::vector<localized_entry> entries;
+
+			std::string name;
+			std::string value;
+			std::size_t line = 0;
+			std::size_t line_start = 0;
+
+			// walk the buffer line by line, keys are resolved by the zone in one batch at the end
+			while (line_start < buffer.size())
+			{
+				auto line_end = buffer.find('\n', line_start);
+				if (line_end == std::string_view::npos)
 				{
-					data = string.data();
-					size = string.size();
-					++line;
-					if (size < 2)
+					line_end = buffer.size();
+				}
+
+				const auto data = buffer.substr(line_start, line_end - line_start);
+				const auto size = data.size();
+				line_start = line_end + 1;
+				++line;
+
+				if (size < 2)
+				{
+					continue;
+				}
+
+				const auto at = [&](const std::size_t index)
+				{
+					return index < size ? data[index] : '\0';
+				};
+
+				auto failed = false;
+				std::size_t i = 0;
+				for (i = 0; i < size; i++)
+				{
+					if (at(i) == '/' && at(i + 1) == '/')
+					{
+						break;
+					}
+
+					if (isspace(static_cast<unsigned char>(at(i))))
+					{
+						continue;
+					}
+
+					if (at(i) < 'A' || at(i) > 'Z')
+					{
 						continue;
-					for (i = 0; i < size; i++)
+					}
+
+					const auto token = data.substr(i);
+					if (token.starts_with("REFERENCE"))
 					{
-						if (i + 1 < size && data[i] == '/' && data[i + 1] == '/')
+						i += 9;
+						while (isspace(static_cast<unsigned char>(at(i))))
+						{
+							i++;
+						}
+
+						const auto name_start = i;
+						while (i < size && !isspace(static_cast<unsigned char>(at(i))))
+						{
+							i++;
+						}
+
+						name.assign(data.substr(name_start, i - name_start));
+						break;
+					}
+
+					if (token.starts_with("LANG_"))
+					{
+						i += 5;
+						while (i < size && at(i) != '"')
+						{
+							i++;
+						}
+
+						if (i >= size)
+						{
+							failed = true;
 							break;
-						if (isspace(data[i]))
-							continue;
-						if (data[i] >= 'A' && data[i] <= 'Z')
+						}
+
+						i++;
+						value.clear();
+						while (at(i) != '"')
 						{
-							if (!strncmp(&data[i], "REFERENCE", 9))
+							if (i >= size)
 							{
-								i += 9;
-								while (isspace(data[i]))
-								{
-									if (i >= size)
-									{
-										failed = true;
-										break;
-									}
-									i++;
-								}
-								if (failed)
-								{
-									break;
-								}
-
-								name.clear();
-								while (!isspace(data[i]))
-								{
-									if (i >= size)
-									{
-										break;
-									}
-									name += data[i];
-									i++;
-								}
+								failed = true;
 								break;
 							}
-							if (!strncmp(&data[i], "LANG_", 5))
+
+							if (at(i) == '\\' && i + 1 < size)
 							{
-								i += 5;
-								while (data[i] != '"')
+								switch (at(i + 1))
 								{
-									if (i >= size)
-									{
-										failed = true;
-										break;
-									}
+								case 'n':
+									value += '\n';
+									i += 2;
+									break;
+								case 't':
+									value += '\t';
+									i += 2;
+									break;
+								default:
+									value += '\\';
 									i++;
-								}
-								if (failed)
-								{
 									break;
 								}
-
-								i++;
-								value.clear();
-								while (data[i] != '"')
-								{
-									if (i >= size)
-									{
-										failed = true;
-										break;
-									}
-									if (data[i] == '\\' && i + 1 < size)
-									{
-										switch (data[i + 1])
-										{
-										case 'n':
-											value += '\n';
-											i += 2;
-											break;
-										case 't':
-											value += '\t';
-											i += 2;
-											break;
-										default:
-											value += '\\';
-											i++;
-											break;
-										}
-									}
-									else
-									{
-										value += data[i];
-										i++;
-									}
-								}
-								break;
 							}
-							if (!strncmp(&data[i], "ENDMARKER", 9))
+							else
 							{
-								file.close();
-								return true;
+								value += at(i);
+								i++;
 							}
 						}
+						break;
 					}
-					if (failed)
+
+					if (token.starts_with("ENDMARKER"))
 					{
-						ZONETOOL_WARNING("\"%s\" parse failed at line: %zu index: %zu", path.data(), line, i);
-						file.close();
-						return false;
+						add_localized_entries(zone, entries, path);
+						print_parse_stats(path, entries.size(), buffer.size(), start);
+						return true;
 					}
-					if (!name.empty() && !value.empty())
-					{
-						S loc{};
-						loc.name = name.data();
-						loc.value = value.data();
+				}
 
-						auto type = zone->get_type_by_name("localize");
-						if (type == -1)
-						{
-							ZONETOOL_ERROR("Could not translate typename localize to an integer!");
-						}
-						try
-						{
-							zone->add_asset_of_type_by_pointer(type, &loc);
-						}
-						catch (std::exception& ex)
-						{
-							ZONETOOL_FATAL("A fatal exception occured while adding localizedstring: \"%s\" from file: \"%s\", exception was: \n%s",
-								name.data(), path.data(), ex.what());
-						}
-						name.clear();
-						value.clear();
-					}
+				if (failed)
+				{
+					// entries before the broken line are still added
+					add_localized_entries(zone, entries, path);
+					ZONETOOL_WARNING("\"%s\" parse failed at line: %zu index: %zu", path.data(), line, i);
+					return false;
+				}
+
+				if (!name.empty() && !value.empty())
+				{
+					entries.emplace_back(std::move(name), std::move(value));
+					name.clear();
+					value.clear();
 				}
-				file.close();
-				return true;
 			}
-			return false;
+
+			add_localized_entries(zone, entries, path);
+			print_parse_stats(path, entries.size(), buffer.size(), start);
+
+			return true;
 		}
 
 		S* parse(const std::string& name, zone_memory* mem)
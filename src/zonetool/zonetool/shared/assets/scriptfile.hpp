@@ -1,13 +1,16 @@
 #pragma once
 
+#include "../../utils/gsc_cache.hpp"
+
 namespace zonetool
 {
-	template <ASSET_TEMPLATE>
+	template <ASSET_TEMPLATE, gsc_cache::game Game>
 	class scriptfile : public asset_interface
 	{
 	private:
 		std::string name_;
 		S* asset_ = nullptr;
+		gsc_cache::pending_script pending_;
 
 	public:
 		S* parse(const std::string& name, zone_memory* mem)
@@ -16,7 +19,21 @@ namespace zonetool
 			file.open("rb");
 			if (!file.get_fp())
 			{
-				ZONETOOL_FATAL("Could not find scriptfile \"%s\"", name.data());
+				const auto source_name = utils::string::va("%s.gsc", name.data());
+				const auto source_path = filesystem::get_file_path(source_name);
+				if (source_path.empty())
+				{
+					ZONETOOL_FATAL("Could not find scriptfile \"%s\"", name.data());
+				}
+
+				ZONETOOL_INFO("Compiling scriptfile \"%s\"...", name.data());
+
+				// compiled on the gsc workers while the rest of the zone is parsed, picked up in prepare
+				auto* asset = mem->allocate<S>();
+				asset->name = mem->duplicate_string(name);
+				this->pending_ = gsc_cache::compile(Game, name, source_path + source_name);
+
+				return asset;
 			}
 
 			ZONETOOL_INFO("Parsing scriptfile \"%s\"...", name.data());
@@ -59,6 +76,35 @@ namespace zonetool
 
 		void prepare(zone_buffer* buf, zone_memory* mem) override
 		{
+			if (!this->pending_.valid())
+			{
+				return;
+			}
+
+			std::shared_ptr<const gsc_cache::script> script;
+
+			try
+			{
+				script = this->pending_.get();
+			}
+			catch (const std::exception& e)
+			{
+				ZONETOOL_FATAL("Failed to compile scriptfile \"%s\": %s", this->name_.data(), e.what());
+			}
+
+			auto* asset = this->asset_;
+			asset->compressedLen = static_cast<int>(script->buffer.size());
+			asset->len = static_cast<int>(script->len);
+			asset->bytecodeLen = static_cast<int>(script->bytecode.size());
+
+			auto* buffer = mem->allocate<char>(asset->compressedLen);
+			std::memcpy(buffer, script->buffer.data(), script->buffer.size());
+			asset->buffer = buffer;
+
+			asset->bytecode = mem->allocate<char>(asset->bytecodeLen);
+			std::memcpy(asset->bytecode, script->bytecode.data(), script->bytecode.size());
+
+			this->pending_ = {};
 		}
 
 		void load_depending(zone_base* zone) override
@@ -23,17 +23,55 @@ namespace zonetool
 			stringtable->columnCount = static_cast<int>(table.get_max_columns());
 			stringtable->values = mem->allocate<StringTableCell>(stringtable->rowCount * stringtable->columnCount);
 
+			const auto cell_count = static_cast<std::size_t>(stringtable->rowCount) * stringtable->columnCount;
+			if (cell_count == 0)
+			{
+				return stringtable;
+			}
+
+			// intern identical cells, the views point into the csv buffer which outlives this function
+			std::vector<std::string_view> unique_strings;
+			std::vector<std::uint32_t> cell_indices(cell_count);
+			std::unordered_map<std::string_view, std::uint32_t> string_indices;
+			std::size_t strings_size = 0;
+
 			auto rows = table.get_rows();
-			for (int row = 0; row < table.get_num_rows(); row++)
+			for (int row = 0; row < stringtable->rowCount; row++)
 			{
 				for (int col = 0; col < stringtable->columnCount; col++)
 				{
-					int entry = (row * stringtable->columnCount) + col;
-					stringtable->values[entry].string = mem->duplicate_string(col >= rows[row]->num_fields ? "" : rows[row]->fields[col]);
-					stringtable->values[entry].hash = string_table_hash(stringtable->values[entry].string);
+					const std::string_view value = col >= rows[row]->num_fields ? "" : rows[row]->fields[col];
+					const auto [itr, inserted] = string_indices.try_emplace(value, static_cast<std::uint32_t>(unique_strings.size()));
+					if (inserted)
+					{
+						unique_strings.emplace_back(value);
+						strings_size += value.size() + 1;
+					}
+
+					cell_indices[(row * stringtable->columnCount) + col] = itr->second;
 				}
 			}
 
+			std::vector<std::uint32_t> hashes(unique_strings.size());
+			string_table_hash_batch(unique_strings.data(), hashes.data(), unique_strings.size());
+
+			// copy every unique string into a single block straight from the csv buffer
+			auto* strings = mem->allocate<char>(strings_size);
+			std::vector<const char*> string_pointers(unique_strings.size());
+			for (std::size_t i = 0; i < unique_strings.size(); i++)
+			{
+				std::memcpy(strings, unique_strings[i].data(), unique_strings[i].size());
+				string_pointers[i] = strings;
+				strings += unique_strings[i].size() + 1;
+			}
+
+			for (std::size_t i = 0; i < cell_count; i++)
+			{
+				const auto index = cell_indices[i];
+				stringtable->values[i].string = string_pointers[index];
+				stringtable->values[i].hash = hashes[index];
+			}
+
 			return stringtable;
 		}
 
@@ -18,6 +18,15 @@ namespace zonetool
 
 		virtual void add_asset_of_type_by_pointer(std::int32_t type, void* pointer) = 0;
 
+		// adds many assets of one type at once, duplicates (by name) are skipped
+		virtual void add_assets_of_type_by_pointer(std::int32_t type, const std::vector<void*>& pointers)
+		{
+			for (const auto pointer : pointers)
+			{
+				this->add_asset_of_type_by_pointer(type, pointer);
+			}
+		}
+
 		virtual void add_asset_of_type(const std::string& type, const std::string& name) = 0;
 		virtual void add_asset_of_type(std::int32_t type, const std::string& name) = 0;
 		virtual std::int32_t get_type_by_name(const std::string& type) = 0;
@@ -1,14 +1,15 @@
 #include "std_include.hpp"
 #include "zonetool/utils/utils.hpp"
 #include "xpak.hpp"
+#include "xpak_format.hpp"
 
 #include "../structs.hpp"
 #include "../variables.hpp"
 
 #include "utils/io.hpp"
 #include "utils/string.hpp"
-
-#include "lz4.h"
+#include "utils/flags.hpp"
+#include "utils/mapped_file.hpp"
 
 namespace zonetool::t7
 {
@@ -16,62 +17,31 @@ namespace zonetool::t7
 	{
 		namespace
 		{
-#pragma pack(push, 1)
-			struct XPakSection
+			// one flat table over the hash sections of every pak, sorted by key. a key can live in
+			// several paks, lookups try each of them until the decompressed size matches
+			struct index_entry
 			{
-				int64_t itemCount;
-				int64_t offset;
-				int64_t size;
+				uint64_t key;
+				uint64_t offset;
+				uint64_t size;
+				uint32_t pak;
+				uint32_t padding;
 			};
 
-			struct XPakHeader
+			struct pak_info
 			{
-				uint32_t Magic;
-				uint16_t Unknown1;
-				uint16_t Version;
-				uint64_t Unknown2;
-				uint64_t Size;
-				uint64_t FileCount;
-				uint64_t DataOffset;
-				uint64_t DataSize;
-				uint64_t HashCount;
-				uint64_t HashOffset;
-				uint64_t HashSize;
-				uint64_t Unknown3;
-				uint64_t UnknownOffset;
-				uint64_t Unknown4;
-				uint64_t IndexCount;
-				uint64_t IndexOffset;
-				uint64_t IndexSize;
+				std::string path;
+				uint64_t file_size;
+				int64_t write_time;
 			};
 
-			struct XPakHashEntry
-			{
-				uint64_t Key;
-				uint64_t Offset;
-				uint64_t Size;
-			};
+			std::vector<pak_info> paks;
+			std::vector<index_entry> index_entries;
+			bool index_loaded = false;
 
-			struct XPakDataHeader
-			{
-				// Count and offset
-				uint32_t Count;
-				uint32_t Offset;
-
-				// The commands tell what each block of data does
-				uint32_t Commands[30];
-			};
-#pragma pack(pop)
-
-			struct PackageCacheObject
-			{
-				uint64_t Offset;
-				uint64_t CompressedSize;
-				uint64_t UncompressedSize;
-				std::string PackageFile;
-			};
-
-			std::unordered_map<std::string, std::unordered_map<uint64_t, PackageCacheObject>> xpak_cache_map;
+			// paks stay mapped until the cache is cleared
+			std::mutex pak_handles_mutex;
+			std::vector<std::unique_ptr<utils::mapped_file>> pak_handles;
 
 			namespace
 			{
@@ -90,224 +60,447 @@ namespace zonetool::t7
 				}
 			}
 
-			// this shit is so broken
-			std::vector<std::uint8_t> extract(const void* data, const size_t size, const size_t decompressedSize)
+			// max_threads 0 spreads big entries over every core, callers that already decode
+			// several entries at once pass 1
+			std::vector<std::uint8_t> decompress_xpak_data(const void* data, const size_t size, size_t decompressedSize,
+				const unsigned int max_threads = 0)
 			{
-				std::vector<std::uint8_t> out_buffer;
-				out_buffer.reserve(decompressedSize); // Reserve space to avoid frequent reallocations
+				try
+				{
+					std::vector<std::uint32_t> unknown_types;
+					auto result = format::extract(data, size, decompressedSize, max_threads, &unknown_types);
 
-				auto data_ptr = reinterpret_cast<const char*>(data);
-				auto data_end = data_ptr + size;
+					for (const auto type : unknown_types)
+					{
+						ZONETOOL_WARNING("Skipping xpak block with unknown type 0x%X", type);
+					}
+
+					return result;
+				}
+				catch (const std::exception& e)
+				{
+					ZONETOOL_WARNING("%s", e.what());
+					return {};
+				}
+			}
+
+			const utils::mapped_file* get_pak_handle(const uint32_t pak)
+			{
+				std::lock_guard _(pak_handles_mutex);
 
-				const auto write = [&](const void* data, const size_t len)
+				auto& handle = pak_handles[pak];
+				if (!handle)
 				{
-					const char* char_data = reinterpret_cast<const char*>(data);
-					for (size_t i = 0; i < len; i++)
+					handle = std::make_unique<utils::mapped_file>();
+					if (!handle->open(paks[pak].path))
 					{
-						out_buffer.push_back(static_cast<std::uint8_t>(char_data[i]));
+						ZONETOOL_ERROR("Failed to open xpak \"%s\"", paks[pak].path.data());
 					}
-				};
+				}
 
-				while (data_ptr < data_end)
+				return handle->is_open() ? handle.get() : nullptr;
+			}
+
+			void find_paks_in_directory(const std::string& path)
+			{
+				if (!std::filesystem::is_directory(path))
+				{
+					return;
+				}
+
+				for (auto const& dir_entry : std::filesystem::directory_iterator{ path })
 				{
-					if (data_ptr + sizeof(XPakDataHeader) > data_end)
+					if (dir_entry.is_regular_file() && dir_entry.path().extension() == ".xpak")
 					{
-						// Handle error: not enough data for header
-						break;
+						pak_info pak{};
+						pak.path = dir_entry.path().string();
+						pak.file_size = dir_entry.file_size();
+						pak.write_time = dir_entry.last_write_time().time_since_epoch().count();
+						paks.emplace_back(std::move(pak));
 					}
+				}
+			}
 
-					XPakDataHeader header{};
-					std::memcpy(&header, data_ptr, sizeof(XPakDataHeader));
-					data_ptr += sizeof(XPakDataHeader);
+			void add_pak_to_index(const uint32_t pak)
+			{
+				const auto* handle = get_pak_handle(pak);
+				if (!handle)
+				{
+					return;
+				}
 
-					if (header.Count > 30)
+				try
+				{
+					for (const auto& hash : format::read_hash_table(handle->data(), handle->size()))
 					{
-						// fucked up shit fuck
-						data_ptr -= sizeof(XPakDataHeader);
-						data_ptr++;
-						continue;
+						index_entries.emplace_back(index_entry{hash.key, hash.offset, hash.size, pak, 0});
 					}
+				}
+				catch (const std::exception& e)
+				{
+					ZONETOOL_WARNING("Skipping xpak \"%s\": %s", paks[pak].path.data(), e.what());
+				}
+			}
 
-					for (uint32_t i = 0; i < header.Count; i++)
-					{
-						// Unpack the command information
-						const size_t blockSize = (header.Commands[i] & 0xFFFFFF);
-						const size_t flag = (header.Commands[i] >> 24);
+			namespace index_cache
+			{
+				constexpr uint32_t index_cache_magic = 0x58444958; // "XIDX"
+				constexpr uint32_t index_cache_version = 1;
+				constexpr auto index_cache_path = "zonetool_cache\\xpak_index.bin";
 
-						std::string buffer;
+				struct index_cache_header
+				{
+					uint32_t magic;
+					uint32_t version;
+					uint64_t pak_count;
+					uint64_t entry_count;
+				};
 
-						switch (flag)
-						{
-						case 0x3: // compressed (lz4)
+				bool is_enabled()
+				{
+					static const auto enabled = !utils::flags::has_flag("no_xpak_index_cache");
+					return enabled;
+				}
+
+				// only valid while the exact same set of paks, with the same sizes and timestamps, is present
+				bool load()
+				{
+					std::string data;
+					if (!utils::io::read_file(index_cache_path, &data))
+					{
+						return false;
+					}
+
+					size_t pos = 0;
+					const auto read = [&](void* out, const size_t size)
+					{
+						if (size > data.size() - pos)
 						{
-							buffer.resize(0x10000);
-							const size_t decompressedResult = LZ4_decompress_safe(data_ptr, buffer.data(), static_cast<int>(blockSize), static_cast<int>(buffer.size()));
-							if (decompressedResult < 0 || decompressedResult > std::numeric_limits<std::uint32_t>::max())
-							{
-								// Handle decompression error
-								__debugbreak();
-							}
-							buffer.resize(decompressedResult);
-							break;
+							return false;
 						}
-						case 0x0: // raw data
+
+						std::memcpy(out, data.data() + pos, size);
+						pos += size;
+						return true;
+					};
+
+					index_cache_header header{};
+					if (!read(&header, sizeof(header)) || header.magic != index_cache_magic ||
+						header.version != index_cache_version || header.pak_count != paks.size())
+					{
+						return false;
+					}
+
+					for (const auto& pak : paks)
+					{
+						uint32_t path_len{};
+						if (!read(&path_len, sizeof(path_len)) || path_len != pak.path.size())
 						{
-							if (data_ptr + blockSize > data_end)
-							{
-								// Handle error: not enough data for block
-								break;
-							}
-							buffer.resize(blockSize);
-							std::memcpy(buffer.data(), data_ptr, blockSize);
-							break;
+							return false;
 						}
-						default:
+
+						std::string path(path_len, '\0');
+						uint64_t file_size{};
+						int64_t write_time{};
+						if (!read(path.data(), path_len) || !read(&file_size, sizeof(file_size)) || !read(&write_time, sizeof(write_time)) ||
+							path != pak.path || file_size != pak.file_size || write_time != pak.write_time)
 						{
-							data_ptr = data_end; // idk why this shit is so fucked
-							break;
-						}
+							return false;
 						}
+					}
 
-						data_ptr += blockSize;
-
-						write(buffer.data(), buffer.size());
+					if (header.entry_count > (data.size() - pos) / sizeof(index_entry))
+					{
+						return false;
 					}
 
-					//data_ptr = align_value(data_ptr, 0x80);
+					index_entries.resize(static_cast<size_t>(header.entry_count));
+					return read(index_entries.data(), index_entries.size() * sizeof(index_entry));
 				}
 
-				return out_buffer;
-			}
-
-			std::vector<std::uint8_t> decompress_xpak_data(std::string compressed_data, size_t decompressedSize)
-			{
-				try
-				{
-					return extract(compressed_data.data(), compressed_data.size(), decompressedSize);
-				}
-				catch (const std::exception& e)
+				void save()
 				{
-					ZONETOOL_FATAL("%s", e.what());
+					std::string data;
+					const auto write = [&](const void* value, const size_t size)
+					{
+						data.append(reinterpret_cast<const char*>(value), size);
+					};
+
+					const index_cache_header header{index_cache_magic, index_cache_version, paks.size(), index_entries.size()};
+					write(&header, sizeof(header));
+
+					for (const auto& pak : paks)
+					{
+						const auto path_len = static_cast<uint32_t>(pak.path.size());
+						write(&path_len, sizeof(path_len));
+						write(pak.path.data(), pak.path.size());
+						write(&pak.file_size, sizeof(pak.file_size));
+						write(&pak.write_time, sizeof(pak.write_time));
+					}
+
+					write(index_entries.data(), index_entries.size() * sizeof(index_entry));
+					utils::io::write_file(index_cache_path, data);
 				}
 			}
 
-			void populate_xpak_cache_internal(const std::string& pak_path)
+			void build_index()
 			{
-				if (xpak_cache_map.contains(pak_path)) return;
+				paks.clear();
+				index_entries.clear();
+				pak_handles.clear();
 
-				filesystem::file file(pak_path);
-				file.open("rb", false, false);
+				find_paks_in_directory("../zone/");
+				find_paks_in_directory("zone/");
 
-				if (!file.get_fp()) return;
+				pak_handles.resize(paks.size());
+				index_loaded = true;
 
-				XPakHeader header{};
-				file.read(&header);
+				if (index_cache::is_enabled() && index_cache::load())
+				{
+					return;
+				}
 
-				if (header.Magic != 0x4950414b)
+				index_entries.clear();
+				for (auto i = 0u; i < paks.size(); i++)
 				{
-					__debugbreak();
+					add_pak_to_index(i);
 				}
 
-				file.seek(header.HashOffset, SEEK_SET);
-				XPakHashEntry entry{};
+				std::stable_sort(index_entries.begin(), index_entries.end(), [](const index_entry& a, const index_entry& b)
+				{
+					return a.key < b.key;
+				});
 
-				for (uint64_t i = 0; i < header.HashCount; i++)
+				if (index_cache::is_enabled())
 				{
-					file.read(&entry);
+					index_cache::save();
+				}
+			}
 
-					// Prepare a cache entry
-					PackageCacheObject NewObject{};
-					// Set data
-					NewObject.Offset = header.DataOffset + entry.Offset;
-					NewObject.CompressedSize = entry.Size & 0xFFFFFFFFFFFFFF; // 0x80 in last 8 bits in some entries in new XPAKs
-					NewObject.UncompressedSize = 0;
-					NewObject.PackageFile = pak_path;
-					// Append to database
+			std::vector<index_entry>::const_iterator find_first_entry(const uint64_t key)
+			{
+				return std::lower_bound(index_entries.begin(), index_entries.end(), key, [](const index_entry& entry, const uint64_t key)
+				{
+					return entry.key < key;
+				});
+			}
+
+			std::vector<std::uint8_t> get_data(uint64_t key, const unsigned int expected_size)
+			{
+				for (auto iter = find_first_entry(key); iter != index_entries.end() && iter->key == key; ++iter)
+				{
+					const auto* handle = get_pak_handle(iter->pak);
+					if (!handle || iter->offset > handle->size() || iter->size > handle->size() - iter->offset)
+					{
+						continue;
+					}
 
-					xpak_cache_map[pak_path].insert(std::make_pair(entry.Key, NewObject));
+					auto data = decompress_xpak_data(handle->data() + iter->offset, static_cast<size_t>(iter->size), expected_size);
+					if (data.size() == expected_size)
+					{
+						return data;
+					}
 				}
 
-				file.close();
+				return {};
 			}
 
-			void populate_xpak_cache_iterator(const std::string& path)
+			namespace batch
 			{
-				if (!std::filesystem::is_directory(path))
+				// gaps smaller than this between two entries are read instead of seeking over them
+				constexpr uint64_t max_read_gap = 0x100000;
+				constexpr uint64_t max_read_size = 0x4000000;
+
+				struct pending_read
 				{
-					return;
+					const index_entry* entry;
+					unsigned int expected_size;
+					size_t request;
+				};
+
+				struct read_range
+				{
+					uint32_t pak;
+					uint64_t start;
+					uint64_t end;
+					std::vector<pending_read> reads;
+				};
+
+				std::mutex prefetched_mutex;
+				std::unordered_map<uint64_t, std::vector<std::uint8_t>> prefetched;
+
+				std::vector<read_range> build_ranges(std::vector<pending_read>& reads)
+				{
+					std::sort(reads.begin(), reads.end(), [](const pending_read& a, const pending_read& b)
+					{
+						return a.entry->pak != b.entry->pak ? a.entry->pak < b.entry->pak : a.entry->offset < b.entry->offset;
+					});
+
+					std::vector<read_range> ranges;
+					for (const auto& read : reads)
+					{
+						const auto* entry = read.entry;
+						const auto entry_end = entry->offset + entry->size;
+
+						if (!ranges.empty())
+						{
+							auto& range = ranges.back();
+							if (range.pak == entry->pak && entry->offset <= range.end + max_read_gap &&
+								std::max(range.end, entry_end) - range.start <= max_read_size)
+							{
+								range.end = std::max(range.end, entry_end);
+								range.reads.emplace_back(read);
+								continue;
+							}
+						}
+
+						ranges.emplace_back(read_range{entry->pak, entry->offset, entry_end, {read}});
+					}
+
+					return ranges;
 				}
 
-				for (auto const& dir_entry : std::filesystem::directory_iterator{ path })
+				void decode_range(const read_range& range, const char* buffer)
 				{
-					if (dir_entry.is_regular_file() && dir_entry.path().extension() == ".xpak")
+					std::atomic_size_t next_read{};
+
+					const auto decode = [&]
+					{
+						for (auto i = next_read++; i < range.reads.size(); i = next_read++)
+						{
+							const auto& read = range.reads[i];
+
+							// the entries of the range are already spread over the threads, decoding
+							// each one on more threads would multiply them
+							auto data = decompress_xpak_data(buffer + (read.entry->offset - range.start),
+								static_cast<size_t>(read.entry->size), read.expected_size, 1);
+							if (data.size() != read.expected_size)
+							{
+								// left for get_data, which also tries the key in other paks
+								continue;
+							}
+
+							std::lock_guard _(prefetched_mutex);
+							prefetched.try_emplace(read.entry->key, std::move(data));
+						}
+					};
+
+					const auto thread_count = std::min(range.reads.size(), static_cast<size_t>(std::max(1u, std::thread::hardware_concurrency())));
+
+					std::vector<std::thread> threads;
+					for (auto i = 1u; i < thread_count; i++)
 					{
-						const auto pakfile = dir_entry.path().string();
+						threads.emplace_back(decode);
+					}
 
-						populate_xpak_cache_internal(pakfile);
+					decode();
+
+					for (auto& thread : threads)
+					{
+						thread.join();
 					}
 				}
 			}
+		}
+
+		void prefetch(const std::vector<xpak_request>& requests, const prefetch_callback& consume)
+		{
+			if (requests.empty())
+			{
+				return;
+			}
 
-			void try_populate_xpak_cache_for_zone(const std::string& name)
+			if (!index_loaded)
 			{
-				auto pak_name = name + ".xpak";
-				auto pak_path = "zone/" + pak_name;
+				build_index();
+			}
 
-				if (!utils::io::file_exists(pak_path))
-				{
-					pak_path = "../" + pak_path;
-					if (!utils::io::file_exists(pak_path)) return;
-					//return;
-				}
+			std::vector<batch::pending_read> reads;
+			reads.reserve(requests.size());
 
-				populate_xpak_cache_internal(pak_path);
-			}
+			// keys that aren't in any pak still go through get_data_for_xpak_key, after everything else
+			std::vector<size_t> missing;
 
-			void populate_xpak_cache_for_loaded_zones()
+			for (auto i = 0u; i < requests.size(); i++)
 			{
-				int index = *g_zoneCount;
-				auto* zone = &g_zones[index];
-				auto zone_name = &g_zoneNames[index];
+				const auto& request = requests[i];
 
-				while (index > 0)
+				const auto iter = find_first_entry(request.key);
+				if (iter != index_entries.end() && iter->key == request.key)
 				{
-					try_populate_xpak_cache_for_zone(zone_name->name);
-
-					index--;
-					zone--;
-					zone_name--;
+					reads.emplace_back(batch::pending_read{&*iter, request.expected_size, i});
+				}
+				else
+				{
+					missing.emplace_back(i);
 				}
 			}
 
-			std::vector<std::uint8_t> get_data(uint64_t key, const unsigned int expected_size)
+			const auto ranges = batch::build_ranges(reads);
+
+			ZONETOOL_INFO("Prefetching %llu xpak entries in %llu reads...", reads.size(), ranges.size());
+
+			std::vector<size_t> chunk;
+			uint64_t chunk_bytes = 0;
+
+			const auto flush_chunk = [&]
 			{
-				for (auto& map : xpak_cache_map)
+				if (chunk.empty())
 				{
-					if (map.second.contains(key))
-					{
-						auto obj = map.second[key];
-						filesystem::file file(obj.PackageFile);
-						file.open("rb", false, false);
+					return;
+				}
 
-						if (!file.get_fp())
-						{
-							return {};
-						}
+				consume(chunk);
+				chunk.clear();
+				chunk_bytes = 0;
 
-						std::string buffer;
-						buffer.resize(obj.CompressedSize);
-						file.seek(obj.Offset, SEEK_SET);
-						file.read(buffer.data(), obj.CompressedSize);
+				// whatever the caller didn't take would only add up across chunks
+				std::lock_guard _(batch::prefetched_mutex);
+				batch::prefetched.clear();
+			};
 
-						auto data = decompress_xpak_data(buffer, expected_size);
-						if (data.size() == expected_size)
-						{
-							return data;
-						}
-					}
+			std::string buffer;
+			for (const auto& range : ranges)
+			{
+				uint64_t range_bytes = 0;
+				for (const auto& read : range.reads)
+				{
+					range_bytes += read.expected_size;
 				}
 
-				return {};
+				if (chunk_bytes + range_bytes > max_prefetch_bytes)
+				{
+					flush_chunk();
+				}
+
+				for (const auto& read : range.reads)
+				{
+					chunk.emplace_back(read.request);
+				}
+				chunk_bytes += range_bytes;
+
+				std::ifstream stream(paks[range.pak].path, std::ios::binary);
+				if (!stream.is_open())
+				{
+					continue;
+				}
+
+				buffer.resize(static_cast<size_t>(range.end - range.start));
+				stream.seekg(static_cast<std::streamoff>(range.start));
+				if (!stream.read(buffer.data(), static_cast<std::streamsize>(buffer.size())))
+				{
+					ZONETOOL_WARNING("Failed to read xpak \"%s\" at 0x%llX", paks[range.pak].path.data(), range.start);
+					continue;
+				}
+
+				batch::decode_range(range, buffer.data());
+			}
+
+			flush_chunk();
+
+			if (!missing.empty())
+			{
+				consume(missing);
 			}
 		}
 
@@ -329,22 +522,35 @@ namespace zonetool::t7
 				clear_cache();
 			}*/
 
-			if (xpak::xpak_cache_map.empty())
 			{
-				xpak::populate_xpak_cache_iterator("../zone/");
-				xpak::populate_xpak_cache_iterator("zone/");
+				std::lock_guard _(batch::prefetched_mutex);
 
-				//xpak::populate_xpak_cache_for_loaded_zones();
+				const auto iter = batch::prefetched.find(key);
+				if (iter != batch::prefetched.end() && iter->second.size() == expected_size)
+				{
+					auto data = std::move(iter->second);
+					batch::prefetched.erase(iter);
+					return data;
+				}
 			}
 
-			auto data = xpak::get_data(key, expected_size);
+			if (!index_loaded)
+			{
+				build_index();
+			}
 
-			return data;
+			return get_data(key, expected_size);
 		}
 
 		void clear_cache()
 		{
-			xpak::xpak_cache_map.clear();
+			paks.clear();
+			index_entries.clear();
+			pak_handles.clear();
+			index_loaded = false;
+
+			std::lock_guard _(batch::prefetched_mutex);
+			batch::prefetched.clear();
 		}
 	}
 }
\ No newline at end of file
@@ -4,7 +4,26 @@ namespace zonetool::t7
 {
 	namespace xpak
 	{
+		struct xpak_request
+		{
+			uint64_t key;
+			unsigned int expected_size;
+		};
+
 		std::vector<std::uint8_t> get_data_for_xpak_key(uint64_t key, const unsigned int expected_size);
+
+		// the most decoded data prefetch holds before handing a chunk to the caller
+		constexpr uint64_t max_prefetch_bytes = 0x20000000;
+
+		// receives the indices of the requests whose data is ready
+		using prefetch_callback = std::function<void(const std::vector<size_t>& requests)>;
+
+		// reads the requested keys in (pak, offset) order with coalesced reads and decodes them in parallel.
+		// every max_prefetch_bytes of decoded data the indices of the decoded requests are passed to consume,
+		// which gets them through get_data_for_xpak_key from memory. data it doesn't take is dropped after it returns.
+		// every request is passed to consume exactly once, keys missing from every pak come last
+		void prefetch(const std::vector<xpak_request>& requests, const prefetch_callback& consume);
+
 		void clear_cache();
 	}
 }
\ No newline at end of file
@@ -0,0 +1,271 @@
+#include <std_include.hpp>
+
+#include "xpak_format.hpp"
+
+#include "lz4.h"
+
+namespace zonetool::t7::xpak::format
+{
+	namespace
+	{
+#pragma pack(push, 1)
+		struct XPakHeader
+		{
+			uint32_t Magic;
+			uint16_t Unknown1;
+			uint16_t Version;
+			uint64_t Unknown2;
+			uint64_t Size;
+			uint64_t FileCount;
+			uint64_t DataOffset;
+			uint64_t DataSize;
+			uint64_t HashCount;
+			uint64_t HashOffset;
+			uint64_t HashSize;
+			uint64_t Unknown3;
+			uint64_t UnknownOffset;
+			uint64_t Unknown4;
+			uint64_t IndexCount;
+			uint64_t IndexOffset;
+			uint64_t IndexSize;
+		};
+
+		struct XPakHashEntry
+		{
+			uint64_t Key;
+			uint64_t Offset;
+			uint64_t Size;
+		};
+
+		struct XPakDataHeader
+		{
+			// Count and offset
+			uint32_t Count;
+			uint32_t Offset;
+
+			// The commands tell what each block of data does
+			uint32_t Commands[30];
+		};
+#pragma pack(pop)
+
+		// blocks to decode in parallel before spreading the work across threads is worth it
+		constexpr std::size_t min_parallel_blocks = 16;
+
+		void decode_block(data_block& block, char* out)
+		{
+			if (block.type != block_lz4)
+			{
+				return;
+			}
+
+			const auto result = LZ4_decompress_safe(block.data, out, static_cast<int>(block.size), static_cast<int>(max_block_size));
+			if (result < 0)
+			{
+				throw std::runtime_error("Failed to decompress xpak block");
+			}
+
+			block.output_size = static_cast<std::size_t>(result);
+		}
+	}
+
+	std::vector<hash_entry> read_hash_table(const void* data, const std::size_t size)
+	{
+		if (size < sizeof(XPakHeader))
+		{
+			throw std::runtime_error("file is too small for an xpak header");
+		}
+
+		XPakHeader header{};
+		std::memcpy(&header, data, sizeof(XPakHeader));
+
+		if (header.Magic != pak_magic)
+		{
+			throw std::runtime_error("invalid xpak header");
+		}
+
+		if (header.HashOffset > size || header.HashCount > (size - header.HashOffset) / sizeof(XPakHashEntry))
+		{
+			throw std::runtime_error("truncated hash table");
+		}
+
+		// the whole hash section is read in one go
+		std::vector<hash_entry> entries;
+		entries.reserve(static_cast<std::size_t>(header.HashCount));
+
+		const auto* hashes = reinterpret_cast<const char*>(data) + header.HashOffset;
+		for (uint64_t i = 0; i < header.HashCount; i++)
+		{
+			XPakHashEntry hash{};
+			std::memcpy(&hash, hashes + i * sizeof(XPakHashEntry), sizeof(XPakHashEntry));
+
+			hash_entry entry{};
+			entry.key = hash.Key;
+			entry.offset = header.DataOffset + hash.Offset;
+			entry.size = hash.Size & 0xFFFFFFFFFFFFFF; // 0x80 in last 8 bits in some entries in new XPAKs
+			entries.emplace_back(entry);
+		}
+
+		return entries;
+	}
+
+	std::vector<data_block> collect_blocks(const void* data, const std::size_t size, std::vector<std::uint32_t>* unknown_types)
+	{
+		std::vector<data_block> blocks;
+
+		auto* data_ptr = reinterpret_cast<const char*>(data);
+		const auto* data_end = data_ptr + size;
+
+		while (data_ptr < data_end)
+		{
+			if (static_cast<std::size_t>(data_end - data_ptr) < sizeof(XPakDataHeader))
+			{
+				// trailing padding
+				break;
+			}
+
+			XPakDataHeader header{};
+			std::memcpy(&header, data_ptr, sizeof(XPakDataHeader));
+
+			if (header.Count == 0 || header.Count > std::extent_v<decltype(header.Commands)>)
+			{
+				// padding or not a header, resync on the next byte
+				data_ptr++;
+				continue;
+			}
+
+			data_ptr += sizeof(XPakDataHeader);
+
+			for (uint32_t i = 0; i < header.Count; i++)
+			{
+				const std::size_t block_size = (header.Commands[i] & 0xFFFFFF);
+				const uint32_t type = (header.Commands[i] >> 24);
+
+				if (block_size > static_cast<std::size_t>(data_end - data_ptr))
+				{
+					throw std::runtime_error("Xpak block of size " + std::to_string(block_size) + " overruns its entry");
+				}
+
+				switch (type)
+				{
+				case block_raw:
+					blocks.emplace_back(data_block{data_ptr, block_size, type, block_size});
+					break;
+				case block_lz4:
+					blocks.emplace_back(data_block{data_ptr, block_size, type, 0});
+					break;
+				case block_skip:
+					break;
+				default:
+					if (unknown_types)
+					{
+						unknown_types->emplace_back(type);
+					}
+					break;
+				}
+
+				data_ptr += block_size;
+			}
+		}
+
+		return blocks;
+	}
+
+	std::vector<std::uint8_t> extract(const void* data, const std::size_t size, const std::size_t expected_size,
+		const unsigned int max_threads, std::vector<std::uint32_t>* unknown_types)
+	{
+		auto blocks = collect_blocks(data, size, unknown_types);
+
+		// lz4 blocks don't store their decompressed size, so they are decoded into fixed
+		// size slots first and packed into the output once every size is known
+		std::vector<std::size_t> slots(blocks.size());
+		std::size_t slot_count = 0;
+		for (auto i = 0u; i < blocks.size(); i++)
+		{
+			if (blocks[i].type == block_lz4)
+			{
+				slots[i] = slot_count++;
+			}
+		}
+
+		const auto scratch = std::make_unique<char[]>(slot_count * max_block_size);
+
+		std::mutex error_mutex;
+		std::exception_ptr error;
+		std::atomic_bool failed{};
+
+		const auto decode_range = [&](const std::size_t start, const std::size_t end)
+		{
+			try
+			{
+				for (auto i = start; i < end && !failed; i++)
+				{
+					decode_block(blocks[i], scratch.get() + slots[i] * max_block_size);
+				}
+			}
+			catch (...)
+			{
+				failed = true;
+
+				std::lock_guard _(error_mutex);
+				if (!error)
+				{
+					error = std::current_exception();
+				}
+			}
+		};
+
+		const auto thread_limit = max_threads ? max_threads : std::max(1u, std::thread::hardware_concurrency());
+		const auto thread_count = std::min(static_cast<std::size_t>(thread_limit), slot_count / min_parallel_blocks);
+		if (thread_count <= 1)
+		{
+			decode_range(0, blocks.size());
+		}
+		else
+		{
+			const auto blocks_per_thread = (blocks.size() + thread_count - 1) / thread_count;
+
+			std::vector<std::thread> threads;
+			for (std::size_t start = 0; start < blocks.size(); start += blocks_per_thread)
+			{
+				threads.emplace_back(decode_range, start, std::min(blocks.size(), start + blocks_per_thread));
+			}
+
+			for (auto& thread : threads)
+			{
+				thread.join();
+			}
+		}
+
+		if (error)
+		{
+			std::rethrow_exception(error);
+		}
+
+		std::size_t total_size = 0;
+		for (const auto& block : blocks)
+		{
+			total_size += block.output_size;
+		}
+
+		if (total_size != expected_size)
+		{
+			return {};
+		}
+
+		std::vector<std::uint8_t> out_buffer(total_size);
+
+		std::size_t offset = 0;
+		for (auto i = 0u; i < blocks.size(); i++)
+		{
+			const auto& block = blocks[i];
+			const auto* source = block.type == block_lz4
+				? scratch.get() + slots[i] * max_block_size
+				: block.data;
+
+			std::memcpy(out_buffer.data() + offset, source, block.output_size);
+			offset += block.output_size;
+		}
+
+		return out_buffer;
+	}
+}
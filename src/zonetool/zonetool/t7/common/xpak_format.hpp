@@ -0,0 +1,49 @@
+#pragma once
+
+// only depends on the standard library and lz4 so it can be built and tested on its own
+namespace zonetool::t7::xpak::format
+{
+	constexpr std::uint32_t pak_magic = 0x4950414b; // KAPI
+
+	// an entry of the hash table, the offset is from the start of the pak
+	struct hash_entry
+	{
+		std::uint64_t key;
+		std::uint64_t offset;
+		std::uint64_t size;
+	};
+
+	// reads the hash table of a mapped pak, throws std::runtime_error when the header
+	// is invalid or the table doesn't fit in the file
+	std::vector<hash_entry> read_hash_table(const void* data, std::size_t size);
+
+	enum block_type : std::uint32_t
+	{
+		block_raw = 0x0,
+		block_lz4 = 0x3,
+		block_skip = 0xCF,
+	};
+
+	// the most a single lz4 block decompresses to
+	constexpr std::size_t max_block_size = 0x10000;
+
+	struct data_block
+	{
+		const char* data;
+		std::size_t size;
+		std::uint32_t type;
+		std::size_t output_size; // 0 for lz4 blocks until they are decoded
+	};
+
+	// walks the command headers of an entry and collects its raw and lz4 blocks without decoding them.
+	// zero or oversized command counts are padding and skipped byte by byte, 0xCF blocks are dropped and
+	// blocks of any other type are dropped and their type added to unknown_types.
+	// throws std::runtime_error when a block runs past the end of the entry
+	std::vector<data_block> collect_blocks(const void* data, std::size_t size, std::vector<std::uint32_t>* unknown_types = nullptr);
+
+	// decodes an entry, lz4 blocks are spread over up to max_threads threads (0 for one per core).
+	// returns an empty buffer when the entry doesn't decode to expected_size, so the key can be tried in
+	// another pak. throws std::runtime_error on an overrunning or corrupt block
+	std::vector<std::uint8_t> extract(const void* data, std::size_t size, std::size_t expected_size,
+		unsigned int max_threads = 0, std::vector<std::uint32_t>* unknown_types = nullptr);
+}
@@ -19,6 +19,7 @@ namespace zonetool::t7
 
 	zonetool_globals_t globals{};
 	std::vector<std::pair<XAssetType, std::string>> referenced_assets;
+	std::vector<XAsset> streamed_meshes;
 	std::unordered_set<XAssetType> asset_type_filter;
 
 	std::unordered_set<std::pair<std::uint32_t, std::string>, pair_hash<std::uint32_t, std::string>> ignore_assets;
@@ -82,6 +83,17 @@ namespace zonetool::t7
 		return false;
 	}
 
+	bool is_streamed_mesh(XAsset* asset)
+	{
+		if (asset->type != ASSET_TYPE_XMODELMESH)
+		{
+			return false;
+		}
+
+		const auto* mesh = asset->header.modelMesh;
+		return mesh->shared && mesh->shared->dataSize && (mesh->shared->flags & 0x1) != 0;
+	}
+
 	bool is_referenced_asset(XAsset* asset)
 	{
 		if (get_asset_name(asset)[0] == ',')
@@ -266,6 +278,13 @@ namespace zonetool::t7
 			return;
 		}
 
+		// streamed meshes are dumped at the end of the zone so their xpak data can be read in one batch
+		if (is_streamed_mesh(asset))
+		{
+			streamed_meshes.emplace_back(*asset);
+			return;
+		}
+
 		const auto dump_func = dump_functions.find(globals.target_game);
 		if (dump_func == dump_functions.end())
 		{
@@ -321,6 +340,38 @@ namespace zonetool::t7
 		referenced_assets.clear();
 	}
 
+	void dump_streamed_meshes()
+	{
+		if (streamed_meshes.empty())
+		{
+			return;
+		}
+
+		std::vector<xpak::xpak_request> requests;
+		requests.reserve(streamed_meshes.size());
+
+		for (const auto& asset : streamed_meshes)
+		{
+			const auto* mesh = asset.header.modelMesh;
+			requests.emplace_back(xpak::xpak_request{mesh->xpakEntry.key, mesh->shared->dataSize});
+		}
+
+		const auto dump_func = dump_functions.find(globals.target_game);
+		if (dump_func != dump_functions.end())
+		{
+			// meshes are dumped chunk by chunk so only one chunk of decoded data is held at a time
+			xpak::prefetch(requests, [&](const std::vector<size_t>& chunk)
+			{
+				for (const auto i : chunk)
+				{
+					dump_func->second(&streamed_meshes[i]);
+				}
+			});
+		}
+
+		streamed_meshes.clear();
+	}
+
 	void stop_dumping()
 	{
 		globals.verify = false;
@@ -338,6 +389,7 @@ namespace zonetool::t7
 		}
 
 		dump_refs();
+		dump_streamed_meshes();
 
 		ZONETOOL_INFO("Zone \"%s\" dumped.", filesystem::get_fastfile().data());
 
@@ -0,0 +1,210 @@
+#include <std_include.hpp>
+
+#include "asset_manifest.hpp"
+#include "utils.hpp"
+
+#include <utils/io.hpp>
+#include <utils/string.hpp>
+
+namespace zonetool::asset_manifest
+{
+	namespace
+	{
+		constexpr std::uint32_t manifest_magic = 0x464D545A; // "ZTMF"
+		constexpr std::uint32_t manifest_version = 3;
+		constexpr auto manifest_folder = "zonetool_cache\\manifests\\";
+
+		struct header
+		{
+			std::uint32_t magic;
+			std::uint32_t version;
+			std::uint64_t count;
+			std::uint64_t zone_size;
+			std::int64_t zone_write_time;
+		};
+
+		// same folders iterate_zones goes through, a manifest is only valid for the zone file it was built from
+		bool get_zone_stamp(const std::string& zone, std::uint64_t& size, std::int64_t& write_time)
+		{
+			for (const auto* folder : {"zone/", "zone/english/", "", "english/"})
+			{
+				const std::filesystem::path path = utils::string::va("%s%s.ff", folder, zone.data());
+
+				std::error_code ec;
+				if (!std::filesystem::is_regular_file(path, ec))
+				{
+					continue;
+				}
+
+				size = std::filesystem::file_size(path, ec);
+				if (ec)
+				{
+					return false;
+				}
+
+				write_time = std::filesystem::last_write_time(path, ec).time_since_epoch().count();
+				return !ec;
+			}
+
+			return false;
+		}
+
+		bool compare_entries(const entry& a, const entry& b)
+		{
+			return a.type != b.type ? a.type < b.type : a.hash < b.hash;
+		}
+
+		bool equal_entries(const entry& a, const entry& b)
+		{
+			return a.type == b.type && a.hash == b.hash;
+		}
+	}
+
+	std::uint64_t hash_name(const std::string_view& name)
+	{
+		// fnv-1a
+		std::uint64_t hash = 0xCBF29CE484222325;
+
+		for (const auto c : name)
+		{
+			hash ^= static_cast<std::uint8_t>(c);
+			hash *= 0x100000001B3;
+		}
+
+		return hash;
+	}
+
+	std::string get_path(const std::string& zone)
+	{
+		return utils::string::va("%s%s.manifest", manifest_folder, zone.data());
+	}
+
+	bool exists(const std::string& zone)
+	{
+		return utils::io::file_exists(get_path(zone));
+	}
+
+	void builder::add(const std::uint32_t type, const std::string_view& name)
+	{
+		this->entries_.push_back({type, 0u, hash_name(name)});
+	}
+
+	bool builder::write(const std::string& zone)
+	{
+		std::sort(this->entries_.begin(), this->entries_.end(), compare_entries);
+		this->entries_.erase(std::unique(this->entries_.begin(), this->entries_.end(), equal_entries), this->entries_.end());
+
+		header manifest_header{manifest_magic, manifest_version, this->entries_.size(), 0u, 0};
+		if (!get_zone_stamp(zone, manifest_header.zone_size, manifest_header.zone_write_time))
+		{
+			ZONETOOL_WARNING("Zone file for \"%s\" not found, its manifest will not be checked for changes", zone.data());
+		}
+
+		std::string buffer;
+		buffer.reserve(sizeof(header) + this->entries_.size() * sizeof(entry));
+		buffer.append(reinterpret_cast<const char*>(&manifest_header), sizeof(header));
+		buffer.append(reinterpret_cast<const char*>(this->entries_.data()), this->entries_.size() * sizeof(entry));
+
+		return utils::io::write_file(get_path(zone), buffer);
+	}
+
+	std::size_t builder::size() const
+	{
+		return this->entries_.size();
+	}
+
+	std::unique_ptr<manifest> manifest::open(const std::string& zone)
+	{
+		auto result = std::make_unique<manifest>();
+		if (!result->file_.open(get_path(zone)) || result->file_.size() < sizeof(header))
+		{
+			return {};
+		}
+
+		const auto manifest_header = reinterpret_cast<const header*>(result->file_.data());
+		if (manifest_header->magic != manifest_magic || manifest_header->version != manifest_version ||
+			manifest_header->count > (result->file_.size() - sizeof(header)) / sizeof(entry))
+		{
+			ZONETOOL_WARNING("Manifest for zone \"%s\" is invalid, ignoring it", zone.data());
+			return {};
+		}
+
+		std::uint64_t zone_size{};
+		std::int64_t zone_write_time{};
+		if (manifest_header->zone_size && get_zone_stamp(zone, zone_size, zone_write_time) &&
+			(zone_size != manifest_header->zone_size || zone_write_time != manifest_header->zone_write_time))
+		{
+			ZONETOOL_WARNING("Manifest for zone \"%s\" is out of date, ignoring it", zone.data());
+			return {};
+		}
+
+		result->entries_ = reinterpret_cast<const entry*>(result->file_.data() + sizeof(header));
+		result->count_ = static_cast<std::size_t>(manifest_header->count);
+		return result;
+	}
+
+	bool manifest::contains(const std::uint32_t type, const std::uint64_t hash) const
+	{
+		const entry key{type, 0u, hash};
+		const auto end = this->entries_ + this->count_;
+		const auto iter = std::lower_bound(this->entries_, end, key, compare_entries);
+		return iter != end && equal_entries(*iter, key);
+	}
+
+	std::size_t manifest::size() const
+	{
+		return this->count_;
+	}
+
+	void asset_set::insert(const std::uint32_t type, const std::string_view& name)
+	{
+		this->entries_.insert(std::make_pair(type, hash_name(name)));
+	}
+
+	bool asset_set::add_manifest(const std::string& zone)
+	{
+		auto manifest = manifest::open(zone);
+		if (!manifest)
+		{
+			return false;
+		}
+
+		this->manifests_.emplace_back(std::move(manifest));
+		return true;
+	}
+
+	bool asset_set::contains(const std::uint32_t type, const std::string_view& name) const
+	{
+		if (this->empty())
+		{
+			return false;
+		}
+
+		const auto hash = hash_name(name);
+		if (this->entries_.contains(std::make_pair(type, hash)))
+		{
+			return true;
+		}
+
+		for (const auto& manifest : this->manifests_)
+		{
+			if (manifest->contains(type, hash))
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	bool asset_set::empty() const
+	{
+		return this->entries_.empty() && this->manifests_.empty();
+	}
+
+	void asset_set::clear()
+	{
+		this->entries_.clear();
+		this->manifests_.clear();
+	}
+}
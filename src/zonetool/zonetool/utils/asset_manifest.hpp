@@ -0,0 +1,64 @@
+#pragma once
+
+#include <utils/mapped_file.hpp>
+
+namespace zonetool::asset_manifest
+{
+	// asset names are matched exactly, like the (type, name) pairs ignore_assets used to store
+	std::uint64_t hash_name(const std::string_view& name);
+
+	struct entry
+	{
+		std::uint32_t type;
+		std::uint32_t padding;
+		std::uint64_t hash;
+	};
+
+	std::string get_path(const std::string& zone);
+	bool exists(const std::string& zone);
+
+	// collects the assets of a zone and writes them as a sorted (type, hash) table
+	class builder
+	{
+	public:
+		void add(std::uint32_t type, const std::string_view& name);
+		bool write(const std::string& zone);
+
+		std::size_t size() const;
+
+	private:
+		std::vector<entry> entries_;
+	};
+
+	// read-only manifest, mapped from disk and queried by binary search
+	class manifest
+	{
+	public:
+		static std::unique_ptr<manifest> open(const std::string& zone);
+
+		bool contains(std::uint32_t type, std::uint64_t hash) const;
+		std::size_t size() const;
+
+	private:
+		utils::mapped_file file_;
+		const entry* entries_ = nullptr;
+		std::size_t count_ = 0;
+	};
+
+	// set of (type, name) pairs used for ignored and common assets, backed by
+	// explicitly inserted names and any number of mapped manifests
+	class asset_set
+	{
+	public:
+		void insert(std::uint32_t type, const std::string_view& name);
+		bool add_manifest(const std::string& zone);
+
+		bool contains(std::uint32_t type, const std::string_view& name) const;
+		bool empty() const;
+		void clear();
+
+	private:
+		std::unordered_set<std::pair<std::uint32_t, std::uint64_t>, pair_hash<std::uint32_t, std::uint64_t>> entries_;
+		std::vector<std::unique_ptr<manifest>> manifests_;
+	};
+}
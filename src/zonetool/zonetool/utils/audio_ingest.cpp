@@ -0,0 +1,189 @@
+#include <std_include.hpp>
+
+#include "audio_ingest.hpp"
+
+#include <utils/io.hpp>
+
+#include <future>
+
+namespace zonetool::audio_ingest
+{
+	namespace
+	{
+		struct job
+		{
+			request sound;
+			std::promise<std::shared_ptr<sound_file>> promise;
+		};
+
+		std::mutex mutex;
+		std::unordered_map<std::string, std::shared_future<std::shared_ptr<sound_file>>> sounds;
+		std::vector<std::thread> workers;
+
+		void run_jobs(const std::shared_ptr<std::vector<job>>& jobs, const std::shared_ptr<std::atomic_size_t>& next_job)
+		{
+			for (auto i = (*next_job)++; i < jobs->size(); i = (*next_job)++)
+			{
+				auto& job = jobs->at(i);
+
+				try
+				{
+					const auto location = find_file(job.sound.name, *job.sound.paths);
+					job.promise.set_value(location.has_value() ? load_file(location.value()) : nullptr);
+				}
+				catch (...)
+				{
+					job.promise.set_exception(std::current_exception());
+				}
+			}
+		}
+	}
+
+	std::optional<std::string> find_path(const std::string& path, const std::vector<std::string>& paths)
+	{
+		for (const auto& search_path : paths)
+		{
+			auto full_path = search_path + path;
+			if (std::filesystem::is_regular_file(full_path))
+			{
+				return {std::move(full_path)};
+			}
+		}
+
+		// filesystem::file falls back to the working directory
+		if (std::filesystem::is_regular_file(path))
+		{
+			return {path};
+		}
+
+		return {};
+	}
+
+	std::optional<sound_location> find_file(const std::string& name, const std::vector<std::string>& paths)
+	{
+		const auto base_path = "loaded_sound\\"s + name;
+
+		const auto extension = std::filesystem::path(name).extension();
+		if (extension == ".wav" || extension == ".flac")
+		{
+			if (const auto path = find_path(base_path, paths))
+			{
+				return {{name.substr(0, name.size() - extension.string().size()), path.value()}};
+			}
+		}
+
+		for (const auto* ext : {".wav", ".flac"})
+		{
+			if (const auto path = find_path(base_path + ext, paths))
+			{
+				return {{name, path.value()}};
+			}
+		}
+
+		return {};
+	}
+
+	std::shared_ptr<sound_file> load_file(const sound_location& location)
+	{
+		auto result = std::make_shared<sound_file>();
+		result->name = location.name;
+		result->path = location.path;
+
+		if (!utils::io::read_file(location.path, &result->buffer))
+		{
+			throw std::runtime_error("Failed to read sound file \"" + location.path + "\"");
+		}
+
+		try
+		{
+			if (location.path.ends_with(".flac"))
+			{
+				result->flac.emplace(flac::patch_stream(result->buffer));
+			}
+			else
+			{
+				result->wave.emplace(wave::parse(result->buffer));
+			}
+		}
+		catch (const std::exception& e)
+		{
+			throw std::runtime_error(location.path + ": " + e.what());
+		}
+
+		return result;
+	}
+
+	void start(const std::vector<request>& requests)
+	{
+		std::lock_guard _(mutex);
+
+		auto jobs = std::make_shared<std::vector<job>>();
+		jobs->reserve(requests.size());
+
+		for (const auto& request : requests)
+		{
+			if (sounds.contains(request.name))
+			{
+				continue;
+			}
+
+			auto& job = jobs->emplace_back(audio_ingest::job{request, {}});
+			sounds.emplace(request.name, job.promise.get_future().share());
+		}
+
+		if (jobs->empty())
+		{
+			return;
+		}
+
+		const auto next_job = std::make_shared<std::atomic_size_t>();
+		const auto thread_count = std::min(jobs->size(), static_cast<std::size_t>(std::max(1u, std::thread::hardware_concurrency())));
+
+		for (auto i = 0u; i < thread_count; i++)
+		{
+			workers.emplace_back([jobs, next_job]
+			{
+				run_jobs(jobs, next_job);
+			});
+		}
+	}
+
+	std::shared_ptr<sound_file> take(const std::string& name)
+	{
+		std::shared_future<std::shared_ptr<sound_file>> sound;
+
+		{
+			std::lock_guard _(mutex);
+
+			const auto iter = sounds.find(name);
+			if (iter == sounds.end())
+			{
+				return {};
+			}
+
+			sound = std::move(iter->second);
+			sounds.erase(iter);
+		}
+
+		return sound.get();
+	}
+
+	void clear()
+	{
+		std::vector<std::thread> threads;
+
+		{
+			std::lock_guard _(mutex);
+			threads = std::move(workers);
+			workers.clear();
+		}
+
+		for (auto& thread : threads)
+		{
+			thread.join();
+		}
+
+		std::lock_guard _(mutex);
+		sounds.clear();
+	}
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "flac.hpp"
+#include "wave.hpp"
+
+namespace zonetool::audio_ingest
+{
+	struct sound_file
+	{
+		// asset name, without the extension when the csv named the file directly
+		std::string name;
+		std::string path;
+		std::string buffer;
+
+		std::optional<flac::patched_stream> flac;
+		std::optional<wave::wave_stream> wave;
+	};
+
+	struct sound_location
+	{
+		std::string name;
+		std::string path;
+	};
+
+	using search_paths = std::shared_ptr<const std::vector<std::string>>;
+
+	struct request
+	{
+		std::string name;
+		search_paths paths;
+	};
+
+	// same lookup as filesystem::file::open, with the given search paths instead of the current ones
+	std::optional<std::string> find_path(const std::string& path, const std::vector<std::string>& paths);
+
+	// resolves loaded_sound\<name>, <name>.wav and <name>.flac in the same order loaded_sound::parse does
+	std::optional<sound_location> find_file(const std::string& name, const std::vector<std::string>& paths);
+
+	// reads and validates or converts a sound file, throws std::runtime_error if it is broken
+	std::shared_ptr<sound_file> load_file(const sound_location& location);
+
+	// reads and converts the requested sounds on a worker pool while the zone is being assembled,
+	// each sound is resolved with the search paths that were active where the csv added it
+	void start(const std::vector<request>& requests);
+
+	// waits for a sound queued by start, nullptr if it was never queued or has no file.
+	// errors that happened on the worker are rethrown here
+	std::shared_ptr<sound_file> take(const std::string& name);
+
+	// waits for the workers and drops every sound that was never taken
+	void clear();
+}
@@ -205,6 +205,11 @@ namespace compression
 			const auto decompressed = decompress_lz4_block(data.data(), data.size());
 			return { decompressed.begin(), decompressed.end() };
 		}
+
+		std::string get_block_codec_id()
+		{
+			return utils::string::va("lz4hc_block:%d:%llu", LZ4_CLEVEL, MAX_BLOCK_SIZE);
+		}
 	}
 
 	std::vector<std::uint8_t> compress_lz4(const std::uint8_t* data, const std::size_t size)
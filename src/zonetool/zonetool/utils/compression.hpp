@@ -32,6 +32,8 @@ namespace compression
 		std::vector<std::uint8_t> decompress_lz4_block(const std::vector<std::uint8_t>& data);
 		std::vector<std::uint8_t> decompress_lz4_block(const std::vector<std::uint8_t>& data, const size_t size);
 		std::string decompress_lz4_block(const std::string& data);
+
+		std::string get_block_codec_id();
 	}
 
 	std::vector<std::uint8_t> compress_lz4(const std::uint8_t* data, const std::size_t size);
@@ -9,55 +9,74 @@ namespace csv
 {
 	int parser_raw::get_num_rows()
 	{
-		return this->raw_info.num_rows;
+		return static_cast<int>(this->row_ptrs_.size());
 	}
 
 	row** parser_raw::get_rows()
 	{
-		return this->raw_info.rows;
+		return this->row_ptrs_.empty() ? nullptr : this->row_ptrs_.data();
 	}
 
 	int parser_raw::get_max_columns()
 	{
 		int max_columns = 0;
-		if (this->raw_info.rows)
+		for (const auto& row : this->row_storage_)
 		{
-			for (int i = 0; i < this->raw_info.num_rows; i++)
+			if (max_columns < row.num_fields)
 			{
-				if (this->raw_info.rows[i])
-				{
-					if (max_columns < this->raw_info.rows[i]->num_fields)
-					{
-						max_columns = this->raw_info.rows[i]->num_fields;
-					}
-				}
+				max_columns = row.num_fields;
 			}
 		}
 		return max_columns;
 	}
 
-	std::vector<std::string> parser_raw::split_rows()
+	void parser_raw::tokenize()
 	{
-		std::vector<std::string> res;
-		std::string buffer;
-		std::string src = this->raw_info.buffer;
+		// single pass state machine, output never outgrows the input so fields are
+		// unescaped and null terminated in place (escapes shrink, quotes and \r are dropped)
+		const auto len = this->buffer_.size();
+		this->buffer_.push_back('\0');
+
+		auto* data = this->buffer_.data();
+		std::size_t write = 0;
+		std::size_t field_start = 0;
+		auto in_quote = false;
+		auto row_has_data = false;
+
+		this->row_offsets_.push_back(0);
 
-		for (std::size_t i = 0; i < src.size(); i++)
+		const auto end_field = [&]
 		{
-			const auto c = src[i];
-			if (c == '\\' && i + 1 < src.size())
+			this->field_offsets_.push_back(static_cast<std::uint32_t>(field_start));
+			data[write++] = '\0';
+			field_start = write;
+		};
+
+		const auto end_row = [&]
+		{
+			// a trailing empty field is not a field
+			if (write > field_start)
 			{
-				const auto cc = src[i + 1];
-				if (cc == 'n')
-				{
-					buffer.push_back('\n');
-					i++;
-					continue;
-				}
-				else if (cc == 't')
+				end_field();
+			}
+
+			this->row_offsets_.push_back(static_cast<std::uint32_t>(this->field_offsets_.size()));
+			field_start = write;
+			in_quote = false;
+			row_has_data = false;
+		};
+
+		for (std::size_t read = 0; read < len; read++)
+		{
+			auto c = data[read];
+			if (c == '\\' && read + 1 < len)
+			{
+				const auto next = data[read + 1];
+				if (next == 'n' || next == 't')
 				{
-					buffer.push_back('\t');
-					i++;
+					data[write++] = next == 'n' ? '\n' : '\t';
+					row_has_data = true;
+					read++;
 					continue;
 				}
 			}
@@ -66,117 +85,85 @@ namespace csv
 			{
 				continue;
 			}
-			else if (c == '\n')
+
+			if (c == '\n')
 			{
-				res.push_back(buffer);
-				buffer.clear();
+				end_row();
 				continue;
 			}
 
-			buffer.push_back(c);
-		}
+			row_has_data = true;
 
-		if (!buffer.empty())
-		{
-			res.push_back(buffer);
-		}
-
-		return res;
-	}
-
-	std::vector<std::string> parser_raw::split_fields(const std::string& src)
-	{
-		std::vector<std::string> res;
-		std::string buffer;
-		auto in_quote = false;
-
-		for (std::size_t i = 0; i < src.size(); i++)
-		{
-			const auto c = src[i];
 			if (c == '"')
 			{
 				in_quote = !in_quote;
-				continue;
 			}
-
-			if (c != ',' || in_quote)
+			else if (c == this->delimeter_ && !in_quote)
 			{
-				buffer.push_back(c);
+				end_field();
 			}
-			else if (c == ',' && !in_quote)
+			else
 			{
-				res.push_back(buffer);
-				buffer.clear();
+				data[write++] = c;
 			}
 		}
 
-		if (!buffer.empty())
+		if (row_has_data)
 		{
-			res.push_back(buffer);
+			end_row();
 		}
-
-		return res;
 	}
 
-	void parser_raw::parse()
+	void parser_raw::build_view()
 	{
-		auto split_rows = this->split_rows();
+		const auto num_rows = this->row_offsets_.size() - 1;
 
-		this->raw_info.num_rows = static_cast<int>(split_rows.size());
-		this->raw_info.rows = nullptr;
-		if (this->raw_info.num_rows)
+		this->field_ptrs_.resize(this->field_offsets_.size());
+		for (std::size_t i = 0; i < this->field_offsets_.size(); i++)
 		{
-			this->raw_info.rows = new csv::row * [this->raw_info.num_rows];
-			if (this->raw_info.rows)
-			{
-				for (int i = 0; i < this->raw_info.num_rows; i++)
-				{
-					this->raw_info.rows[i] = new csv::row;
-					if (this->raw_info.rows[i])
-					{
-						auto split_fields = this->split_fields(split_rows[i]);
-
-						this->raw_info.rows[i]->num_fields = static_cast<int>(split_fields.size());
-						this->raw_info.rows[i]->fields = nullptr;
-						if (this->raw_info.rows[i]->num_fields)
-						{
-							this->raw_info.rows[i]->fields = new char* [this->raw_info.rows[i]->num_fields];
-							if (this->raw_info.rows[i]->fields)
-							{
-								for (int j = 0; j < this->raw_info.rows[i]->num_fields; j++)
-								{
-									auto field_len = split_fields[j].size() + 1;
-									this->raw_info.rows[i]->fields[j] = new char[field_len];
-									memset(this->raw_info.rows[i]->fields[j], 0, field_len);
-									if (this->raw_info.rows[i]->fields[j])
-									{
-										strcpy_s(this->raw_info.rows[i]->fields[j], field_len, split_fields[j].data());
-										this->raw_info.rows[i]->fields[j][field_len - 1] = '\0';
-									}
-								}
-							}
-						}
-					}
-				}
-			}
+			this->field_ptrs_[i] = this->buffer_.data() + this->field_offsets_[i];
+		}
+
+		this->row_storage_.resize(num_rows);
+		this->row_ptrs_.resize(num_rows);
+		for (std::size_t i = 0; i < num_rows; i++)
+		{
+			const auto first = this->row_offsets_[i];
+			const auto count = this->row_offsets_[i + 1] - first;
+
+			auto& row = this->row_storage_[i];
+			row.num_fields = static_cast<int>(count);
+			row.fields = count ? this->field_ptrs_.data() + first : nullptr;
+
+			this->row_ptrs_[i] = &row;
 		}
 	}
 
-	parser_raw::parser_raw(const char* data, int data_len, char delimeter)
+	void parser_raw::parse()
 	{
-		this->raw_info = { 0 };
+		this->tokenize();
+		this->build_view();
+	}
 
-		if (data)
-		{
-			this->raw_info.buffer = const_cast<char*>(data);
-			this->raw_info.buffer_len = data_len;
-		}
-		else
+	parser_raw::parser_raw(const char* data, int data_len, char delimeter)
+	{
+		if (!data)
 		{
 			throw std::runtime_error("CSV: Data is invalid!");
 		}
 
-		this->raw_info.delimeter = delimeter;
+		// the buffer is treated as a c string, stop at the first terminator
+		this->buffer_.assign(data, strnlen(data, static_cast<std::size_t>(std::max(data_len, 0))));
+		this->delimeter_ = delimeter;
+
+		this->parse();
+	}
+
+	parser_raw::parser_raw(std::string&& data, char delimeter)
+	{
+		this->buffer_ = std::move(data);
+		this->buffer_.resize(strnlen(this->buffer_.data(), this->buffer_.size()));
+		this->delimeter_ = delimeter;
 
 		this->parse();
 	}
@@ -188,25 +175,7 @@ namespace csv
 
 	parser_raw::~parser_raw()
 	{
-		for (int i = 0; i < this->raw_info.num_rows; i++)
-		{
-			if (this->raw_info.rows[i])
-			{
-				if (this->raw_info.rows[i]->fields)
-				{
-					for (int j = 0; j < this->raw_info.rows[i]->num_fields; j++)
-					{
-						if (this->raw_info.rows[i]->fields[j])
-						{
-							delete[] this->raw_info.rows[i]->fields[j];
-						}
-					}
-					delete[] this->raw_info.rows[i]->fields;
-				}
-				delete this->raw_info.rows[i];
-			}
-		}
-		delete[] this->raw_info.rows;
+
 	}
 
 	bool parser::valid()
@@ -253,7 +222,6 @@ namespace csv
 	{
 		this->clear_buffers();
 		this->info.file_path = path_buffer;
-		this->info.buffer = nullptr;
 
 		if (!path.size())
 		{
@@ -272,22 +240,14 @@ namespace csv
 			throw std::runtime_error(utils::string::va("CSV: Failed to open file \"%s\" for read!", path.data()));
 		}
 
-		int buffer_len = 0;
-		auto len = file_len(this->info.fp);
-		buffer_len = len * sizeof(char) + 1;
-		this->info.buffer = reinterpret_cast<char*>(malloc(buffer_len));
-
-		if (this->info.buffer != NULL)
-		{
-			memset(this->info.buffer, 0, buffer_len * sizeof(char));
-			fread(this->info.buffer, len, 1, this->info.fp);
-		}
-		else
+		std::string buffer;
+		buffer.resize(static_cast<std::size_t>(file_len(this->info.fp)));
+		if (!buffer.empty())
 		{
-			throw std::runtime_error("CSV: Couldn't allocate memory for file buffer!");
+			fread(buffer.data(), buffer.size(), 1, this->info.fp);
 		}
 
-		this->raw = new parser_raw(this->info.buffer, buffer_len, delimeter);
+		this->raw = new parser_raw(std::move(buffer), delimeter);
 	}
 
 	parser::~parser()
@@ -297,11 +257,6 @@ namespace csv
 			fclose(this->info.fp);
 		}
 
-		if (this->info.buffer != NULL)
-		{
-			free(this->info.buffer);
-		}
-
 		delete this->raw;
 	}
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -11,39 +12,42 @@ namespace csv
 		int num_fields;
 	};
 
-	struct parser_info_raw
-	{
-		char* buffer;
-		int buffer_len;
-		char delimeter;
-		row** rows;
-		int num_rows;
-	};
-
 	class parser_raw
 	{
 	private:
-		parser_info_raw raw_info{};
+		// fields are null terminated in place inside buffer, rows index into field_offsets
+		std::string buffer_;
+		char delimeter_ = ',';
+		std::vector<std::uint32_t> field_offsets_;
+		std::vector<std::uint32_t> row_offsets_;
+
+		// compatibility view for the row** interface
+		std::vector<char*> field_ptrs_;
+		std::vector<row> row_storage_;
+		std::vector<row*> row_ptrs_;
 
 	public:
 		parser_raw(const char* data, int data_len, char delimeter = ',');
+		parser_raw(std::string&& data, char delimeter = ',');
 		parser_raw();
 		~parser_raw();
 
+		parser_raw(const parser_raw&) = delete;
+		parser_raw& operator=(const parser_raw&) = delete;
+
 		int get_num_rows();
 		row** get_rows();
 		int get_max_columns();
 
 	private:
-		std::vector<std::string> split_rows();
-		std::vector<std::string> split_fields(const std::string& src);
+		void tokenize();
+		void build_view();
 
 		void parse();
 	};
 
 	struct parser_info
 	{
-		char* buffer;
 		char* file_path;
 		FILE* fp;
 	};
@@ -10,333 +10,797 @@ namespace csv_generator
 {
 	namespace
 	{
-		std::unordered_set<std::string> parse_create_fx_gsc(const std::string& data)
+		enum class token_type
 		{
-			std::unordered_set<std::string> sounds;
-			std::regex pattern("\\w+\\.v\\[\\s*\"soundalias\"\\s*\\]\\s*=\\s*\"([\\w\\s]+?)\"", std::regex_constants::icase);
-			std::smatch matches;
+			identifier,
+			string,
+			number,
+			punctuation,
+		};
 
-			auto search_start = data.cbegin();
-			while (std::regex_search(search_start, data.cend(), matches, pattern))
-			{
-				sounds.insert(matches[1].str());
-				search_start = matches.suffix().first;
-			}
+		struct token
+		{
+			token_type type;
+			std::string_view value;
+		};
 
-			return sounds;
+		bool is_ident_start(const char c)
+		{
+			return std::isalpha(static_cast<unsigned char>(c)) || c == '_';
 		}
 
-		std::unordered_set<std::string> parse_fx_gsc(const std::string& data)
+		bool is_ident_char(const char c)
 		{
-			std::unordered_set<std::string> effects;
-			std::regex pattern("loadfx\\s*\\(\\s*\"([^\"]+)\"\\s*\\);", std::regex_constants::icase);
-			std::smatch matches;
+			return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+		}
 
-			auto search_start = data.cbegin();
-			while (std::regex_search(search_start, data.cend(), matches, pattern))
+		bool equals_icase(const std::string_view& a, const std::string_view& b)
+		{
+			if (a.size() != b.size())
 			{
-				effects.insert(matches[1].str());
-				search_start = matches.suffix().first;
+				return false;
 			}
 
-			return effects;
+			for (auto i = 0u; i < a.size(); i++)
+			{
+				if (std::tolower(static_cast<unsigned char>(a[i])) != std::tolower(static_cast<unsigned char>(b[i])))
+				{
+					return false;
+				}
+			}
+
+			return true;
 		}
-	}
 
-	void generate_map_csv(const std::string& map, const mapents::token_name_callback& get_token_name, bool is_sp)
-	{
-		const auto root_dir = "zonetool/" + map;
-		if (!utils::io::directory_exists(root_dir))
+		// splits a gsc file into identifiers, string literals, numbers and single-char punctuation,
+		// skipping whitespace and comments. string tokens hold the raw text between the quotes
+		std::vector<token> tokenize_gsc(const std::string_view& data)
 		{
-			ZONETOOL_ERROR("Zonetool map directory \"%s\" does not exist", map.data());
-			return;
-		}
+			std::vector<token> tokens;
+			tokens.reserve(data.size() / 4);
 
-		const auto map_prefix = map.starts_with("mp_")
-			? "maps/mp"s
-			: "maps"s;
-		const auto map_prefix_full = root_dir + "/" + map_prefix + "/";
-		const auto mapents_path = map_prefix_full + map + ".d3dbsp.ents";
+			const auto size = data.size();
+			std::size_t pos = 0;
+			while (pos < size)
+			{
+				const auto c = data[pos];
 
-		std::string mapents_data;
-		if (!utils::io::read_file(mapents_path, &mapents_data))
-		{
-			ZONETOOL_ERROR("Missing mapents");
-			return;
-		}
+				if (std::isspace(static_cast<unsigned char>(c)))
+				{
+					pos++;
+					continue;
+				}
+
+				if (c == '/' && pos + 1 < size && data[pos + 1] == '/')
+				{
+					const auto end = data.find('\n', pos);
+					pos = end == std::string_view::npos ? size : end + 1;
+					continue;
+				}
 
-		ZONETOOL_INFO("Generating CSV for map \"%s\"", map.data());
+				if (c == '/' && pos + 1 < size && data[pos + 1] == '*')
+				{
+					const auto end = data.find("*/", pos + 2);
+					pos = end == std::string_view::npos ? size : end + 2;
+					continue;
+				}
 
-		std::string csv;
+				if (c == '"')
+				{
+					const auto start = ++pos;
+					while (pos < size && data[pos] != '"' && data[pos] != '\n')
+					{
+						pos += data[pos] == '\\' ? 2 : 1;
+					}
+
+					pos = std::min(pos, size);
+					tokens.push_back({token_type::string, data.substr(start, pos - start)});
+					pos++;
+					continue;
+				}
 
-		const auto add_str = [&](const std::string& str)
+				if (is_ident_start(c))
+				{
+					const auto start = pos;
+					while (pos < size && is_ident_char(data[pos]))
+					{
+						pos++;
+					}
+
+					tokens.push_back({token_type::identifier, data.substr(start, pos - start)});
+					continue;
+				}
+
+				if (std::isdigit(static_cast<unsigned char>(c)))
+				{
+					const auto start = pos;
+					while (pos < size && (is_ident_char(data[pos]) || data[pos] == '.'))
+					{
+						pos++;
+					}
+
+					tokens.push_back({token_type::number, data.substr(start, pos - start)});
+					continue;
+				}
+
+				tokens.push_back({token_type::punctuation, data.substr(pos, 1)});
+				pos++;
+			}
+
+			return tokens;
+		}
+
+		// keeps the first-seen order so generated csvs are stable between runs
+		class reference_list
 		{
-			csv.append(str);
+		public:
+			void add(const std::string_view& name)
+			{
+				std::string value{name};
+				if (this->added_.insert(value).second)
+				{
+					this->names_.emplace_back(std::move(value));
+				}
+			}
+
+			const std::vector<std::string>& get() const
+			{
+				return this->names_;
+			}
+
+		private:
+			std::vector<std::string> names_;
+			std::unordered_set<std::string> added_;
 		};
 
-		const auto add_line = [&](const std::string& line)
+		struct gsc_references
 		{
-			add_str(line);
-			add_str("\n");
+			reference_list effects;
+			reference_list sounds;
+			reference_list models;
+			reference_list materials;
 		};
 
-		const auto add_asset = [&](const std::string& type, const std::string& name)
+		bool is_sound_alias_name(const std::string_view& name)
 		{
-			ZONETOOL_INFO("Adding %s \"%s\"", type.data(), name.data());
-			add_line(utils::string::va("%s,%s", type.data(), name.data()));
-		};
+			if (name.empty())
+			{
+				return false;
+			}
+
+			for (const auto c : name)
+			{
+				if (!is_ident_char(c) && !std::isspace(static_cast<unsigned char>(c)))
+				{
+					return false;
+				}
+			}
 
-		add_line("// Generated by x64-ZoneTool\n");
+			return true;
+		}
 
-		if (!is_sp)
+		// scans the token stream once for:
+		//   loadfx( "name" )
+		//   <ent>.v[ "soundalias" ] = "name"
+		//   precachemodel( "name" )
+		//   precacheshader( "name" ) / precachematerial( "name" )
+		void scan_gsc(const std::string_view& data, gsc_references& refs)
 		{
-			add_line("// netconststrings");
-			add_asset("netconststrings", utils::string::va("ncs_%s_level", "mdl"));
-			add_asset("netconststrings", utils::string::va("ncs_%s_level", "mat"));
-			add_asset("netconststrings", utils::string::va("ncs_%s_level", "rmb"));
-			add_asset("netconststrings", utils::string::va("ncs_%s_level", "veh"));
-			add_asset("netconststrings", utils::string::va("ncs_%s_level", "vfx"));
-			add_asset("netconststrings", utils::string::va("ncs_%s_level", "loc"));
-			add_asset("netconststrings", utils::string::va("ncs_%s_level", "snd"));
-			add_asset("netconststrings", utils::string::va("ncs_%s_level", "sbx"));
-			add_asset("netconststrings", utils::string::va("ncs_%s_level", "snl"));
-			add_asset("netconststrings", utils::string::va("ncs_%s_level", "shk"));
-			add_asset("netconststrings", utils::string::va("ncs_%s_level", "mnu"));
-			add_asset("netconststrings", utils::string::va("ncs_%s_level", "tag"));
-			add_asset("netconststrings", utils::string::va("ncs_%s_level", "hic"));
-			add_asset("netconststrings", utils::string::va("ncs_%s_level", "nps"));
-			add_asset("netconststrings", utils::string::va("ncs_%s_level", "mic"));
-			add_asset("netconststrings", utils::string::va("ncs_%s_level", "sel"));
-			add_asset("netconststrings", utils::string::va("ncs_%s_level", "wep"));
-			add_asset("netconststrings", utils::string::va("ncs_%s_level", "att"));
-			add_asset("netconststrings", utils::string::va("ncs_%s_level", "hnt"));
-			add_asset("netconststrings", utils::string::va("ncs_%s_level", "anm"));
-			add_asset("netconststrings", utils::string::va("ncs_%s_level", "fxt"));
-			add_asset("netconststrings", utils::string::va("ncs_%s_level", "acl"));
-			add_asset("netconststrings", utils::string::va("ncs_%s_level", "lui"));
-			add_asset("netconststrings", utils::string::va("ncs_%s_level", "lsr"));
-			add_line("");
+			const auto tokens = tokenize_gsc(data);
+			const auto count = tokens.size();
+
+			const auto is = [&](const std::size_t index, const token_type type, const std::string_view& value = {})
+			{
+				if (index >= count || tokens[index].type != type)
+				{
+					return false;
+				}
+
+				return value.empty() || equals_icase(tokens[index].value, value);
+			};
+
+			const auto get_call_argument = [&](const std::size_t index) -> std::optional<std::string_view>
+			{
+				if (is(index + 1, token_type::punctuation, "(")
+					&& is(index + 2, token_type::string)
+					&& is(index + 3, token_type::punctuation, ")"))
+				{
+					return {tokens[index + 2].value};
+				}
+
+				return {};
+			};
+
+			for (auto i = 0u; i < count; i++)
+			{
+				if (tokens[i].type != token_type::identifier)
+				{
+					continue;
+				}
+
+				const auto& name = tokens[i].value;
+
+				if (equals_icase(name, "v"))
+				{
+					if (i > 0 && is(i - 1, token_type::punctuation, ".")
+						&& i > 1 && is(i - 2, token_type::identifier)
+						&& is(i + 1, token_type::punctuation, "[")
+						&& is(i + 2, token_type::string, "soundalias")
+						&& is(i + 3, token_type::punctuation, "]")
+						&& is(i + 4, token_type::punctuation, "=")
+						&& is(i + 5, token_type::string)
+						&& is_sound_alias_name(tokens[i + 5].value))
+					{
+						refs.sounds.add(tokens[i + 5].value);
+					}
+
+					continue;
+				}
+
+				reference_list* list = nullptr;
+				if (equals_icase(name, "loadfx"))
+				{
+					list = &refs.effects;
+				}
+				else if (equals_icase(name, "precachemodel"))
+				{
+					list = &refs.models;
+				}
+				else if (equals_icase(name, "precacheshader") || equals_icase(name, "precachematerial"))
+				{
+					list = &refs.materials;
+				}
+
+				if (list == nullptr)
+				{
+					continue;
+				}
+
+				const auto argument = get_call_argument(i);
+				if (argument.has_value() && !argument->empty())
+				{
+					list->add(argument.value());
+				}
+			}
 		}
 
-		ZONETOOL_INFO("Parsing mapents...");
-		const auto mapents_list = mapents::parse(mapents_data, get_token_name);
+		constexpr auto csv_header = "// Generated by x64-ZoneTool\n";
+
+		struct map_csv
+		{
+			std::string csv;
+			std::vector<std::pair<std::string, std::string>> assets;
+		};
 
-		std::unordered_set<std::string> added_models;
-		auto added_models_comment = false;
-		for (const auto& ent : mapents_list.entities)
+		std::optional<map_csv> build_map_csv(const std::string& map, const mapents::token_name_callback& get_token_name,
+			const bool is_sp, const bool verbose)
 		{
-			if (ent.get("classname") != "script_model")
+			const auto root_dir = "zonetool/" + map;
+			if (!utils::io::directory_exists(root_dir))
 			{
-				continue;
+				ZONETOOL_ERROR("Zonetool map directory \"%s\" does not exist", map.data());
+				return {};
 			}
 
-			const auto model = ent.get("model");
-			if (model == "")
+			const auto map_prefix = map.starts_with("mp_")
+				? "maps/mp"s
+				: "maps"s;
+			const auto map_prefix_full = root_dir + "/" + map_prefix + "/";
+			const auto mapents_path = map_prefix_full + map + ".d3dbsp.ents";
+
+			std::string mapents_data;
+			if (!utils::io::read_file(mapents_path, &mapents_data))
 			{
-				continue;
+				ZONETOOL_ERROR("Missing mapents for map \"%s\"", map.data());
+				return {};
 			}
 
-			if (added_models.contains(model))
+			ZONETOOL_INFO("Generating CSV for map \"%s\"", map.data());
+
+			map_csv result{};
+			auto& csv = result.csv;
+
+			const auto add_str = [&](const std::string& str)
 			{
-				continue;
-			}
+				csv.append(str);
+			};
+
+			const auto add_line = [&](const std::string& line)
+			{
+				add_str(line);
+				add_str("\n");
+			};
+
+			const auto add_asset = [&](const std::string& type, const std::string& name, const bool enabled = true)
+			{
+				if (verbose)
+				{
+					ZONETOOL_INFO("Adding %s \"%s\"", type.data(), name.data());
+				}
+
+				if (!enabled)
+				{
+					add_str("#");
+				}
+				else
+				{
+					result.assets.emplace_back(type, name);
+				}
+
+				add_line(utils::string::va("%s,%s", type.data(), name.data()));
+			};
 
-			if (!added_models_comment)
+			add_line(csv_header);
+
+			if (!is_sp)
 			{
-				added_models_comment = true;
-				add_line("// models");
+				add_line("// netconststrings");
+				add_asset("netconststrings", utils::string::va("ncs_%s_level", "mdl"));
+				add_asset("netconststrings", utils::string::va("ncs_%s_level", "mat"));
+				add_asset("netconststrings", utils::string::va("ncs_%s_level", "rmb"));
+				add_asset("netconststrings", utils::string::va("ncs_%s_level", "veh"));
+				add_asset("netconststrings", utils::string::va("ncs_%s_level", "vfx"));
+				add_asset("netconststrings", utils::string::va("ncs_%s_level", "loc"));
+				add_asset("netconststrings", utils::string::va("ncs_%s_level", "snd"));
+				add_asset("netconststrings", utils::string::va("ncs_%s_level", "sbx"));
+				add_asset("netconststrings", utils::string::va("ncs_%s_level", "snl"));
+				add_asset("netconststrings", utils::string::va("ncs_%s_level", "shk"));
+				add_asset("netconststrings", utils::string::va("ncs_%s_level", "mnu"));
+				add_asset("netconststrings", utils::string::va("ncs_%s_level", "tag"));
+				add_asset("netconststrings", utils::string::va("ncs_%s_level", "hic"));
+				add_asset("netconststrings", utils::string::va("ncs_%s_level", "nps"));
+				add_asset("netconststrings", utils::string::va("ncs_%s_level", "mic"));
+				add_asset("netconststrings", utils::string::va("ncs_%s_level", "sel"));
+				add_asset("netconststrings", utils::string::va("ncs_%s_level", "wep"));
+				add_asset("netconststrings", utils::string::va("ncs_%s_level", "att"));
+				add_asset("netconststrings", utils::string::va("ncs_%s_level", "hnt"));
+				add_asset("netconststrings", utils::string::va("ncs_%s_level", "anm"));
+				add_asset("netconststrings", utils::string::va("ncs_%s_level", "fxt"));
+				add_asset("netconststrings", utils::string::va("ncs_%s_level", "acl"));
+				add_asset("netconststrings", utils::string::va("ncs_%s_level", "lui"));
+				add_asset("netconststrings", utils::string::va("ncs_%s_level", "lsr"));
+				add_line("");
 			}
 
-			added_models.insert(model);
-			add_asset("xmodel", model);
-		}
-		if (added_models.size() > 0)
-		{
-			add_line("");
-		}
+			const std::string create_fx_name = utils::string::va("maps/createfx/%s_fx.gsc", map.data());
+			const std::string create_fx_sounds_name = utils::string::va("maps/createfx/%s_sound.gsc", map.data());
+			const std::string fx_name = utils::string::va("%s/%s_fx.gsc", map_prefix.data(), map.data());
 
-		const std::string create_fx_name = utils::string::va("maps/createfx/%s_fx.gsc", map.data());
-		const std::string create_fx_sounds_name = utils::string::va("maps/createfx/%s_sound.gsc", map.data());
+			if (verbose)
+			{
+				ZONETOOL_INFO("Scanning gsc...");
+			}
 
-		const auto add_sounds = [&](const std::string& file)
-		{
-			const std::string create_fx_path = utils::string::va("%s/%s", root_dir.data(), file.data());
+			gsc_references references;
+			for (const auto& file : {
+				create_fx_name,
+				create_fx_sounds_name,
+				fx_name,
+				std::string{utils::string::va("%s/%s.gsc", map_prefix.data(), map.data())},
+				std::string{utils::string::va("%s/%s_precache.gsc", map_prefix.data(), map.data())},
+			})
+			{
+				std::string data;
+				if (utils::io::read_file(root_dir + "/" + file, &data))
+				{
+					scan_gsc(data, references);
+				}
+			}
 
-			std::string data;
-			if (!utils::io::read_file(create_fx_path, &data))
+			if (verbose)
 			{
-				return;
+				ZONETOOL_INFO("Parsing mapents...");
 			}
+			const auto mapents_list = mapents::parse(mapents_data, get_token_name);
 
-			ZONETOOL_INFO("Parsing createfx gsc...");
+			std::unordered_set<std::string> added_models;
+			auto added_models_comment = false;
+			const auto add_model = [&](const std::string& model, const bool check_exists)
+			{
+				if (added_models.contains(model))
+				{
+					return;
+				}
+
+				if (!added_models_comment)
+				{
+					added_models_comment = true;
+					add_line("// models");
+				}
+
+				added_models.insert(model);
+
+				// models only referenced from gsc usually live in a common zone
+				add_asset("xmodel", model, !check_exists || utils::io::file_exists(root_dir + "/xmodel/" + model + ".xmb"));
+			};
+
+			for (const auto& ent : mapents_list.entities)
+			{
+				if (ent.get("classname") != "script_model")
+				{
+					continue;
+				}
 
-			add_line("// sounds");
-			const auto sounds = parse_create_fx_gsc(data);
-			for (const auto& sound : sounds)
+				const auto model = ent.get("model");
+				if (model == "")
+				{
+					continue;
+				}
+
+				add_model(model, false);
+			}
+			for (const auto& model : references.models.get())
+			{
+				add_model(model, true);
+			}
+			if (added_models.size() > 0)
 			{
-				add_asset("sound", sound);
+				add_line("");
 			}
 
-			add_line("");
-		};
+			const auto add_references = [&](const std::string& comment, const std::string& type,
+				const reference_list& list, const std::function<bool(const std::string&)>& exists = {})
+			{
+				if (list.get().empty())
+				{
+					return;
+				}
 
-		const std::string fx_name = utils::string::va("%s/%s_fx.gsc", map_prefix.data(), map.data());
-		const auto add_effects = [&]
-		{
-			const std::string fx_path = utils::string::va("%s/%s", root_dir.data(), fx_name.data());
+				add_line(comment);
+				for (const auto& name : list.get())
+				{
+					add_asset(type, name, !exists || exists(name));
+				}
+				add_line("");
+			};
+
+			add_references("// sounds", "sound", references.sounds);
+			add_references("// effects", "fx", references.effects);
+			add_references("// materials", "material", references.materials, [&](const std::string& name)
+			{
+				return utils::io::file_exists(root_dir + "/materials/" + name + ".json");
+			});
+
+			const auto add_map_asset = [&](const std::string& type, const std::string& ext)
+			{
+				std::string name = utils::string::va("%s/%s.d3dbsp", map_prefix.data(), map.data());
+
+				const std::string path = root_dir + "/" + name + ext;
+				const std::string path_json = path + ".json";
+				add_asset(type, name, utils::io::file_exists(path) || utils::io::file_exists(path_json));
+			};
+
+			const auto add_iterator = [&](const std::string& type, const std::string& folder,
+				const std::string& extension, const std::string& comment, bool path = true)
+			{
+				auto added_comment = false;
+				const auto folder_ = root_dir + "/" + folder;
+				if (!utils::io::directory_exists(folder_))
+				{
+					return;
+				}
+
+				const auto files = utils::io::list_files(folder_);
+				for (const auto& file : files)
+				{
+					if (!file.ends_with(extension))
+					{
+						continue;
+					}
+
+					if (!added_comment)
+					{
+						added_comment = true;
+						add_line(comment);
+					}
+
+					if (!path)
+					{
+						const std::string name = file.substr(folder_.size(), file.size() - folder_.size() - extension.size());
+						add_asset(type, name);
+					}
+					else
+					{
+						const std::string name = folder + file.substr(folder_.size());
+						add_asset(type, name);
+					}
+				}
+
+				if (added_comment)
+				{
+					add_line("");
+				}
+			};
+
+			const auto add_if_exists = [&](const std::string& text, const std::string& path)
+			{
+				if (!utils::io::file_exists(root_dir + "/" + path))
+				{
+					return false;
+				}
+
+				add_line(text);
+				return true;
+			};
 
-			std::string data;
-			if (!utils::io::read_file(fx_path, &data))
 			{
-				return;
+				const std::string compass_name = utils::string::va("compass_map_%s", map.data());
+				const std::string compass_path = utils::string::va("materials/%s.json", compass_name.data());
+				add_if_exists(utils::string::va("// compass\nmaterial,compass_map_%s\n", map.data()), compass_path);
 			}
 
-			ZONETOOL_INFO("Parsing fx gsc...");
+			add_iterator("stringtable", "maps/createart/", ".csv", "// lightsets");
+			add_iterator("clut", "clut/", ".clut", "// color lookup tables", false);
+			add_iterator("rawfile", "vision/", ".vision", "// visions");
+			add_iterator("rawfile", "sun/", ".sun", "// sun");
+
+			const auto add_gsc = [&](const std::string& path)
+			{
+				const std::string gsc_path = root_dir + "/" + path;
+				add_asset("rawfile", path, utils::io::file_exists(gsc_path));
+			};
+
+			const auto add_gsc_if_exists = [&](const std::string& path)
+			{
+				const std::string gsc_path = root_dir + "/" + path;
+				if (!utils::io::file_exists(root_dir + "/" + path))
+				{
+					return false;
+				}
 
-			add_line("// effects");
+				add_asset("rawfile", path);
+				return true;
+			};
+
+			add_line("// gsc");
+			add_gsc(utils::string::va("%s/%s.gsc", map_prefix.data(), map.data()));
+			add_gsc(fx_name);
+			add_gsc(create_fx_name);
+			add_gsc_if_exists(create_fx_sounds_name);
+			add_gsc_if_exists(utils::string::va("%s/%s_precache.gsc", map_prefix.data(), map.data()));
+			add_gsc_if_exists(utils::string::va("%s/%s_lighting.gsc", map_prefix.data(), map.data()));
+			add_gsc_if_exists(utils::string::va("%s/%s_aud.gsc", map_prefix.data(), map.data()));
+			add_gsc(utils::string::va("maps/createart/%s_art.gsc", map.data()));
+			add_gsc(utils::string::va("maps/createart/%s_fog.gsc", map.data()));
+			add_gsc(utils::string::va("maps/createart/%s_fog_hdr.gsc", map.data()));
+			add_line("");
 
-			const auto effects = parse_fx_gsc(data);
-			for (const auto& effect : effects)
+			if (verbose)
 			{
-				add_asset("fx", effect);
+				ZONETOOL_INFO("Adding map assets...");
 			}
 
+			add_line("// map assets");
+			add_map_asset("com_map", ".commap");
+			add_map_asset("fx_map", ".fxmap");
+			add_map_asset("gfx_map", ".gfxmap");
+			add_map_asset("map_ents", ".ents");
+			add_map_asset("glass_map", ".glassmap");
+			add_map_asset("phys_worldmap", ".physmap");
+			add_map_asset("aipaths", ".aipaths");
+			add_map_asset(is_sp ? "col_map_sp" : "col_map_mp", ".colmap");
 			add_line("");
-		};
 
-		add_sounds(create_fx_name);
-		add_sounds(create_fx_sounds_name);
-		add_effects();
+			return {std::move(result)};
+		}
+	}
 
-		const auto add_map_asset = [&](const std::string& type, const std::string& ext)
+	void generate_map_csv(const std::string& map, const mapents::token_name_callback& get_token_name, bool is_sp)
+	{
+		const auto result = build_map_csv(map, get_token_name, is_sp, true);
+		if (!result.has_value())
 		{
-			std::string name = utils::string::va("%s/%s.d3dbsp", map_prefix.data(), map.data());
+			return;
+		}
 
-			const std::string path = root_dir + "/" + name + ext;
-			const std::string path_json = path + ".json";
-			if (!utils::io::file_exists(path) && !utils::io::file_exists(path_json))
-			{
-				add_str("#");
-			}
-			add_asset(type, name);
-		};
+		const auto csv_path = "zone_source/" + map + ".csv";
+
+		ZONETOOL_INFO("CSV saved to %s", csv_path.data());
+		utils::io::write_file(csv_path, result->csv, false);
+	}
+
+	namespace
+	{
+		bool is_shareable_type(const std::string& type)
+		{
+			return type == "xmodel" || type == "fx" || type == "sound" || type == "material";
+		}
+
+		std::string get_type_comment(const std::string& type)
+		{
+			if (type == "xmodel") return "// models";
+			if (type == "fx") return "// effects";
+			if (type == "sound") return "// sounds";
+			if (type == "material") return "// materials";
+			return "// " + type;
+		}
 
-		const auto add_iterator = [&](const std::string& type, const std::string& folder,
-			const std::string& extension, const std::string& comment, bool path = true)
+		std::vector<std::string> find_maps()
 		{
-			auto added_comment = false;
-			const auto folder_ = root_dir + "/" + folder;
-			if (!utils::io::directory_exists(folder_))
+			std::vector<std::string> maps;
+			if (!utils::io::directory_exists("zonetool"))
 			{
-				return;
+				return maps;
 			}
 
-			const auto files = utils::io::list_files(folder_);
-			for (const auto& file : files)
+			for (const auto& entry : std::filesystem::directory_iterator("zonetool"))
 			{
-				if (!file.ends_with(extension))
+				if (!entry.is_directory())
 				{
 					continue;
 				}
 
-				if (!added_comment)
+				const auto map = entry.path().filename().string();
+				const auto map_prefix = map.starts_with("mp_") ? "maps/mp"s : "maps"s;
+				if (utils::io::file_exists(utils::string::va("zonetool/%s/%s/%s.d3dbsp.ents", map.data(), map_prefix.data(), map.data())))
 				{
-					added_comment = true;
-					add_line(comment);
+					maps.emplace_back(map);
 				}
+			}
+
+			std::sort(maps.begin(), maps.end());
+			return maps;
+		}
+
+		std::vector<std::optional<map_csv>> build_map_csvs(const std::vector<std::string>& maps,
+			const mapents::token_name_callback& get_token_name, const bool is_sp)
+		{
+			std::vector<std::optional<map_csv>> results(maps.size());
+
+			const auto num_threads = std::min(maps.size(), static_cast<std::size_t>(std::max(1u, std::thread::hardware_concurrency())));
+			std::atomic_size_t next_map{};
 
-				if (!path)
+			std::vector<std::thread> threads;
+			for (auto i = 0u; i < num_threads; i++)
+			{
+				threads.emplace_back([&]
 				{
-					const std::string name = file.substr(folder_.size(), file.size() - folder_.size() - extension.size());
-					add_asset(type, name);
-				}
-				else
+					for (auto index = next_map++; index < maps.size(); index = next_map++)
+					{
+						results[index] = build_map_csv(maps[index], get_token_name, is_sp, false);
+					}
+				});
+			}
+
+			for (auto& thread : threads)
+			{
+				if (thread.joinable())
 				{
-					const std::string name = folder + file.substr(folder_.size());
-					add_asset(type, name);
+					thread.join();
 				}
 			}
 
-			if (added_comment)
+			return results;
+		}
+	}
+
+	void generate_pack_csv(const std::string& pack, const std::vector<std::string>& map_list,
+		const mapents::token_name_callback& get_token_name, bool is_sp)
+	{
+		const auto maps = map_list.empty() ? find_maps() : map_list;
+		if (maps.empty())
+		{
+			ZONETOOL_ERROR("No maps found under \"zonetool/\"");
+			return;
+		}
+
+		ZONETOOL_INFO("Generating CSVs for %llu maps...", maps.size());
+
+		const auto start = std::chrono::high_resolution_clock::now();
+		const auto results = build_map_csvs(maps, get_token_name, is_sp);
+
+		// (type, name) -> maps referencing it
+		std::map<std::pair<std::string, std::string>, std::vector<std::string>> references;
+		for (auto i = 0u; i < maps.size(); i++)
+		{
+			if (!results[i].has_value())
 			{
-				add_line("");
+				continue;
 			}
-		};
 
-		const auto add_if_exists = [&](const std::string& text, const std::string& path)
+			for (const auto& asset : results[i]->assets)
+			{
+				if (!is_shareable_type(asset.first))
+				{
+					continue;
+				}
+
+				auto& referenced_by = references[asset];
+				if (referenced_by.empty() || referenced_by.back() != maps[i])
+				{
+					referenced_by.emplace_back(maps[i]);
+				}
+			}
+		}
+
+		std::map<std::string, std::vector<std::string>> shared_assets;
+		std::size_t shared_count = 0;
+		std::size_t duplicates_removed = 0;
+		for (const auto& [asset, referenced_by] : references)
 		{
-			if (!utils::io::file_exists(root_dir + "/" + path))
+			if (referenced_by.size() < 2)
 			{
-				return false;
+				continue;
 			}
 
-			add_line(text);
-			return true;
-		};
+			shared_assets[asset.first].emplace_back(asset.second);
+			shared_count++;
+			duplicates_removed += referenced_by.size() - 1;
+		}
+
+		const auto common_zone = pack + "_common";
+		const auto has_common_zone = !shared_assets.empty();
 
+		if (has_common_zone)
 		{
-			const std::string compass_name = utils::string::va("compass_map_%s", map.data());
-			const std::string compass_path = utils::string::va("materials/%s.json", compass_name.data());
-			add_if_exists(utils::string::va("// compass\nmaterial,compass_map_%s\n", map.data()), compass_path);
-		}
+			std::string csv = csv_header;
+			csv.append("\n");
+
+			for (auto i = 0u; i < maps.size(); i++)
+			{
+				if (results[i].has_value())
+				{
+					csv.append(utils::string::va("addpath,zonetool\\%s\n", maps[i].data()));
+				}
+			}
+			csv.append("\n");
+
+			for (const auto& [type, names] : shared_assets)
+			{
+				csv.append(get_type_comment(type) + "\n");
+				for (const auto& name : names)
+				{
+					csv.append(utils::string::va("%s,%s\n", type.data(), name.data()));
+				}
+				csv.append("\n");
+			}
 
-		add_iterator("stringtable", "maps/createart/", ".csv", "// lightsets");
-		add_iterator("clut", "clut/", ".clut", "// color lookup tables", false);
-		add_iterator("rawfile", "vision/", ".vision", "// visions");
-		add_iterator("rawfile", "sun/", ".sun", "// sun");
+			const auto csv_path = "zone_source/" + common_zone + ".csv";
+			utils::io::write_file(csv_path, csv, false);
+			ZONETOOL_INFO("Common CSV saved to %s", csv_path.data());
+		}
 
-		const auto add_gsc = [&](const std::string& path)
+		auto generated = 0u;
+		for (auto i = 0u; i < maps.size(); i++)
 		{
-			const std::string gsc_path = root_dir + "/" + path;
-			if (!utils::io::file_exists(gsc_path))
+			if (!results[i].has_value())
 			{
-				add_str("#");
+				continue;
 			}
-			
-			add_asset("rawfile", path);
-		};
 
-		const auto add_gsc_if_exists = [&](const std::string& path)
+			auto csv = results[i]->csv;
+			if (has_common_zone)
+			{
+				// shared assets are written by the common zone and only referenced here
+				csv.insert(std::strlen(csv_header), utils::string::va("ignore,%s\n", common_zone.data()));
+			}
+
+			utils::io::write_file("zone_source/" + maps[i] + ".csv", csv, false);
+			generated++;
+		}
+
+		std::string report = "type,name,references,maps\n";
+		for (const auto& [asset, referenced_by] : references)
 		{
-			const std::string gsc_path = root_dir + "/" + path;
-			if (!utils::io::file_exists(root_dir + "/" + path))
+			std::string maps_str;
+			for (const auto& map : referenced_by)
 			{
-				return false;
+				maps_str.append(maps_str.empty() ? map : " " + map);
 			}
 
-			add_asset("rawfile", path);
-			return true;
-		};
+			report.append(utils::string::va("%s,%s,%llu,%s\n", asset.first.data(), asset.second.data(),
+				referenced_by.size(), maps_str.data()));
+		}
 
-		add_line("// gsc");
-		add_gsc(utils::string::va("%s/%s.gsc", map_prefix.data(), map.data()));
-		add_gsc(fx_name);
-		add_gsc(create_fx_name);
-		add_gsc_if_exists(create_fx_sounds_name);
-		add_gsc_if_exists(utils::string::va("%s/%s_precache.gsc", map_prefix.data(), map.data()));
-		add_gsc_if_exists(utils::string::va("%s/%s_lighting.gsc", map_prefix.data(), map.data()));
-		add_gsc_if_exists(utils::string::va("%s/%s_aud.gsc", map_prefix.data(), map.data()));
-		add_gsc(utils::string::va("maps/createart/%s_art.gsc", map.data()));
-		add_gsc(utils::string::va("maps/createart/%s_fog.gsc", map.data()));
-		add_gsc(utils::string::va("maps/createart/%s_fog_hdr.gsc", map.data()));
-		add_line("");
-
-		ZONETOOL_INFO("Adding map assets...");
-
-		add_line("// map assets");
-		add_map_asset("com_map", ".commap");
-		add_map_asset("fx_map", ".fxmap");
-		add_map_asset("gfx_map", ".gfxmap");
-		add_map_asset("map_ents", ".ents");
-		add_map_asset("glass_map", ".glassmap");
-		add_map_asset("phys_worldmap", ".physmap");
-		add_map_asset("aipaths", ".aipaths");
-		add_map_asset(is_sp ? "col_map_sp" : "col_map_mp", ".colmap");
-		add_line("");
+		const std::string report_path = utils::string::va("%s_references.csv", pack.data());
+		utils::io::write_file(report_path, report, false);
 
-		const auto csv_path = "zone_source/" + map + ".csv";
+		const auto end = std::chrono::high_resolution_clock::now();
+		const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
 
-		ZONETOOL_INFO("CSV saved to %s", csv_path.data());
-		utils::io::write_file(csv_path, csv, false);
+		ZONETOOL_INFO("Generated %u/%llu map CSVs in %lldms", generated, maps.size(), duration.count());
+		ZONETOOL_INFO("%llu of %llu assets are shared, %llu duplicate entries moved to \"%s\"",
+			shared_count, references.size(), duplicates_removed, common_zone.data());
+		ZONETOOL_INFO("Reference counts saved to %s", report_path.data());
 	}
 }
@@ -7,6 +7,11 @@ namespace csv_generator
 {
 	void generate_map_csv(const std::string& map, const mapents::token_name_callback& get_token_name, bool is_sp = false);
 
+	// generates csvs for every map in a pack (or every map under zonetool/) in parallel, moving assets
+	// referenced by more than one map into <pack>_common and writing per-asset reference counts
+	void generate_pack_csv(const std::string& pack, const std::vector<std::string>& maps,
+		const mapents::token_name_callback& get_token_name, bool is_sp = false);
+
 	template <typename T>
 	std::function<void(const T& params)> create_command(const mapents::token_name_callback& get_token_name)
 	{
@@ -27,4 +32,31 @@ namespace csv_generator
 			generate_map_csv(params.get(1), get_token_name, is_sp);
 		};
 	}
+
+	template <typename T>
+	std::function<void(const T& params)> create_pack_command(const mapents::token_name_callback& get_token_name)
+	{
+		return [=](const T& params)
+		{
+			if (params.size() < 2)
+			{
+				ZONETOOL_INFO("Usage: generatepackcsv <pack> [mode] [maps...]");
+				return;
+			}
+
+			auto is_sp = false;
+			if (params.size() >= 3)
+			{
+				is_sp = params.get(2) == "sp"s;
+			}
+
+			std::vector<std::string> maps;
+			for (auto i = 3; i < params.size(); i++)
+			{
+				maps.emplace_back(params.get(i));
+			}
+
+			generate_pack_csv(params.get(1), maps, get_token_name, is_sp);
+		};
+	}
 }
@@ -0,0 +1,552 @@
+#include <std_include.hpp>
+
+#include "ddl_source.hpp"
+
+#include <charconv>
+
+namespace zonetool::ddl_source
+{
+	namespace
+	{
+		enum class token_type
+		{
+			identifier,
+			number,
+			punctuation,
+			end,
+		};
+
+		struct token
+		{
+			token_type type;
+			std::string_view text;
+			std::size_t line;
+		};
+
+		std::string format_message(const std::string& name, const std::size_t line, const std::string& message)
+		{
+			return name + ":" + std::to_string(line) + ": " + message;
+		}
+
+		[[noreturn]] void throw_error(const std::string& name, const std::size_t line, const std::string& message)
+		{
+			throw std::runtime_error(format_message(name, line, message));
+		}
+
+		std::string describe(const token& token)
+		{
+			return token.type == token_type::end ? "end of file"s : "'" + std::string(token.text) + "'";
+		}
+
+		bool is_identifier_char(const char c)
+		{
+			return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+		}
+
+		std::vector<token> tokenize(const std::string_view& source, const std::string& name)
+		{
+			std::vector<token> tokens;
+			tokens.reserve(source.size() / 4);
+
+			std::size_t line = 1;
+			std::size_t pos = 0;
+
+			while (pos < source.size())
+			{
+				const auto c = source[pos];
+
+				if (c == '\n')
+				{
+					line++;
+					pos++;
+					continue;
+				}
+
+				if (std::isspace(static_cast<unsigned char>(c)))
+				{
+					pos++;
+					continue;
+				}
+
+				if (source.substr(pos).starts_with("//"))
+				{
+					while (pos < source.size() && source[pos] != '\n')
+					{
+						pos++;
+					}
+					continue;
+				}
+
+				if (source.substr(pos).starts_with("/*"))
+				{
+					const auto start_line = line;
+					const auto end = source.find("*/", pos + 2);
+					if (end == std::string_view::npos)
+					{
+						throw_error(name, start_line, "unterminated comment");
+					}
+
+					line += std::count(source.begin() + pos, source.begin() + end, '\n');
+					pos = end + 2;
+					continue;
+				}
+
+				const auto start = pos;
+				auto type = token_type::punctuation;
+
+				if (is_identifier_char(c))
+				{
+					// names like 1v1 show up as enum members, only plain digits are numbers
+					auto is_number = true;
+					while (pos < source.size() && is_identifier_char(source[pos]))
+					{
+						is_number &= std::isdigit(static_cast<unsigned char>(source[pos])) != 0;
+						pos++;
+					}
+
+					type = is_number ? token_type::number : token_type::identifier;
+				}
+				else if (std::string_view("[]{}():;,").find(c) != std::string_view::npos)
+				{
+					pos++;
+				}
+				else
+				{
+					throw_error(name, line, "unexpected character '"s + c + "'");
+				}
+
+				tokens.emplace_back(token{type, source.substr(start, pos - start), line});
+			}
+
+			tokens.emplace_back(token{token_type::end, {}, line});
+			return tokens;
+		}
+
+		class parser
+		{
+		public:
+			parser(const std::string_view& source, const std::string& name)
+				: name_(name)
+				, tokens_(tokenize(source, name))
+			{
+			}
+
+			file parse_file()
+			{
+				file result{};
+				std::vector<decoration> decorations;
+
+				while (!this->at_end())
+				{
+					if (this->peek_punctuation("["))
+					{
+						decorations.emplace_back(this->parse_decoration());
+						continue;
+					}
+
+					if (this->peek_identifier("version"))
+					{
+						result.versions.emplace_back(this->parse_version(std::move(decorations)));
+						decorations.clear();
+						continue;
+					}
+
+					this->error("expected a decoration or 'version', got " + describe(this->peek()));
+				}
+
+				if (!decorations.empty())
+				{
+					throw_error(this->name_, decorations.back().line, "decoration is not followed by a version block");
+				}
+
+				if (result.versions.empty())
+				{
+					throw_error(this->name_, this->peek().line, "no version blocks found");
+				}
+
+				return result;
+			}
+
+		private:
+			const std::string& name_;
+			std::vector<token> tokens_;
+			std::size_t pos_ = 0;
+
+			const token& peek() const
+			{
+				return this->tokens_[this->pos_];
+			}
+
+			bool at_end() const
+			{
+				return this->peek().type == token_type::end;
+			}
+
+			const token& next()
+			{
+				const auto& token = this->peek();
+				if (!this->at_end())
+				{
+					this->pos_++;
+				}
+				return token;
+			}
+
+			[[noreturn]] void error(const std::string& message) const
+			{
+				throw_error(this->name_, this->peek().line, message);
+			}
+
+			bool peek_punctuation(const std::string_view& text) const
+			{
+				return this->peek().type == token_type::punctuation && this->peek().text == text;
+			}
+
+			bool peek_identifier(const std::string_view& text) const
+			{
+				return this->peek().type == token_type::identifier && this->peek().text == text;
+			}
+
+			bool accept(const std::string_view& text)
+			{
+				if (this->peek_punctuation(text))
+				{
+					this->pos_++;
+					return true;
+				}
+				return false;
+			}
+
+			void expect(const std::string_view& text)
+			{
+				if (!this->accept(text))
+				{
+					this->error("expected '" + std::string(text) + "', got " + describe(this->peek()));
+				}
+			}
+
+			std::string expect_identifier(const char* what)
+			{
+				if (this->peek().type != token_type::identifier)
+				{
+					this->error("expected "s + what + ", got " + describe(this->peek()));
+				}
+				return std::string(this->next().text);
+			}
+
+			std::uint64_t expect_number(const char* what)
+			{
+				if (this->peek().type != token_type::number)
+				{
+					this->error("expected "s + what + ", got " + describe(this->peek()));
+				}
+
+				const auto& token = this->peek();
+
+				std::uint64_t value{};
+				const auto [end, ec] = std::from_chars(token.text.data(), token.text.data() + token.text.size(), value);
+				if (ec != std::errc{})
+				{
+					this->error("number " + describe(token) + " is out of range");
+				}
+
+				this->pos_++;
+				return value;
+			}
+
+			decoration parse_decoration()
+			{
+				decoration result{};
+				result.line = this->peek().line;
+
+				this->expect("[");
+				result.name = this->expect_identifier("a decoration name");
+
+				if (this->peek().type == token_type::number)
+				{
+					result.value = this->expect_number("a decoration value");
+				}
+
+				this->expect("]");
+
+				const auto takes_value = result.name == "userflags" || result.name == "reserve" || result.name == "defchecksum";
+				const auto is_flag = result.name == "codeversion" || result.name == "nopadding" ||
+					result.name == "checksum" || result.name == "ddlchecksum";
+
+				if (!takes_value && !is_flag)
+				{
+					throw_error(this->name_, result.line, "unknown decoration '" + result.name + "'");
+				}
+
+				if (takes_value != result.value.has_value())
+				{
+					throw_error(this->name_, result.line, "decoration '" + result.name + (takes_value ? "' needs a value" : "' does not take a value"));
+				}
+
+				return result;
+			}
+
+			version_def parse_version(std::vector<decoration>&& decorations)
+			{
+				version_def result{};
+				result.line = this->next().line;
+				result.decorations = std::move(decorations);
+
+				const auto version = this->expect_number("a version number");
+				if (version > std::numeric_limits<unsigned short>::max())
+				{
+					throw_error(this->name_, result.line, "version " + std::to_string(version) + " is out of range");
+				}
+				result.version = static_cast<unsigned short>(version);
+
+				this->expect("{");
+
+				while (!this->accept("}"))
+				{
+					if (this->peek_identifier("enum"))
+					{
+						result.enums.emplace_back(this->parse_enum());
+					}
+					else if (this->peek_identifier("struct"))
+					{
+						result.structs.emplace_back(this->parse_struct());
+					}
+					else
+					{
+						this->error("expected 'enum', 'struct' or '}', got " + describe(this->peek()));
+					}
+				}
+
+				this->accept(";");
+				return result;
+			}
+
+			enum_def parse_enum()
+			{
+				enum_def result{};
+				result.line = this->next().line;
+				result.name = this->expect_identifier("an enum name");
+
+				this->expect("{");
+
+				while (!this->accept("}"))
+				{
+					if (this->peek().type == token_type::number)
+					{
+						result.members.emplace_back(this->next().text);
+					}
+					else
+					{
+						result.members.emplace_back(this->expect_identifier("an enum member"));
+					}
+
+					if (!this->accept(","))
+					{
+						this->expect("}");
+						break;
+					}
+				}
+
+				this->accept(";");
+				return result;
+			}
+
+			struct_def parse_struct()
+			{
+				struct_def result{};
+				result.line = this->next().line;
+				result.name = this->expect_identifier("a struct name");
+
+				this->expect("{");
+
+				while (!this->accept("}"))
+				{
+					result.members.emplace_back(this->parse_member());
+				}
+
+				this->accept(";");
+				return result;
+			}
+
+			member_def parse_member()
+			{
+				member_def result{};
+				result.line = this->peek().line;
+				result.type = this->expect_identifier("a member type");
+
+				if (this->accept(":"))
+				{
+					result.bits = this->expect_number("a bit count");
+				}
+
+				if (this->accept("("))
+				{
+					result.limit = this->expect_number("a limit");
+					this->expect(")");
+				}
+
+				result.name = this->expect_identifier("a member name");
+
+				if (this->accept("["))
+				{
+					if (this->peek().type == token_type::number)
+					{
+						result.array_size = this->expect_number("an array size");
+						if (!result.array_size.value())
+						{
+							throw_error(this->name_, result.line, "array '" + result.name + "' has a size of 0");
+						}
+					}
+					else
+					{
+						result.array_enum = this->expect_identifier("an array size or enum name");
+					}
+
+					this->expect("]");
+				}
+
+				this->expect(";");
+				return result;
+			}
+		};
+
+		void validate_version(const version_def& version, const std::string& name, std::vector<std::string>* warnings)
+		{
+			const auto version_error = [&](const std::size_t line, const std::string& message)
+			{
+				throw_error(name, line, message + " in version " + std::to_string(version.version));
+			};
+
+			const auto version_warning = [&](const std::size_t line, const std::string& message)
+			{
+				if (warnings)
+				{
+					warnings->emplace_back(format_message(name, line, message + " in version " + std::to_string(version.version)));
+				}
+			};
+
+			std::unordered_set<std::string_view> enums;
+			for (const auto& enum_ : version.enums)
+			{
+				if (is_builtin_type(enum_.name))
+				{
+					version_error(enum_.line, "enum '" + enum_.name + "' shadows a builtin type");
+				}
+
+				if (!enums.emplace(enum_.name).second)
+				{
+					version_warning(enum_.line, "duplicate enum '" + enum_.name + "', the first definition is used");
+				}
+			}
+
+			std::unordered_map<std::string_view, const struct_def*> structs;
+			for (const auto& struct_ : version.structs)
+			{
+				if (enums.contains(struct_.name) || is_builtin_type(struct_.name))
+				{
+					version_error(struct_.line, "struct '" + struct_.name + "' shadows another type");
+				}
+
+				if (!structs.emplace(struct_.name, &struct_).second)
+				{
+					version_warning(struct_.line, "duplicate struct '" + struct_.name + "', the first definition is used");
+				}
+			}
+
+			if (!structs.contains("root"))
+			{
+				version_error(version.line, "root struct not found");
+			}
+
+			for (const auto& struct_ : version.structs)
+			{
+				// duplicates are never built, the first definition takes their place
+				if (structs.at(struct_.name) != &struct_)
+				{
+					continue;
+				}
+
+				std::unordered_set<std::string_view> members;
+				for (const auto& member : struct_.members)
+				{
+					if (!members.emplace(member.name).second)
+					{
+						version_error(member.line, "duplicate member '" + member.name + "' in struct '" + struct_.name + "'");
+					}
+
+					if (!is_builtin_type(member.type) && !enums.contains(member.type) && !structs.contains(member.type))
+					{
+						version_error(member.line, "unknown type '" + member.type + "'");
+					}
+
+					if (!member.array_enum.empty() && !enums.contains(member.array_enum))
+					{
+						version_error(member.line, "unknown enum '" + member.array_enum + "' used as array size");
+					}
+				}
+			}
+
+			// structs can't contain themselves, walk the struct members depth first
+			enum class state { unvisited, visiting, done };
+			std::unordered_map<std::string_view, state> states;
+
+			const std::function<void(const struct_def&)> visit = [&](const struct_def& struct_)
+			{
+				auto& current = states[struct_.name];
+				if (current == state::done)
+				{
+					return;
+				}
+
+				current = state::visiting;
+
+				for (const auto& member : struct_.members)
+				{
+					const auto iter = structs.find(member.type);
+					if (iter == structs.end())
+					{
+						continue;
+					}
+
+					if (states[member.type] == state::visiting)
+					{
+						version_error(member.line, "struct '" + member.type + "' contains itself");
+					}
+
+					visit(*iter->second);
+				}
+
+				states[struct_.name] = state::done;
+			};
+
+			for (const auto& struct_ : version.structs)
+			{
+				visit(*structs.at(struct_.name));
+			}
+		}
+	}
+
+	bool is_builtin_type(const std::string_view& type)
+	{
+		static const std::unordered_set<std::string_view> types =
+		{
+			"byte", "short", "uint", "int", "uint64", "float", "fixed", "string",
+			"bool", "int8", "uint8", "int16", "uint16",
+		};
+
+		return types.contains(type);
+	}
+
+	file parse(const std::string_view& source, const std::string& name)
+	{
+		return parser(source, name).parse_file();
+	}
+
+	void validate(const file& file, const std::string& name, std::vector<std::string>* warnings)
+	{
+		for (const auto& version : file.versions)
+		{
+			validate_version(version, name, warnings);
+		}
+	}
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+// only depends on the standard library so .ddl files can be checked without the game
+namespace zonetool::ddl_source
+{
+	struct decoration
+	{
+		std::string name;
+		std::optional<std::uint64_t> value;
+		std::size_t line;
+	};
+
+	struct enum_def
+	{
+		std::string name;
+		std::vector<std::string> members;
+		std::size_t line;
+	};
+
+	// type[:bits][(limit)] name[[size]];
+	struct member_def
+	{
+		std::string type;
+		std::optional<std::uint64_t> bits;
+		std::optional<std::uint64_t> limit;
+		std::string name;
+
+		// the array size is either a number or the name of an enum
+		std::optional<std::uint64_t> array_size;
+		std::string array_enum;
+
+		std::size_t line;
+	};
+
+	struct struct_def
+	{
+		std::string name;
+		std::vector<member_def> members;
+		std::size_t line;
+	};
+
+	// the decorations are the ones written in front of the version block
+	struct version_def
+	{
+		unsigned short version;
+		std::vector<decoration> decorations;
+		std::vector<enum_def> enums;
+		std::vector<struct_def> structs;
+		std::size_t line;
+	};
+
+	struct file
+	{
+		std::vector<version_def> versions;
+	};
+
+	// byte, short, uint, int, uint64, float, fixed, string and the bool, int8, uint8, int16, uint16 aliases
+	bool is_builtin_type(const std::string_view& type);
+
+	// tokenizes and parses the whole source, throws std::runtime_error as "name:line: message" on syntax errors
+	file parse(const std::string_view& source, const std::string& name);
+
+	// checks what the grammar can't: unknown or recursive types, unknown array enums, duplicate members
+	// and a missing root struct. throws std::runtime_error the same way parse does.
+	// duplicate enum and struct names only add a "name:line: message" warning, type lookups use the first
+	// definition and a duplicate struct is built as a copy of it
+	void validate(const file& file, const std::string& name, std::vector<std::string>* warnings = nullptr);
+}
@@ -0,0 +1,139 @@
+#include <std_include.hpp>
+
+#include "dump_writer.hpp"
+#include "utils.hpp"
+
+#include <utils/thread.hpp>
+
+#include <condition_variable>
+
+namespace zonetool::dump_writer
+{
+	namespace
+	{
+		constexpr auto max_pending_bytes = 512ull * 1024ull * 1024ull;
+		constexpr auto max_pending_tasks = 256ull;
+
+		class writer_pool
+		{
+		public:
+			writer_pool()
+			{
+				const auto thread_count = std::clamp(std::thread::hardware_concurrency(), 2u, 8u);
+				for (auto i = 0u; i < thread_count; i++)
+				{
+					auto thread = utils::thread::create_named_thread("Dump Writer", [this]
+					{
+						this->run();
+					});
+
+					thread.detach();
+				}
+			}
+
+			void enqueue(const std::size_t size, task&& callback)
+			{
+				std::unique_lock lock(this->mutex_);
+
+				// back-pressure, an empty queue always accepts so a single huge buffer can't stall forever
+				this->done_cv_.wait(lock, [&]
+				{
+					return this->pending_tasks_ == 0 ||
+						(this->pending_bytes_ + size <= max_pending_bytes && this->pending_tasks_ < max_pending_tasks);
+				});
+
+				this->queue_.emplace(size, std::move(callback));
+				this->pending_bytes_ += size;
+				++this->pending_tasks_;
+
+				lock.unlock();
+				this->task_cv_.notify_one();
+			}
+
+			void flush()
+			{
+				std::unique_lock lock(this->mutex_);
+				this->done_cv_.wait(lock, [&]
+				{
+					return this->pending_tasks_ == 0;
+				});
+			}
+
+		private:
+			std::mutex mutex_;
+			std::condition_variable task_cv_;
+			std::condition_variable done_cv_;
+			std::queue<std::pair<std::size_t, task>> queue_;
+			std::size_t pending_bytes_{};
+			std::size_t pending_tasks_{};
+
+			void run()
+			{
+				while (true)
+				{
+					std::pair<std::size_t, task> entry{};
+
+					{
+						std::unique_lock lock(this->mutex_);
+						this->task_cv_.wait(lock, [&]
+						{
+							return !this->queue_.empty();
+						});
+
+						entry = std::move(this->queue_.front());
+						this->queue_.pop();
+					}
+
+					try
+					{
+						entry.second();
+					}
+					catch (const std::exception& e)
+					{
+						ZONETOOL_ERROR("Dump write failed: %s", e.what());
+					}
+					catch (...)
+					{
+						// the task still has to be accounted for below or flush would wait forever
+						ZONETOOL_ERROR("Dump write failed: unknown exception");
+					}
+
+					{
+						std::lock_guard _(this->mutex_);
+						this->pending_bytes_ -= entry.first;
+						--this->pending_tasks_;
+					}
+
+					this->done_cv_.notify_all();
+				}
+			}
+		};
+
+		// never destroyed, the worker threads are detached and live as long as the process
+		std::atomic<writer_pool*> pool{};
+		std::once_flag pool_flag;
+
+		writer_pool& get_pool()
+		{
+			std::call_once(pool_flag, []
+			{
+				pool = new writer_pool();
+			});
+
+			return *pool;
+		}
+	}
+
+	void enqueue(const std::size_t size, task&& callback)
+	{
+		get_pool().enqueue(size, std::move(callback));
+	}
+
+	void flush()
+	{
+		if (const auto writer = pool.load())
+		{
+			writer->flush();
+		}
+	}
+}
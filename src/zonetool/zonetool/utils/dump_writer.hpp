@@ -0,0 +1,15 @@
+#pragma once
+
+#include <functional>
+
+namespace zonetool::dump_writer
+{
+	using task = std::function<void()>;
+
+	// runs a file write for a dumped asset on the background writer pool,
+	// blocks the caller while too much data is already queued
+	void enqueue(std::size_t size, task&& callback);
+
+	// waits until every queued write has finished
+	void flush();
+}
@@ -0,0 +1,170 @@
+#include <std_include.hpp>
+
+#include "flac.hpp"
+
+#include <utils/bit_buffer.hpp>
+
+#define APPLICATION_ID "fsiz"
+
+namespace zonetool::flac
+{
+	namespace
+	{
+		constexpr auto signature_size = 4u;
+		constexpr auto block_header_size = 4u;
+		constexpr auto streaminfo_size = 34u;
+
+		std::uint32_t read_be32(const char* buffer)
+		{
+			const auto* bytes = reinterpret_cast<const std::uint8_t*>(buffer);
+			return (static_cast<std::uint32_t>(bytes[0]) << 24) | (static_cast<std::uint32_t>(bytes[1]) << 16) |
+				(static_cast<std::uint32_t>(bytes[2]) << 8) | static_cast<std::uint32_t>(bytes[3]);
+		}
+
+		void append_be32(std::string& buffer, const std::uint32_t value)
+		{
+			buffer.push_back(static_cast<char>(value >> 24));
+			buffer.push_back(static_cast<char>(value >> 16));
+			buffer.push_back(static_cast<char>(value >> 8));
+			buffer.push_back(static_cast<char>(value));
+		}
+
+		void append_le32(std::string& buffer, const std::uint32_t value)
+		{
+			buffer.push_back(static_cast<char>(value));
+			buffer.push_back(static_cast<char>(value >> 8));
+			buffer.push_back(static_cast<char>(value >> 16));
+			buffer.push_back(static_cast<char>(value >> 24));
+		}
+	}
+
+	metadata_block_header_t parse_metadata_block(const char* buffer)
+	{
+		/*
+			bits | description
+			   1   is last block
+			   7   block type
+			  24   block length (header not included)
+		*/
+
+		const auto header = read_be32(buffer);
+
+		metadata_block_header_t block{};
+		block.is_last = (header >> 31) != 0;
+		block.type = static_cast<block_type_t>((header >> 24) & 0x7F);
+		block.length = header & 0xFFFFFF;
+		return block;
+	}
+
+	stream_info parse_streaminfo(const std::string_view& block)
+	{
+		if (block.size() < streaminfo_size)
+		{
+			throw std::runtime_error("Flac streaminfo block is too short");
+		}
+
+		utils::bit_buffer buffer(std::string{block});
+
+		stream_info info{};
+		info.min_block_size = buffer.read_bits<unsigned int>(0, 16);
+		info.max_block_size = buffer.read_bits<unsigned int>(16, 16);
+		info.sample_rate = buffer.read_bits<unsigned int>(80, 20);
+		info.channels = buffer.read_bits<unsigned int>(100, 3) + 1;
+		info.bits_per_sample = buffer.read_bits<unsigned int>(103, 5) + 1;
+		info.num_samples = buffer.read_bits<unsigned int>(108, 36);
+		return info;
+	}
+
+	patched_stream patch_stream(const std::string_view& data)
+	{
+		if (!data.starts_with("fLaC"))
+		{
+			throw std::runtime_error("File is not a flac file");
+		}
+
+		patched_stream result{};
+		metadata_block_header_t block{};
+
+		auto pos = static_cast<std::size_t>(signature_size);
+		auto block_start = pos;
+		auto block_end = pos;
+
+		auto num_blocks = 0;
+		auto has_seektable = false;
+		auto has_application = false;
+
+		while (!block.is_last && pos + block_header_size <= data.size())
+		{
+			block = parse_metadata_block(data.data() + pos);
+			block_start = pos;
+			block_end = pos + block_header_size + block.length;
+			num_blocks++;
+
+			if (block_end > data.size())
+			{
+				throw std::runtime_error("Flac metadata block exceeds the file size");
+			}
+
+			const auto block_data = data.substr(block_start + block_header_size, block.length);
+
+			if (!block.is_last)
+			{
+				pos = block_end;
+			}
+
+			if (block.type == block_type_t::application && block_data.starts_with(APPLICATION_ID))
+			{
+				has_application = true;
+			}
+
+			if (block.type == block_type_t::streaminfo)
+			{
+				result.info = parse_streaminfo(block_data);
+			}
+
+			if (block.type == block_type_t::seektable)
+			{
+				has_seektable = true;
+			}
+		}
+
+		if (!num_blocks)
+		{
+			throw std::runtime_error("Flac file has no metadata blocks");
+		}
+
+		// new blocks go in front of the last block, or after it if it's the only one
+		auto insert_pos = pos;
+		auto insert_header = 0x02000008u; // application block, length 8
+
+		if (num_blocks == 1)
+		{
+			insert_header = 0x82000008u;
+			insert_pos = block_end;
+		}
+
+		result.header.reserve(insert_pos + 16);
+		result.header.append(data.data(), insert_pos);
+
+		if (num_blocks == 1)
+		{
+			// the only block is not the last one anymore
+			result.header[block_start] &= 0x7F;
+		}
+
+		if (!has_seektable)
+		{
+			append_be32(result.header, 0x03000000); // empty seektable
+		}
+
+		if (!has_application)
+		{
+			append_be32(result.header, insert_header);
+			result.header.append(APPLICATION_ID);
+			append_le32(result.header, static_cast<std::uint32_t>(data.size() - block_end)); // frame section size
+		}
+
+		result.frames = data.substr(insert_pos);
+		return result;
+	}
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+// only depends on the standard library and utils::bit_buffer so it can be built and tested on its own
+namespace zonetool::flac
+{
+	// https://xiph.org/flac/format.html#metadata_block_header
+	enum block_type_t
+	{
+		streaminfo,
+		padding,
+		application,
+		seektable,
+		vorbis_comment,
+		cuesheet,
+		picture,
+		count
+	};
+
+	// the game only plays streams encoded with a constant blocksize of 1024
+	constexpr unsigned int constant_block_size = 0x400;
+
+	struct metadata_block_header_t
+	{
+		bool is_last;
+		block_type_t type;
+		std::uint32_t length;
+	};
+
+	struct stream_info
+	{
+		unsigned int min_block_size;
+		unsigned int max_block_size;
+		unsigned int sample_rate;
+		unsigned int channels;
+		unsigned int bits_per_sample;
+		unsigned int num_samples;
+	};
+
+	// reads the 4 byte header in front of every metadata block
+	metadata_block_header_t parse_metadata_block(const char* buffer);
+
+	// reads the payload of a streaminfo block, throws std::runtime_error if it is too short
+	stream_info parse_streaminfo(const std::string_view& block);
+
+	// the game expects a seektable and an "fsiz" application block holding the size of the frame section.
+	// only the metadata in front of the insertion point is rebuilt, the rest of the file is written as is
+	// after the header so the audio frames are never copied to make room for the new blocks
+	struct patched_stream
+	{
+		std::string header;
+		std::string_view frames;
+		stream_info info;
+
+		std::size_t size() const
+		{
+			return this->header.size() + this->frames.size();
+		}
+	};
+
+	// throws std::runtime_error if the data is not flac or its metadata is broken
+	patched_stream patch_stream(const std::string_view& data);
+}
@@ -0,0 +1,447 @@
+#include <std_include.hpp>
+
+#include "gsc_cache.hpp"
+#include "gsc.hpp"
+#include "utils.hpp"
+
+#include <utils/compression.hpp>
+#include <utils/flags.hpp>
+#include <utils/io.hpp>
+#include <utils/string.hpp>
+#include <utils/thread.hpp>
+
+#include <condition_variable>
+
+namespace zonetool::gsc_cache
+{
+	namespace
+	{
+		constexpr std::uint32_t entry_magic = 0x4347545A; // "ZTGC"
+		constexpr std::uint32_t entry_version = 1;
+
+		// bump when deps/gsc-tool is updated so bytecode from another compiler is never reused
+		constexpr std::uint32_t compiler_version = 1;
+
+		constexpr auto cache_folder = "zonetool_cache\\gsc\\";
+
+		const char* get_game_name(const game game)
+		{
+			switch (game)
+			{
+			case game::iw6: return "iw6";
+			case game::s1: return "s1";
+			case game::h1: return "h1";
+			case game::h2: return "h2";
+			case game::iw7: return "iw7";
+			}
+
+			return "unknown";
+		}
+
+		std::uint64_t hash_data(const std::string_view& data, std::uint64_t hash = 0xCBF29CE484222325)
+		{
+			// fnv-1a
+			for (const auto c : data)
+			{
+				hash ^= static_cast<std::uint8_t>(c);
+				hash *= 0x100000001B3;
+			}
+
+			return hash;
+		}
+
+		// a file the compiler pulled in with #include, with the hash of what it read
+		struct include_file
+		{
+			std::string name;
+			std::uint64_t hash;
+		};
+
+		struct job
+		{
+			gsc_cache::game game;
+			std::string name;
+			std::string path;
+			std::vector<std::string> search_paths;
+			std::promise<std::shared_ptr<const script>> promise;
+		};
+
+		// what the compiler of the current worker reads includes from
+		struct include_scope
+		{
+			const job* owner;
+			std::vector<include_file> includes;
+
+			// compiled includes are handed to the compiler as pointers into these
+			std::vector<std::unique_ptr<std::string>> bytecode;
+		};
+
+		thread_local include_scope* current_scope = nullptr;
+
+		std::optional<std::string> find_file(const std::string& path, const std::vector<std::string>& search_paths)
+		{
+			// same lookup as filesystem::file::open
+			for (const auto& search_path : search_paths)
+			{
+				auto full_path = search_path + path;
+				if (std::filesystem::is_regular_file(full_path))
+				{
+					return {std::move(full_path)};
+				}
+			}
+
+			return {};
+		}
+
+		std::string get_include_path(const std::string& include)
+		{
+			auto path = std::filesystem::path(include).replace_extension(".gsc").string();
+			std::replace(path.begin(), path.end(), '/', '\\');
+			return path;
+		}
+
+		// hash of the include as the compiler sees it, 0 if it can't be found anymore
+		std::uint64_t hash_include(const std::string& include, const std::vector<std::string>& search_paths)
+		{
+			const auto path = get_include_path(include);
+
+			for (const auto& file : {path, std::filesystem::path(path).replace_extension(".gscbin").string()})
+			{
+				if (const auto full_path = find_file(file, search_paths))
+				{
+					return hash_data(utils::io::read_file(full_path.value()), hash_data(file));
+				}
+			}
+
+			return 0;
+		}
+
+		std::pair<xsk::gsc::buffer, std::vector<std::uint8_t>> read_include(const std::string& include)
+		{
+			auto& scope = *current_scope;
+
+			const auto path = get_include_path(include);
+			if (const auto full_path = find_file(path, scope.owner->search_paths))
+			{
+				const auto data = utils::io::read_file(full_path.value());
+				scope.includes.emplace_back(include_file{include, hash_data(data, hash_data(path))});
+				return {{}, {data.begin(), data.end()}};
+			}
+
+			// includes that only exist as .gscbin are linked against their bytecode
+			const auto bin_path = std::filesystem::path(path).replace_extension(".gscbin").string();
+			if (const auto full_path = find_file(bin_path, scope.owner->search_paths))
+			{
+				const auto data = utils::io::read_file(full_path.value());
+				scope.includes.emplace_back(include_file{include, hash_data(data, hash_data(bin_path))});
+
+				// name, compressedLen, len, bytecodeLen, buffer, bytecode
+				const auto name_end = data.find('\0');
+				if (name_end == std::string::npos || data.size() < name_end + 1 + sizeof(std::int32_t) * 3)
+				{
+					throw std::runtime_error(utils::string::va("Include \"%s\" is not a valid gscbin", bin_path.data()));
+				}
+
+				std::int32_t sizes[3]{};
+				std::memcpy(sizes, data.data() + name_end + 1, sizeof(sizes));
+
+				const auto buffer_start = name_end + 1 + sizeof(sizes);
+				if (sizes[0] < 0 || sizes[2] < 0 || data.size() < buffer_start + sizes[0] + sizes[2])
+				{
+					throw std::runtime_error(utils::string::va("Include \"%s\" is not a valid gscbin", bin_path.data()));
+				}
+
+				const auto stack = utils::compression::zlib::decompress(data.substr(buffer_start, sizes[0]));
+				const auto& bytecode = scope.bytecode.emplace_back(std::make_unique<std::string>(data.substr(buffer_start + sizes[0], sizes[2])));
+
+				return {{reinterpret_cast<const std::uint8_t*>(bytecode->data()), bytecode->size()}, {stack.begin(), stack.end()}};
+			}
+
+			throw std::runtime_error(utils::string::va("Could not find include \"%s\"", include.data()));
+		}
+
+		std::unique_ptr<xsk::gsc::context> create_context(const game game)
+		{
+			switch (game)
+			{
+			case game::iw6: return std::make_unique<xsk::gsc::iw6_pc::context>();
+			case game::s1: return std::make_unique<xsk::gsc::s1_pc::context>();
+			case game::h1: return std::make_unique<xsk::gsc::h1::context>();
+			case game::h2: return std::make_unique<xsk::gsc::h2::context>();
+			case game::iw7: return std::make_unique<xsk::gsc::iw7::context>();
+			}
+
+			throw std::runtime_error("Unknown gsc game");
+		}
+
+		// contexts aren't thread safe, so every worker compiles with its own
+		xsk::gsc::context& get_context(const game game)
+		{
+			thread_local std::unordered_map<gsc_cache::game, std::unique_ptr<xsk::gsc::context>> contexts;
+
+			auto& context = contexts[game];
+			if (!context)
+			{
+				context = create_context(game);
+			}
+
+			// drops the includes of the previous script so edited ones are read again
+			context->cleanup();
+			context->init(xsk::gsc::build::prod, []([[maybe_unused]] const xsk::gsc::context* ctx, const std::string& include)
+			{
+				return read_include(include);
+			});
+
+			return *context;
+		}
+
+		std::string get_entry_path(const job& job, const std::uint64_t source_hash)
+		{
+			auto key = hash_data(job.name, source_hash);
+			key = hash_data(get_game_name(job.game), key);
+			key = hash_data({reinterpret_cast<const char*>(&compiler_version), sizeof(compiler_version)}, key);
+
+			return utils::string::va("%s%s\\%016llX.bin", cache_folder, get_game_name(job.game), key);
+		}
+
+		template <typename T>
+		void append(std::string& buffer, const T& value)
+		{
+			buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+		}
+
+		void append_string(std::string& buffer, const std::string& value)
+		{
+			append(buffer, static_cast<std::uint32_t>(value.size()));
+			buffer.append(value);
+		}
+
+		class entry_reader
+		{
+		public:
+			entry_reader(const std::string& data)
+				: data_(data)
+			{
+			}
+
+			template <typename T>
+			bool read(T* value)
+			{
+				if (this->data_.size() - this->pos_ < sizeof(T))
+				{
+					return false;
+				}
+
+				std::memcpy(value, this->data_.data() + this->pos_, sizeof(T));
+				this->pos_ += sizeof(T);
+				return true;
+			}
+
+			bool read_string(std::string* value)
+			{
+				std::uint32_t size{};
+				if (!this->read(&size) || this->data_.size() - this->pos_ < size)
+				{
+					return false;
+				}
+
+				value->assign(this->data_.data() + this->pos_, size);
+				this->pos_ += size;
+				return true;
+			}
+
+		private:
+			const std::string& data_;
+			std::size_t pos_{};
+		};
+
+		void write_entry(const std::string& path, const script& script, const std::vector<include_file>& includes)
+		{
+			std::string buffer;
+			append(buffer, entry_magic);
+			append(buffer, entry_version);
+
+			append(buffer, static_cast<std::uint32_t>(includes.size()));
+			for (const auto& include : includes)
+			{
+				append_string(buffer, include.name);
+				append(buffer, include.hash);
+			}
+
+			append(buffer, script.len);
+			append_string(buffer, script.buffer);
+			append_string(buffer, script.bytecode);
+
+			if (!utils::io::write_file(path, buffer))
+			{
+				ZONETOOL_WARNING("Failed to write gsc cache entry \"%s\"", path.data());
+			}
+		}
+
+		std::shared_ptr<const script> read_entry(const std::string& path, const std::vector<std::string>& search_paths)
+		{
+			std::string data;
+			if (!utils::io::read_file(path, &data))
+			{
+				return {};
+			}
+
+			entry_reader reader(data);
+
+			std::uint32_t magic{}, version{}, include_count{};
+			if (!reader.read(&magic) || !reader.read(&version) || !reader.read(&include_count) ||
+				magic != entry_magic || version != entry_version)
+			{
+				return {};
+			}
+
+			for (auto i = 0u; i < include_count; i++)
+			{
+				include_file include{};
+				if (!reader.read_string(&include.name) || !reader.read(&include.hash))
+				{
+					return {};
+				}
+
+				if (hash_include(include.name, search_paths) != include.hash)
+				{
+					return {};
+				}
+			}
+
+			auto result = std::make_shared<script>();
+			if (!reader.read(&result->len) || !reader.read_string(&result->buffer) || !reader.read_string(&result->bytecode))
+			{
+				return {};
+			}
+
+			return result;
+		}
+
+		std::shared_ptr<const script> compile_script(const job& job)
+		{
+			std::string source;
+			if (!utils::io::read_file(job.path, &source))
+			{
+				throw std::runtime_error(utils::string::va("Failed to read \"%s\"", job.path.data()));
+			}
+
+			static const auto use_cache = !utils::flags::has_flag("no_gsc_cache");
+
+			const auto entry_path = get_entry_path(job, hash_data(source));
+			if (use_cache)
+			{
+				if (auto cached = read_entry(entry_path, job.search_paths))
+				{
+					return cached;
+				}
+			}
+
+			include_scope scope{&job};
+			current_scope = &scope;
+			const auto _ = gsl::finally([]
+			{
+				current_scope = nullptr;
+			});
+
+			auto& context = get_context(job.game);
+
+			std::vector<std::uint8_t> data{source.begin(), source.end()};
+			const auto assembly = context.compiler().compile(job.name, data);
+			const auto [bytecode, stack] = context.assembler().assemble(*assembly);
+
+			auto result = std::make_shared<script>();
+			result->len = static_cast<std::uint32_t>(stack.size);
+			result->buffer = utils::compression::zlib::compress({reinterpret_cast<const char*>(stack.data), stack.size});
+			result->bytecode.assign(reinterpret_cast<const char*>(bytecode.data), bytecode.size);
+
+			if (use_cache)
+			{
+				write_entry(entry_path, *result, scope.includes);
+			}
+
+			return result;
+		}
+
+		class compile_pool
+		{
+		public:
+			compile_pool()
+			{
+				const auto thread_count = std::max(std::thread::hardware_concurrency(), 2u);
+				for (auto i = 0u; i < thread_count; i++)
+				{
+					auto thread = utils::thread::create_named_thread("GSC Compiler", [this]
+					{
+						this->run();
+					});
+
+					thread.detach();
+				}
+			}
+
+			void enqueue(std::unique_ptr<job>&& job)
+			{
+				{
+					std::lock_guard _(this->mutex_);
+					this->queue_.emplace(std::move(job));
+				}
+
+				this->task_cv_.notify_one();
+			}
+
+		private:
+			std::mutex mutex_;
+			std::condition_variable task_cv_;
+			std::queue<std::unique_ptr<job>> queue_;
+
+			void run()
+			{
+				while (true)
+				{
+					std::unique_ptr<job> job;
+
+					{
+						std::unique_lock lock(this->mutex_);
+						this->task_cv_.wait(lock, [&]
+						{
+							return !this->queue_.empty();
+						});
+
+						job = std::move(this->queue_.front());
+						this->queue_.pop();
+					}
+
+					try
+					{
+						job->promise.set_value(compile_script(*job));
+					}
+					catch (const std::exception& e)
+					{
+						job->promise.set_exception(std::make_exception_ptr(
+							std::runtime_error(utils::string::va("%s: %s", job->path.data(), e.what()))));
+					}
+				}
+			}
+		};
+
+		compile_pool& get_pool()
+		{
+			static compile_pool pool;
+			return pool;
+		}
+	}
+
+	pending_script compile(const game game, const std::string& name, const std::string& path)
+	{
+		auto job = std::make_unique<gsc_cache::job>();
+		job->game = game;
+		job->name = name;
+		job->path = path;
+		job->search_paths = filesystem::get_search_paths();
+
+		auto result = job->promise.get_future().share();
+		get_pool().enqueue(std::move(job));
+		return result;
+	}
+}
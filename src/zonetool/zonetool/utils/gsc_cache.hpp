@@ -0,0 +1,30 @@
+#pragma once
+
+#include <future>
+
+namespace zonetool::gsc_cache
+{
+	enum class game
+	{
+		iw6,
+		s1,
+		h1,
+		h2,
+		iw7,
+	};
+
+	// the data of a ScriptFile asset
+	struct script
+	{
+		std::string buffer; // zlib compressed stack
+		std::uint32_t len; // decompressed stack size
+		std::string bytecode;
+	};
+
+	using pending_script = std::shared_future<std::shared_ptr<const script>>;
+
+	// compiles a .gsc source on the compile workers, each worker has its own context per game.
+	// the result is reused from zonetool_cache\gsc\ while the source, its includes, the game and the
+	// compiler are unchanged. compile errors are rethrown by the future
+	pending_script compile(game game, const std::string& name, const std::string& path);
+}
@@ -0,0 +1,192 @@
+#include <std_include.hpp>
+
+#include "image_budget.hpp"
+#include "utils.hpp"
+
+#pragma warning( push )
+#pragma warning( disable : 4459 )
+#include <DirectXTex.h>
+#pragma warning( pop )
+
+#include <utils/flags.hpp>
+#include <utils/io.hpp>
+#include <utils/string.hpp>
+
+namespace zonetool::image_budget
+{
+	namespace
+	{
+		constexpr auto max_printed_images = 20;
+
+		std::mutex entries_mutex;
+		std::vector<image_entry> entries;
+
+		std::string get_format_name(const std::uint32_t format)
+		{
+#define FORMAT_CASE(__NAME__) case DXGI_FORMAT_##__NAME__: return #__NAME__;
+			switch (static_cast<DXGI_FORMAT>(format))
+			{
+				FORMAT_CASE(R32G32B32A32_FLOAT)
+				FORMAT_CASE(R16G16B16A16_FLOAT)
+				FORMAT_CASE(R16G16B16A16_UNORM)
+				FORMAT_CASE(R32G32_FLOAT)
+				FORMAT_CASE(R10G10B10A2_UNORM)
+				FORMAT_CASE(R11G11B10_FLOAT)
+				FORMAT_CASE(R8G8B8A8_UNORM)
+				FORMAT_CASE(R8G8B8A8_UNORM_SRGB)
+				FORMAT_CASE(R16G16_FLOAT)
+				FORMAT_CASE(R16G16_UNORM)
+				FORMAT_CASE(R32_FLOAT)
+				FORMAT_CASE(R8G8_UNORM)
+				FORMAT_CASE(R16_FLOAT)
+				FORMAT_CASE(R16_UNORM)
+				FORMAT_CASE(R8_UNORM)
+				FORMAT_CASE(A8_UNORM)
+				FORMAT_CASE(R9G9B9E5_SHAREDEXP)
+				FORMAT_CASE(BC1_UNORM)
+				FORMAT_CASE(BC1_UNORM_SRGB)
+				FORMAT_CASE(BC2_UNORM)
+				FORMAT_CASE(BC2_UNORM_SRGB)
+				FORMAT_CASE(BC3_UNORM)
+				FORMAT_CASE(BC3_UNORM_SRGB)
+				FORMAT_CASE(BC4_UNORM)
+				FORMAT_CASE(BC4_SNORM)
+				FORMAT_CASE(BC5_UNORM)
+				FORMAT_CASE(BC5_SNORM)
+				FORMAT_CASE(B8G8R8A8_UNORM)
+				FORMAT_CASE(B8G8R8A8_UNORM_SRGB)
+				FORMAT_CASE(BC6H_UF16)
+				FORMAT_CASE(BC6H_SF16)
+				FORMAT_CASE(BC7_UNORM)
+				FORMAT_CASE(BC7_UNORM_SRGB)
+			default:
+				return utils::string::va("FORMAT_%u", format);
+			}
+#undef FORMAT_CASE
+		}
+
+		std::uint64_t get_streamed_size(const image_entry& entry)
+		{
+			std::uint64_t size = 0;
+			for (const auto& stream_size : entry.stream_sizes)
+			{
+				size += stream_size;
+			}
+
+			return size;
+		}
+
+		std::uint64_t get_total_size(const image_entry& entry)
+		{
+			return entry.resident_size + get_streamed_size(entry);
+		}
+
+		std::string format_size(const std::uint64_t size)
+		{
+			if (size >= 1024ull * 1024ull)
+			{
+				return utils::string::va("%.2f MB", static_cast<double>(size) / (1024.0 * 1024.0));
+			}
+
+			return utils::string::va("%.2f KB", static_cast<double>(size) / 1024.0);
+		}
+	}
+
+	bool is_enabled()
+	{
+		static const auto enabled = utils::flags::has_flag("image_budget");
+		return enabled;
+	}
+
+	void add(image_entry&& entry)
+	{
+		std::lock_guard _(entries_mutex);
+		entries.emplace_back(std::move(entry));
+	}
+
+	void report(const std::string& fastfile)
+	{
+		if (!is_enabled())
+		{
+			return;
+		}
+
+		std::vector<image_entry> images;
+		{
+			std::lock_guard _(entries_mutex);
+			images = std::move(entries);
+			entries.clear();
+		}
+
+		if (images.empty())
+		{
+			return;
+		}
+
+		std::sort(images.begin(), images.end(), [](const image_entry& a, const image_entry& b)
+		{
+			return get_total_size(a) > get_total_size(b);
+		});
+
+		struct format_total
+		{
+			std::size_t count;
+			std::uint64_t resident_size;
+			std::uint64_t streamed_size;
+		};
+
+		std::map<std::string, format_total> format_totals;
+		std::uint64_t total_resident = 0;
+		std::uint64_t total_streamed = 0;
+
+		std::string buffer = "name,format,width,height,depth,mips,compressed,resident,stream0,stream1,stream2,stream3,total\n";
+		for (const auto& image : images)
+		{
+			const auto format_name = get_format_name(image.format);
+			const auto streamed_size = get_streamed_size(image);
+
+			auto& totals = format_totals[format_name];
+			totals.count++;
+			totals.resident_size += image.resident_size;
+			totals.streamed_size += streamed_size;
+
+			total_resident += image.resident_size;
+			total_streamed += streamed_size;
+
+			buffer.append(utils::string::va("%s,%s,%u,%u,%u,%u,%i,%llu,%llu,%llu,%llu,%llu,%llu\n",
+				image.name.data(), format_name.data(), image.width, image.height, image.depth, image.levels,
+				DirectX::IsCompressed(static_cast<DXGI_FORMAT>(image.format)) ? 1 : 0, image.resident_size,
+				image.stream_sizes[0], image.stream_sizes[1], image.stream_sizes[2], image.stream_sizes[3],
+				get_total_size(image)));
+		}
+
+		const std::string path = utils::string::va("%s_images.csv", fastfile.data());
+		utils::io::write_file(path, buffer, false);
+
+		ZONETOOL_INFO("Image budget for \"%s\": %zu images, %s resident, %s streamed",
+			fastfile.data(), images.size(), format_size(total_resident).data(), format_size(total_streamed).data());
+
+		const auto printed = std::min(images.size(), static_cast<std::size_t>(max_printed_images));
+		for (auto i = 0u; i < printed; i++)
+		{
+			const auto& image = images[i];
+			ZONETOOL_INFO("  %-48s %-20s %5ux%-5u %2u mips  resident %-10s streamed %s",
+				image.name.data(), get_format_name(image.format).data(), image.width, image.height, image.levels,
+				format_size(image.resident_size).data(), format_size(get_streamed_size(image)).data());
+		}
+
+		std::vector<std::pair<std::string, format_total>> sorted_totals(format_totals.begin(), format_totals.end());
+		std::sort(sorted_totals.begin(), sorted_totals.end(), [](const auto& a, const auto& b)
+		{
+			return a.second.resident_size + a.second.streamed_size > b.second.resident_size + b.second.streamed_size;
+		});
+
+		for (const auto& [format_name, totals] : sorted_totals)
+		{
+			ZONETOOL_INFO("  %-20s %5zu images  resident %-10s streamed %s", format_name.data(), totals.count,
+				format_size(totals.resident_size).data(), format_size(totals.streamed_size).data());
+		}
+
+		ZONETOOL_INFO("Full image budget written to \"%s\"", path.data());
+	}
+}
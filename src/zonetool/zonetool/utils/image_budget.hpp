@@ -0,0 +1,54 @@
+#pragma once
+
+namespace zonetool::image_budget
+{
+	struct image_entry
+	{
+		std::string name;
+		std::uint32_t format;
+		std::uint32_t width;
+		std::uint32_t height;
+		std::uint32_t depth;
+		std::uint32_t levels;
+		std::uint64_t resident_size;
+		std::array<std::uint64_t, 4> stream_sizes;
+	};
+
+	// enabled with -image_budget, writes <fastfile>_images.csv next to the built fastfile
+	bool is_enabled();
+
+	void add(image_entry&& entry);
+	void report(const std::string& fastfile);
+
+	template <typename T, typename S>
+	void add_image(const std::string& name, const T* image, const std::array<S*, 4>& stream_files)
+	{
+		if (!is_enabled())
+		{
+			return;
+		}
+
+		image_entry entry{};
+		entry.name = name;
+		entry.format = static_cast<std::uint32_t>(image->imageFormat);
+		entry.width = image->width;
+		entry.height = image->height;
+		entry.depth = image->depth;
+		entry.levels = image->levelCount;
+		entry.resident_size = image->pixelData ? image->dataLen1 : 0;
+
+		if (image->streamed)
+		{
+			for (auto i = 0u; i < 4; i++)
+			{
+				const auto stream_file = stream_files[i];
+				if (stream_file && stream_file->offsetEnd > stream_file->offset)
+				{
+					entry.stream_sizes[i] = stream_file->offsetEnd - stream_file->offset;
+				}
+			}
+		}
+
+		add(std::move(entry));
+	}
+}
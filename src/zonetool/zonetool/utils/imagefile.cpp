@@ -2,7 +2,88 @@
 
 #include "imagefile.hpp"
 
+#include <utils/flags.hpp>
+
 namespace zonetool::imagefile
 {
+	namespace cache
+	{
+		namespace
+		{
+			constexpr auto cache_version = 1;
+			constexpr auto cache_folder = "zonetool_cache\\images\\";
+
+			std::atomic_uint32_t cache_hits{};
+			std::atomic_uint32_t cache_misses{};
+
+			bool is_enabled()
+			{
+				static const auto enabled = !utils::flags::has_flag("no_image_cache");
+				return enabled;
+			}
+
+			std::string get_cache_path(const std::string& data, const std::string& codec)
+			{
+				const auto codec_key = utils::string::va("%i:%s", cache_version, codec.data());
+				const auto codec_hash = utils::cryptography::jenkins_one_at_a_time::compute(codec_key);
+				const auto data_hash = utils::cryptography::sha1::compute(data, true);
+				return utils::string::va("%s%s_%08X.block", cache_folder, data_hash.data(), codec_hash);
+			}
+
+			void write_cache_file(const std::string& path, const std::string& data)
+			{
+				// write to a temporary file first so a concurrent or interrupted build never sees a partial block
+				const auto tmp_path = utils::string::va("%s.%u.tmp", path.data(), GetCurrentThreadId());
+				if (!utils::io::write_file(tmp_path, data))
+				{
+					return;
+				}
+
+				if (!utils::io::move_file(tmp_path, path))
+				{
+					utils::io::remove_file(tmp_path);
+				}
+			}
+		}
+
+		std::string get_compressed_block(const std::string& path, const std::string& codec, const compress_callback& compress)
+		{
+			const auto block = utils::io::read_file(path);
+			if (!is_enabled())
+			{
+				return compress(block);
+			}
+
+			const auto cache_path = get_cache_path(block, codec);
+
+			std::string compressed;
+			if (utils::io::read_file(cache_path, &compressed) && !compressed.empty())
+			{
+				++cache_hits;
+				return compressed;
+			}
+
+			++cache_misses;
+			compressed = compress(block);
+			write_cache_file(cache_path, compressed);
+
+			return compressed;
+		}
+
+		void reset_stats()
+		{
+			cache_hits = 0;
+			cache_misses = 0;
+		}
+
+		void print_stats()
+		{
+			if (!is_enabled())
+			{
+				return;
+			}
 
+			ZONETOOL_INFO("Image block cache: %u reused, %u compressed", cache_hits.load(), cache_misses.load());
+		}
+	}
 }
@@ -10,6 +10,18 @@
 
 namespace zonetool::imagefile
 {
+	namespace cache
+	{
+		using compress_callback = std::function<std::string(const std::string&)>;
+
+		// compressed stream blocks are stored under zonetool_cache\images, keyed by the hash of the
+		// source pixels and the codec id, so unchanged images are never recompressed between builds
+		std::string get_compressed_block(const std::string& path, const std::string& codec, const compress_callback& compress);
+
+		void reset_stats();
+		void print_stats();
+	}
+
 	template <typename T>
 	void compress_images(const std::vector<T*>& images)
 	{
@@ -20,6 +32,9 @@ namespace zonetool::imagefile
 
 		std::vector<std::thread> threads;
 
+		const auto codec = compression::lz4::get_block_codec_id();
+		cache::reset_stats();
+
 		const auto start_thread = [&](const int index, const int count)
 		{
 			threads.emplace_back([&, index, count]
@@ -35,9 +50,12 @@ namespace zonetool::imagefile
 							continue;
 						}
 
-						const auto block = utils::io::read_file(path.value());
-						const auto compressed = compression::lz4::compress_lz4_block(block);
-						image->image_stream_blocks[o].emplace(compressed);
+						auto compressed = cache::get_compressed_block(path.value(), codec, [](const std::string& block)
+						{
+							return compression::lz4::compress_lz4_block(block);
+						});
+
+						image->image_stream_blocks[o].emplace(std::move(compressed));
 					}
 				}
 			});
@@ -60,6 +78,8 @@ namespace zonetool::imagefile
 				thread.join();
 			}
 		}
+
+		cache::print_stats();
 	}
 
 	template <typename T>
@@ -82,6 +82,7 @@ namespace zonetool
 		bool create_directory(const std::string& name);
 		void add_path(const std::string& path, bool insert_at_beginning = false);
 		void add_paths_from_directory(const std::string& dir, bool insert_at_beginning = false);
+		std::vector<std::string> load_extra_search_paths(const std::string& dir);
 		std::vector<std::string>& get_search_paths();
 	}
 }
\ No newline at end of file
@@ -7,44 +7,134 @@
 
 namespace mapents
 {
-	void mapents_entity::add_var(const spawn_var& var)
+	namespace
 	{
-		this->vars.push_back(var);
+		bool match_key_value(const std::string_view& segment, std::string_view& key, std::string_view& value)
+		{
+			// greedy (.+) ends at the last ` "` that still has a closing quote after it,
+			// greedy (.*) ends at the last quote of the segment
+			const auto close = segment.rfind('"');
+			if (close == std::string_view::npos || close < 3)
+			{
+				return false;
+			}
+
+			const auto open = segment.rfind(" \"", close - 2);
+			if (open == std::string_view::npos || open == 0)
+			{
+				return false;
+			}
+
+			key = segment.substr(0, open);
+			value = segment.substr(open + 2, close - open - 2);
+			return true;
+		}
+
+		std::string to_lower(const std::string_view& text)
+		{
+			return utils::string::to_lower(std::string{text});
+		}
 	}
 
-	std::string mapents_entity::get(const std::string& key) const
+	bool split_key_value(const std::string_view& line, std::string_view& key, std::string_view& value)
 	{
-		for (const auto& var : this->vars)
+		// '.' never matched line terminators, so each \r separated segment is tried on its own
+		std::size_t start = 0;
+		while (start <= line.size())
 		{
-			if (var.key == key)
+			auto end = line.find('\r', start);
+			if (end == std::string_view::npos)
 			{
-				return var.value;
+				end = line.size();
+			}
+
+			if (match_key_value(line.substr(start, end - start), key, value))
+			{
+				return true;
 			}
+
+			start = end + 1;
 		}
 
-		return "";
+		return false;
+	}
+
+	std::uint32_t key_table::intern(const std::string_view& key)
+	{
+		const auto itr = this->ids_.find(key);
+		if (itr != this->ids_.end())
+		{
+			return itr->second;
+		}
+
+		const auto id = static_cast<std::uint32_t>(this->names_.size());
+		const auto& name = this->names_.emplace_back(key);
+		this->ids_.emplace(name, id);
+
+		return id;
+	}
+
+	std::optional<std::uint32_t> key_table::find(const std::string_view& key) const
+	{
+		const auto itr = this->ids_.find(key);
+		if (itr == this->ids_.end())
+		{
+			return {};
+		}
+
+		return itr->second;
 	}
 
-	void mapents_entity::clear()
+	const std::string& key_table::get_name(const std::uint32_t id) const
 	{
-		this->vars.clear();
+		return this->names_.at(id);
+	}
+
+	mapents_entity::mapents_entity(const std::shared_ptr<const entity_store>& store, const std::uint32_t first_var, const std::uint32_t num_vars)
+		: store_(store)
+		, first_var_(first_var)
+		, num_vars_(num_vars)
+	{
+	}
+
+	std::string mapents_entity::get(const std::string& key) const
+	{
+		const auto id = this->store_->keys.find(key);
+		if (!id.has_value())
+		{
+			return "";
+		}
+
+		for (auto i = this->first_var_; i < this->first_var_ + this->num_vars_; i++)
+		{
+			const auto& var = this->store_->vars[i];
+			if (var.key == id.value())
+			{
+				return var.value;
+			}
+		}
+
+		return "";
 	}
 
 	mapents_list parse(const std::string& data, const token_name_callback& get_token_name)
 	{
-		mapents_list list;
-		mapents_entity current_entity;
+		const auto store = std::make_shared<entity_store>();
+		std::vector<std::pair<std::uint32_t, std::uint32_t>> ranges;
+
+		line_reader reader(data);
+		std::string_view line;
 
-		const auto lines = utils::string::split(data, '\n');
 		auto in_map_ent = false;
 		auto in_comment = false;
+		std::uint32_t first_var = 0;
 
-		for (auto i = 0; i < lines.size(); i++)
+		while (reader.next(line))
 		{
-			auto line = lines[i];
+			const auto i = reader.line_index();
 			if (line.ends_with('\r'))
 			{
-				line.pop_back();
+				line.remove_suffix(1);
 			}
 
 			if (line.starts_with("/*") || line.ends_with("/*"))
@@ -66,7 +156,7 @@ namespace mapents
 
 			if (line[0] == '{' && !in_map_ent)
 			{
-				current_entity.clear();
+				first_var = static_cast<std::uint32_t>(store->vars.size());
 				in_map_ent = true;
 				continue;
 			}
@@ -78,7 +168,7 @@ namespace mapents
 
 			if (line[0] == '}' && in_map_ent)
 			{
-				list.entities.push_back(current_entity);
+				ranges.emplace_back(first_var, static_cast<std::uint32_t>(store->vars.size()) - first_var);
 				in_map_ent = false;
 				continue;
 			}
@@ -88,68 +178,82 @@ namespace mapents
 				ZONETOOL_FATAL("Unexpected '}' on line %i", i);
 			}
 
-			if (line[0] == '\n' || line[0] == '\0' || line[0] == '\n')
+			if (line[0] == '\0')
 			{
 				continue;
 			}
 
-			spawn_var var{};
+			const std::string line_str{line};
+
+			std::string_view key_view;
+			std::string_view value_view;
+
+			std::string key;
+			auto sl_string = false;
 
 			if (line.starts_with("0 \""))
 			{
-				std::regex expr(R"~(0 (.+) "(.*)")~");
-				std::smatch match{};
-				if (!std::regex_search(line, match, expr))
+				if (!split_key_value(line.substr(2), key_view, value_view))
 				{
-					ZONETOOL_ERROR("Failed to parse line %i (%s)", i, line.data());
+					ZONETOOL_ERROR("Failed to parse line %i (%s)", i, line_str.data());
 					continue;
 				}
 
-				var.key = utils::string::to_lower(match[1].str());
-				var.value = match[2].str();
-				var.sl_string = true;
+				key = to_lower(key_view);
+				sl_string = true;
 			}
 			else
 			{
-				std::regex expr(R"~((.+) "(.*)")~");
-				std::smatch match{};
-				if (!std::regex_search(line, match, expr))
+				if (!split_key_value(line, key_view, value_view))
 				{
-					ZONETOOL_ERROR("Failed to parse line %i (%s)", i, line.data());
+					ZONETOOL_ERROR("Failed to parse line %i (%s)", i, line_str.data());
 					continue;
 				}
 
-				var.key = utils::string::to_lower(match[1].str());
-				var.value = match[2].str();
+				key = to_lower(key_view);
 
-				if (utils::string::is_numeric(var.key) && !var.key.starts_with("\"") && !var.key.ends_with("\""))
+				if (utils::string::is_numeric(key) && !key.starts_with("\"") && !key.ends_with("\""))
 				{
-					var.key = get_token_name(static_cast<std::uint32_t>(std::atoi(var.key.data())));
+					key = get_token_name(static_cast<std::uint32_t>(std::atoi(key.data())));
 				}
-				else if (var.key.starts_with("\"") && var.key.ends_with("\"") && var.key.size() >= 3)
+				else if (key.starts_with("\"") && key.ends_with("\"") && key.size() >= 3)
 				{
-					var.key = var.key.substr(1, var.key.size() - 2);
+					key = key.substr(1, key.size() - 2);
 				}
 				else
 				{
-					ZONETOOL_ERROR("Invalid key ('%s') on line %i (%s)", var.key.data(), i, line.data());
+					ZONETOOL_ERROR("Invalid key ('%s') on line %i (%s)", key.data(), i, line_str.data());
 					continue;
 				}
 			}
 
-			if (var.key.size() <= 0)
+			if (key.size() <= 0)
 			{
-				ZONETOOL_ERROR("Invalid key ('%s') on line %i (%s)", var.key.data(), i, line.data());
+				ZONETOOL_ERROR("Invalid key ('%s') on line %i (%s)", key.data(), i, line_str.data());
 				continue;
 			}
 
-			if (var.value.size() <= 0)
+			if (value_view.size() <= 0)
 			{
-				ZONETOOL_ERROR("Invalid value ('%s') on line %i (%s)", var.value.data(), i, line.data());
+				ZONETOOL_ERROR("Invalid value ('%s') on line %i (%s)", "", i, line_str.data());
 				continue;
 			}
 
-			current_entity.add_var(var);
+			// vars outside of an entity were dropped once the next '{' was reached
+			if (!in_map_ent)
+			{
+				continue;
+			}
+
+			store->vars.emplace_back(spawn_var{store->keys.intern(key), std::string{value_view}, sl_string});
+		}
+
+		mapents_list list;
+		list.entities.reserve(ranges.size());
+
+		for (const auto& [first, count] : ranges)
+		{
+			list.entities.emplace_back(store, first, count);
 		}
 
 		return list;
@@ -1,27 +1,104 @@
 #pragma once
 
+#include <deque>
+
 namespace mapents
 {
 	using token_name_callback = std::function<std::string(const std::uint32_t)>;
 	using token_id_callback = std::function<std::uint32_t(const std::string&)>;
 
+	// iterates the lines of a buffer without copying, same lines as splitting on '\n'
+	class line_reader
+	{
+	public:
+		line_reader(const std::string_view& data)
+			: data_(data)
+		{
+		}
+
+		bool next(std::string_view& line)
+		{
+			if (this->pos_ >= this->data_.size())
+			{
+				return false;
+			}
+
+			auto end = this->data_.find('\n', this->pos_);
+			if (end == std::string_view::npos)
+			{
+				end = this->data_.size();
+			}
+
+			line = this->data_.substr(this->pos_, end - this->pos_);
+			this->pos_ = end + 1;
+			this->index_++;
+
+			return true;
+		}
+
+		// true once the last line has been returned
+		bool at_end() const
+		{
+			return this->pos_ >= this->data_.size();
+		}
+
+		// zero based index of the last returned line
+		int line_index() const
+		{
+			return static_cast<int>(this->index_) - 1;
+		}
+
+	private:
+		std::string_view data_;
+		std::size_t pos_{};
+		std::size_t index_{};
+	};
+
+	// splits a `key "value"` line, matching what searching it with the regex (.+) "(.*)" used to return
+	bool split_key_value(const std::string_view& line, std::string_view& key, std::string_view& value);
+
 	struct spawn_var
 	{
-		std::string key;
+		std::uint32_t key;
 		std::string value;
 		bool sl_string;
 	};
 
+	// keys are interned once per list and shared by all of its entities
+	class key_table
+	{
+	public:
+		std::uint32_t intern(const std::string_view& key);
+		std::optional<std::uint32_t> find(const std::string_view& key) const;
+		const std::string& get_name(std::uint32_t id) const;
+
+	private:
+		std::deque<std::string> names_;
+		std::unordered_map<std::string_view, std::uint32_t> ids_;
+	};
+
+	struct entity_store
+	{
+		key_table keys;
+		std::vector<spawn_var> vars;
+	};
+
 	class mapents_entity
 	{
 	public:
-		void clear();
-		void add_var(const spawn_var& var);
+		mapents_entity(const std::shared_ptr<const entity_store>& store, std::uint32_t first_var, std::uint32_t num_vars);
 
 		std::string get(const std::string& key) const;
 
+		std::uint32_t size() const
+		{
+			return this->num_vars_;
+		}
+
 	private:
-		std::vector<spawn_var> vars;
+		std::shared_ptr<const entity_store> store_;
+		std::uint32_t first_var_;
+		std::uint32_t num_vars_;
 	};
 
 	struct mapents_list
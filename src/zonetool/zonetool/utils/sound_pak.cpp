@@ -0,0 +1,109 @@
+#include <std_include.hpp>
+
+#include "sound_pak.hpp"
+#include "utils.hpp"
+
+#include <utils/mapped_file.hpp>
+
+namespace zonetool::sound_pak
+{
+	namespace
+	{
+		struct pending_sound
+		{
+			std::string name;
+			std::string pak;
+			std::uint64_t offset;
+			std::uint64_t length;
+			read_callback callback;
+		};
+
+		std::mutex mutex;
+		std::unordered_map<std::string, std::unique_ptr<utils::mapped_file>> paks;
+		std::vector<pending_sound> pending;
+
+		const utils::mapped_file* get_pak(const std::string& pak)
+		{
+			std::lock_guard _(mutex);
+
+			auto& file = paks[pak];
+			if (!file)
+			{
+				// same lookup as filesystem::file::open for zone files
+				file = std::make_unique<utils::mapped_file>();
+				file->open(filesystem::get_zone_path(pak) + pak);
+			}
+
+			return file->is_open() ? file.get() : nullptr;
+		}
+	}
+
+	std::optional<sound_data> read(const std::string& pak, const std::uint64_t offset, const std::uint64_t length)
+	{
+		const auto* file = get_pak(pak);
+		if (!file)
+		{
+			ZONETOOL_ERROR("Failed to open soundfile: %s", pak.data());
+			return {};
+		}
+
+		if (offset > file->size() || length > file->size() - offset)
+		{
+			ZONETOOL_ERROR("Sound data at offset %llu (length %llu) is out of bounds of soundfile: %s", offset, length, pak.data());
+			return {};
+		}
+
+		const auto* data = reinterpret_cast<const char*>(file->data() + offset);
+		if (length >= 4 && !std::strncmp(data, "fLaC", 4))
+		{
+			return sound_data{{data, static_cast<std::size_t>(length)}, true};
+		}
+
+		// not flac, so it's wave data preceded by its riff header
+		if (offset < wave_header_size || std::strncmp(data - wave_header_size, "RIFF", 4))
+		{
+			ZONETOOL_ERROR("Failed to get wave header from soundfile: %s, offset: %llu", pak.data(), offset);
+			return {};
+		}
+
+		return sound_data{{data - wave_header_size, static_cast<std::size_t>(length + wave_header_size)}, false};
+	}
+
+	void enqueue(const std::string& name, const std::string& pak, const std::uint64_t offset, const std::uint64_t length, read_callback&& callback)
+	{
+		std::lock_guard _(mutex);
+		pending.emplace_back(pending_sound{name, pak, offset, length, std::move(callback)});
+	}
+
+	void flush()
+	{
+		std::vector<pending_sound> sounds;
+
+		{
+			std::lock_guard _(mutex);
+			sounds = std::move(pending);
+			pending.clear();
+		}
+
+		// reading in offset order keeps multi-gigabyte paks streaming forward instead of seeking around
+		std::sort(sounds.begin(), sounds.end(), [](const pending_sound& a, const pending_sound& b)
+		{
+			return a.pak != b.pak ? a.pak < b.pak : a.offset < b.offset;
+		});
+
+		for (const auto& sound : sounds)
+		{
+			const auto data = read(sound.pak, sound.offset, sound.length);
+			if (!data.has_value())
+			{
+				ZONETOOL_ERROR("%s: failed to get data from soundfile", sound.name.data());
+				continue;
+			}
+
+			sound.callback(data.value());
+		}
+
+		std::lock_guard _(mutex);
+		paks.clear();
+	}
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <functional>
+
+namespace zonetool::sound_pak
+{
+	// pcm entries are stored right after their wave header, which is returned along with the data
+	constexpr auto wave_header_size = 46ull;
+
+	struct sound_data
+	{
+		std::string_view data;
+		bool is_flac;
+	};
+
+	using read_callback = std::function<void(const sound_data&)>;
+
+	// views a packed sound straight from the mapped soundfile pak, paks stay mapped until flush
+	std::optional<sound_data> read(const std::string& pak, std::uint64_t offset, std::uint64_t length);
+
+	// queues a packed sound, queued sounds are read in pak and offset order on flush
+	void enqueue(const std::string& name, const std::string& pak, std::uint64_t offset, std::uint64_t length, read_callback&& callback);
+
+	// reads every queued sound and unmaps the paks
+	void flush();
+}
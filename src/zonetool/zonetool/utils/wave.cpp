@@ -0,0 +1,85 @@
+#include <std_include.hpp>
+
+#include "wave.hpp"
+
+namespace zonetool::wave
+{
+	namespace
+	{
+		constexpr std::uint32_t riff_id = 0x46464952; // RIFF
+		constexpr std::uint32_t wave_id = 0x45564157; // WAVE
+		constexpr std::uint32_t fmt_id = 0x20746D66; // fmt
+		constexpr std::uint32_t data_id = 0x61746164; // data
+
+		constexpr auto chunk_header_size = 8u;
+		constexpr auto fmt_size = 16u;
+
+		template <typename T>
+		T read(const std::string_view& data, const std::size_t offset)
+		{
+			T value{};
+			std::memcpy(&value, data.data() + offset, sizeof(T));
+			return value;
+		}
+	}
+
+	wave_stream parse(const std::string_view& data)
+	{
+		if (data.size() < 12 || read<std::uint32_t>(data, 0) != riff_id)
+		{
+			throw std::runtime_error("Invalid RIFF Header.");
+		}
+
+		if (read<std::uint32_t>(data, 8) != wave_id)
+		{
+			throw std::runtime_error("Invalid WAVE Header.");
+		}
+
+		wave_stream result{};
+		auto has_fmt = false;
+
+		auto pos = static_cast<std::size_t>(12);
+		while (pos + chunk_header_size <= data.size())
+		{
+			const auto chunk_id = read<std::uint32_t>(data, pos);
+			const auto chunk_size = static_cast<std::size_t>(read<std::uint32_t>(data, pos + 4));
+			const auto chunk_start = pos + chunk_header_size;
+
+			if (chunk_id == data_id)
+			{
+				if (!has_fmt || !result.channels || !result.bits_per_sample)
+				{
+					throw std::runtime_error("Wave data chunk has no valid fmt chunk in front of it.");
+				}
+
+				// clamped to the end of the file, some writers leave the size of the data chunk unset
+				result.data = data.substr(chunk_start, chunk_size);
+				return result;
+			}
+
+			if (chunk_size > data.size() - chunk_start)
+			{
+				throw std::runtime_error("Wave chunk exceeds the file size.");
+			}
+
+			if (chunk_id == fmt_id && chunk_size >= fmt_size)
+			{
+				const auto format = read<std::uint16_t>(data, chunk_start);
+				if (format != format_pcm)
+				{
+					throw std::runtime_error("Invalid wave format " + std::to_string(format) + ".");
+				}
+
+				result.channels = read<std::uint16_t>(data, chunk_start + 2);
+				result.sample_rate = read<std::uint32_t>(data, chunk_start + 4);
+				result.block_align = read<std::uint16_t>(data, chunk_start + 12);
+				result.bits_per_sample = read<std::uint16_t>(data, chunk_start + 14);
+				has_fmt = true;
+			}
+
+			pos = chunk_start + chunk_size;
+		}
+
+		throw std::runtime_error("Could not read sound data.");
+	}
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+// only depends on the standard library so it can be built and tested on its own
+namespace zonetool::wave
+{
+	constexpr unsigned short format_pcm = 1;
+
+	struct wave_stream
+	{
+		unsigned short channels;
+		unsigned int sample_rate;
+		unsigned short block_align;
+		unsigned short bits_per_sample;
+		std::string_view data;
+	};
+
+	// reads the fmt and data chunks of a riff file, throws std::runtime_error if it is not uncompressed pcm
+	wave_stream parse(const std::string_view& data);
+}
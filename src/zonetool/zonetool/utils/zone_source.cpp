@@ -0,0 +1,139 @@
+#include <std_include.hpp>
+
+#include "zone_source.hpp"
+#include "csv.hpp"
+
+#include <utils/string.hpp>
+
+namespace zonetool::zone_source
+{
+	namespace
+	{
+		struct cache_entry
+		{
+			std::filesystem::file_time_type write_time;
+			std::uintmax_t size;
+			std::shared_ptr<const source> source;
+		};
+
+		std::mutex cache_mutex;
+		std::unordered_map<std::string, cache_entry> cache;
+
+		thread_local std::vector<std::string> include_stack;
+
+		const std::unordered_map<std::string, instruction_type> directives =
+		{
+			{"require", instruction_type::require},
+			{"include", instruction_type::include},
+			{"ignore", instruction_type::ignore},
+			{"reference", instruction_type::reference},
+			{"iterate", instruction_type::iterate},
+			{"addpath", instruction_type::addpath},
+			{"addpaths", instruction_type::addpaths},
+		};
+
+		bool is_comment_or_empty(const char* field)
+		{
+			return field[0] == '\0' || field[0] == '#' || (field[0] == '/' && field[1] == '/');
+		}
+
+		std::shared_ptr<const source> parse(const std::string& csv, const std::string& path)
+		{
+			auto parser = csv::parser(path, ',');
+
+			auto result = std::make_shared<source>();
+			result->name = csv;
+
+			const auto rows = parser.get_rows();
+			const auto num_rows = parser.get_num_rows();
+			result->instructions.reserve(num_rows);
+
+			for (auto row_index = 0; row_index < num_rows; row_index++)
+			{
+				const auto* row = rows[row_index];
+				if (!row || !row->fields || is_comment_or_empty(row->fields[0]))
+				{
+					continue;
+				}
+
+				instruction entry{};
+				entry.line = static_cast<std::size_t>(row_index) + 1;
+				entry.fields.assign(row->fields, row->fields + row->num_fields);
+
+				const auto directive = directives.find(entry.fields[0]);
+				entry.type = directive != directives.end() ? directive->second : instruction_type::asset;
+
+				result->instructions.emplace_back(std::move(entry));
+			}
+
+			return result;
+		}
+	}
+
+	const std::string& instruction::field(const std::size_t index) const
+	{
+		static const std::string empty;
+		return index < this->fields.size() ? this->fields[index] : empty;
+	}
+
+	std::shared_ptr<const source> get(const std::string& csv)
+	{
+		const auto path = "zone_source\\"s + csv + ".csv";
+
+		std::error_code ec{};
+		const auto write_time = std::filesystem::last_write_time(path, ec);
+		if (ec)
+		{
+			return {};
+		}
+
+		const auto size = std::filesystem::file_size(path, ec);
+		if (ec)
+		{
+			return {};
+		}
+
+		const auto key = utils::string::to_lower(csv);
+
+		{
+			std::lock_guard _(cache_mutex);
+			const auto itr = cache.find(key);
+			if (itr != cache.end() && itr->second.write_time == write_time && itr->second.size == size)
+			{
+				return itr->second.source;
+			}
+		}
+
+		// parse outside of the lock, two threads racing on the same file just produce the same result
+		auto result = parse(csv, path);
+
+		std::lock_guard _(cache_mutex);
+		cache[key] = {write_time, size, result};
+		return result;
+	}
+
+	include_scope::include_scope(const std::string& csv)
+	{
+		auto name = utils::string::to_lower(csv);
+
+		const auto itr = std::find(include_stack.begin(), include_stack.end(), name);
+		if (itr != include_stack.end())
+		{
+			std::string chain;
+			for (auto i = itr; i != include_stack.end(); ++i)
+			{
+				chain.append(*i).append(" -> ");
+			}
+
+			chain.append(name);
+			throw std::runtime_error(utils::string::va("Include cycle detected in zone source: %s", chain.data()));
+		}
+
+		include_stack.emplace_back(std::move(name));
+	}
+
+	include_scope::~include_scope()
+	{
+		include_stack.pop_back();
+	}
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+namespace zonetool::zone_source
+{
+	enum class instruction_type
+	{
+		asset,
+		require,
+		include,
+		ignore,
+		reference,
+		iterate,
+		addpath,
+		addpaths,
+	};
+
+	struct instruction
+	{
+		instruction_type type;
+		std::vector<std::string> fields;
+		std::size_t line;
+
+		std::size_t num_fields() const
+		{
+			return this->fields.size();
+		}
+
+		// missing fields read as an empty string
+		const std::string& field(const std::size_t index) const;
+	};
+
+	struct source
+	{
+		std::string name;
+		std::vector<instruction> instructions;
+	};
+
+	// zone_source\<csv>.csv, parsed once and reused until the file changes on disk, nullptr if it doesn't exist
+	std::shared_ptr<const source> get(const std::string& csv);
+
+	// tracks the include chain of the calling thread, throws when a csv ends up including itself
+	class include_scope
+	{
+	public:
+		include_scope(const std::string& csv);
+		~include_scope();
+
+		include_scope(const include_scope&) = delete;
+		include_scope& operator=(const include_scope&) = delete;
+	};
+}
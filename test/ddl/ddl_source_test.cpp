@@ -0,0 +1,127 @@
+#include <std_include.hpp>
+
+#include "test.hpp"
+
+#include <zonetool/utils/ddl_source.hpp>
+
+namespace ddl = zonetool::ddl_source;
+
+namespace
+{
+	// the error message, empty when validation passed
+	std::string validate(const std::string& source, std::vector<std::string>* warnings = nullptr)
+	{
+		try
+		{
+			ddl::validate(ddl::parse(source, "test.ddl"), "test.ddl", warnings);
+		}
+		catch (const std::runtime_error& e)
+		{
+			return e.what();
+		}
+
+		return {};
+	}
+
+	void test_parse()
+	{
+		const auto file = ddl::parse(
+			"// comment\n"
+			"[userflags 4]\n"
+			"version 2\n"
+			"{\n"
+			"	enum weapon { pistol, rifle }\n"
+			"	struct root\n"
+			"	{\n"
+			"		uint:5(20) count;\n"
+			"		string(16) name;\n"
+			"		int values[3];\n"
+			"		bool owned[weapon];\n"
+			"	};\n"
+			"}\n", "test.ddl");
+
+		CHECK(file.versions.size() == 1);
+		if (file.versions.size() != 1)
+		{
+			return;
+		}
+
+		const auto& version = file.versions[0];
+		CHECK(version.version == 2);
+		CHECK(version.line == 3);
+		CHECK(version.decorations.size() == 1 && version.decorations[0].name == "userflags" && version.decorations[0].value == 4u);
+		CHECK(version.enums.size() == 1 && version.enums[0].members == std::vector<std::string>({"pistol", "rifle"}));
+		CHECK(version.structs.size() == 1 && version.structs[0].members.size() == 4);
+		if (version.structs.size() != 1 || version.structs[0].members.size() != 4)
+		{
+			return;
+		}
+
+		const auto& members = version.structs[0].members;
+		CHECK(members[0].type == "uint" && members[0].bits == 5u && members[0].limit == 20u && members[0].line == 8);
+		CHECK(members[1].type == "string" && members[1].limit == 16u && !members[1].bits);
+		CHECK(members[2].array_size == 3u && members[2].array_enum.empty());
+		CHECK(!members[3].array_size && members[3].array_enum == "weapon");
+	}
+
+	void test_duplicates()
+	{
+		std::vector<std::string> warnings;
+		const auto error = validate(
+			"version 1\n"
+			"{\n"
+			"	enum color { red, green }\n"
+			"	enum color { blue }\n"
+			"	struct item { color tint; };\n"
+			"	struct item { missing value; };\n"
+			"	struct root { item items[color]; };\n"
+			"}\n", &warnings);
+
+		// the second item is never built, so its unknown type doesn't matter
+		CHECK_MSG(error.empty(), error);
+		CHECK(warnings.size() == 2);
+		CHECK(warnings.size() == 2 && warnings[0] == "test.ddl:4: duplicate enum 'color', the first definition is used in version 1");
+		CHECK(warnings.size() == 2 && warnings[1] == "test.ddl:6: duplicate struct 'item', the first definition is used in version 1");
+
+		// warnings are optional
+		CHECK(validate("version 1 { enum a { x } enum a { y } struct root { a value; }; }").empty());
+	}
+
+	void test_errors()
+	{
+		const std::pair<const char*, const char*> cases[] =
+		{
+			{"version 1 { struct root { missing value; }; }", "test.ddl:1: unknown type 'missing' in version 1"},
+			{"version 1 { struct root { int values[missing]; }; }", "test.ddl:1: unknown enum 'missing' used as array size in version 1"},
+			{"version 1 { struct other { int value; }; }", "test.ddl:1: root struct not found in version 1"},
+			{"version 1 { struct root { int a; int a; }; }", "test.ddl:1: duplicate member 'a' in struct 'root' in version 1"},
+			{"version 1 {\nstruct root { a value; };\nstruct a { root value; };\n}", "test.ddl:3: struct 'root' contains itself in version 1"},
+			{"version 1 { enum int { x } struct root { int value; }; }", "test.ddl:1: enum 'int' shadows a builtin type in version 1"},
+			{"version 1 { enum a { x } struct a { int value; }; struct root { a value; }; }", "test.ddl:1: struct 'a' shadows another type in version 1"},
+			{"version 1 { struct root { int values[0]; }; }", "test.ddl:1: array 'values' has a size of 0"},
+			{"version 1 {\n/* open", "test.ddl:2: unterminated comment"},
+		};
+
+		for (const auto& [source, expected] : cases)
+		{
+			const auto error = validate(source);
+			CHECK_MSG(error == expected, source + " gave \""s + error + "\"");
+		}
+	}
+}
+
+int main()
+{
+	try
+	{
+		test_parse();
+		test_duplicates();
+		test_errors();
+	}
+	catch (const std::exception& e)
+	{
+		test::fail(__FILE__, __LINE__, std::string("unexpected exception: ") + e.what());
+	}
+
+	return test::result("ddl_source_test");
+}
@@ -0,0 +1,340 @@
+#include <std_include.hpp>
+
+#include "test.hpp"
+
+#include <utils/dds.hpp>
+
+namespace dds = utils::dds;
+
+namespace
+{
+	constexpr std::uint32_t DDSD_DEPTH = 0x800000;
+	constexpr std::uint32_t DDSD_MIPMAPCOUNT = 0x20000;
+	constexpr std::uint32_t DDPF_FOURCC = 0x4;
+	constexpr std::uint32_t DDPF_RGB = 0x40;
+	constexpr std::uint32_t DDSCAPS2_CUBEMAP = 0x200;
+	constexpr std::uint32_t DDSCAPS2_CUBEMAP_ALLFACES = 0xFC00;
+	constexpr std::uint32_t DDS_RESOURCE_MISC_TEXTURECUBE = 0x4;
+
+	constexpr std::uint32_t FORMAT_R8G8B8A8_UNORM = 28;
+	constexpr std::uint32_t FORMAT_R8_UNORM = 61;
+	constexpr std::uint32_t FORMAT_BC1_UNORM = 71;
+	constexpr std::uint32_t FORMAT_BC3_UNORM = 77;
+
+	constexpr std::uint32_t four_cc(const char (&name)[5])
+	{
+		return static_cast<std::uint32_t>(name[0]) | (static_cast<std::uint32_t>(name[1]) << 8) |
+			(static_cast<std::uint32_t>(name[2]) << 16) | (static_cast<std::uint32_t>(name[3]) << 24);
+	}
+
+	// the fields of the DDS header and the optional DX10 extension that the tests change
+	struct image_desc
+	{
+		std::uint32_t flags = 0;
+		std::uint32_t width = 0;
+		std::uint32_t height = 0;
+		std::uint32_t depth = 0;
+		std::uint32_t mip_map_count = 0;
+		std::uint32_t pf_flags = 0;
+		std::uint32_t four_cc = 0;
+		std::uint32_t rgb_bit_count = 0;
+		std::uint32_t masks[4]{};
+		std::uint32_t caps2 = 0;
+
+		bool dx10 = false;
+		std::uint32_t dxgi_format = 0;
+		std::uint32_t resource_dimension = 3;
+		std::uint32_t misc_flag = 0;
+		std::uint32_t array_size = 1;
+	};
+
+	std::string make_dds(const image_desc& desc, const std::size_t payload_size)
+	{
+		std::vector<std::uint32_t> words;
+		words.emplace_back(four_cc("DDS "));
+		words.emplace_back(124);
+		words.emplace_back(desc.flags);
+		words.emplace_back(desc.height);
+		words.emplace_back(desc.width);
+		words.emplace_back(0);
+		words.emplace_back(desc.depth);
+		words.emplace_back(desc.mip_map_count);
+		words.resize(words.size() + 11);
+		words.emplace_back(32);
+		words.emplace_back(desc.dx10 ? DDPF_FOURCC : desc.pf_flags);
+		words.emplace_back(desc.dx10 ? four_cc("DX10") : desc.four_cc);
+		words.emplace_back(desc.rgb_bit_count);
+		words.insert(words.end(), std::begin(desc.masks), std::end(desc.masks));
+		words.emplace_back(0x1000);
+		words.emplace_back(desc.caps2);
+		words.resize(words.size() + 3);
+
+		if (desc.dx10)
+		{
+			words.emplace_back(desc.dxgi_format);
+			words.emplace_back(desc.resource_dimension);
+			words.emplace_back(desc.misc_flag);
+			words.emplace_back(desc.array_size);
+			words.emplace_back(0);
+		}
+
+		std::string result(reinterpret_cast<const char*>(words.data()), words.size() * sizeof(std::uint32_t));
+		for (auto i = 0u; i < payload_size; i++)
+		{
+			result.push_back(static_cast<char>(i * 7));
+		}
+
+		return result;
+	}
+
+	image_desc dxt1(const std::uint32_t width, const std::uint32_t height, const std::uint32_t mips)
+	{
+		image_desc desc{};
+		desc.width = width;
+		desc.height = height;
+		desc.mip_map_count = mips;
+		desc.pf_flags = DDPF_FOURCC;
+		desc.four_cc = four_cc("DXT1");
+		return desc;
+	}
+
+	image_desc rgba(const std::uint32_t width, const std::uint32_t height, const std::uint32_t mips)
+	{
+		image_desc desc{};
+		desc.width = width;
+		desc.height = height;
+		desc.mip_map_count = mips;
+		desc.pf_flags = DDPF_RGB;
+		desc.rgb_bit_count = 32;
+		desc.masks[0] = 0x000000FF;
+		desc.masks[1] = 0x0000FF00;
+		desc.masks[2] = 0x00FF0000;
+		desc.masks[3] = 0xFF000000;
+		return desc;
+	}
+
+	image_desc dx10(const std::uint32_t format, const std::uint32_t width, const std::uint32_t height, const std::uint32_t mips)
+	{
+		image_desc desc{};
+		desc.flags = DDSD_MIPMAPCOUNT;
+		desc.width = width;
+		desc.height = height;
+		desc.mip_map_count = mips;
+		desc.dx10 = true;
+		desc.dxgi_format = format;
+		return desc;
+	}
+
+	bool parse(const std::string& data, dds::texture_info* info, std::string* error = nullptr)
+	{
+		return dds::parse_header(data.data(), data.size(), info, error);
+	}
+
+	std::string parse_error(const std::string& data)
+	{
+		dds::texture_info info{};
+		std::string error;
+		return parse(data, &info, &error) ? "" : error;
+	}
+
+	void test_mip_count()
+	{
+		// 16x16 dxt1: 4x4, 2x2 and three 1x1 blocks of 8 bytes
+		constexpr auto full_size = 128 + 32 + 8 + 8 + 8;
+
+		// the count is used without DDSD_MIPMAPCOUNT, like DirectXTex does
+		{
+			const auto data = make_dds(dxt1(16, 16, 5), full_size);
+			dds::texture_info info{};
+			CHECK(parse(data, &info));
+			CHECK(info.mip_levels == 5);
+			CHECK(info.format == FORMAT_BC1_UNORM);
+			CHECK(info.payload_offset == 128);
+			CHECK(info.payload_size == full_size);
+		}
+
+		{
+			auto desc = dxt1(16, 16, 5);
+			desc.flags = DDSD_MIPMAPCOUNT;
+			dds::texture_info info{};
+			CHECK(parse(make_dds(desc, full_size), &info));
+			CHECK(info.mip_levels == 5);
+		}
+
+		// a missing count means a single mip
+		{
+			dds::texture_info info{};
+			CHECK(parse(make_dds(dxt1(16, 16, 0), 128), &info));
+			CHECK(info.mip_levels == 1);
+			CHECK(info.payload_size == 128);
+		}
+
+		// only the first mip stored under an unflagged count has to fail, not drop the rest
+		CHECK(parse_error(make_dds(dxt1(16, 16, 5), 128)) == "pixel data is truncated");
+
+		// more mips than the full chain has
+		CHECK(parse_error(make_dds(dxt1(16, 16, 6), 4096)) == "mip count exceeds the full mip chain");
+		CHECK(parse_error(make_dds(dxt1(16, 4, 6), 4096)) == "mip count exceeds the full mip chain");
+		CHECK(parse_error(make_dds(dxt1(1, 1, 2), 4096)) == "mip count exceeds the full mip chain");
+		CHECK(parse_error(make_dds(dxt1(1, 1, 1), 8)).empty());
+	}
+
+	void test_dx10()
+	{
+		// bc3 8x4 array of 3: 2x1, then three 1x1 blocks of 16 bytes per item
+		{
+			auto desc = dx10(FORMAT_BC3_UNORM, 8, 4, 4);
+			desc.array_size = 3;
+
+			dds::texture_info info{};
+			CHECK(parse(make_dds(desc, 240), &info));
+			CHECK(info.payload_offset == 148);
+			CHECK(info.array_size == 3);
+			CHECK(info.mip_levels == 4);
+			CHECK(!info.is_cubemap);
+			CHECK(info.dimension == dds::TEXTURE_DIMENSION_2D);
+			CHECK(info.payload_size == 240);
+
+			CHECK(parse_error(make_dds(desc, 239)) == "pixel data is truncated");
+		}
+
+		// cube arrays count every face
+		{
+			auto desc = dx10(FORMAT_R8G8B8A8_UNORM, 4, 4, 3);
+			desc.misc_flag = DDS_RESOURCE_MISC_TEXTURECUBE;
+			desc.array_size = 2;
+
+			dds::texture_info info{};
+			CHECK(parse(make_dds(desc, 12 * (64 + 16 + 4)), &info));
+			CHECK(info.is_cubemap);
+			CHECK(info.array_size == 12);
+			CHECK(info.payload_size == 12 * (64 + 16 + 4));
+		}
+
+		// volumes shrink in depth too
+		{
+			auto desc = dx10(FORMAT_R8_UNORM, 4, 4, 3);
+			desc.flags |= DDSD_DEPTH;
+			desc.depth = 4;
+			desc.resource_dimension = 4;
+
+			dds::texture_info info{};
+			CHECK(parse(make_dds(desc, 64 + 8 + 1), &info));
+			CHECK(info.dimension == dds::TEXTURE_DIMENSION_3D);
+			CHECK(info.depth == 4);
+			CHECK(info.payload_size == 64 + 8 + 1);
+
+			// the depth counts towards the full chain
+			desc.width = 2;
+			desc.height = 2;
+			desc.depth = 8;
+			desc.mip_map_count = 4;
+			CHECK(parse_error(make_dds(desc, 4096)).empty());
+			desc.mip_map_count = 5;
+			CHECK(parse_error(make_dds(desc, 4096)) == "mip count exceeds the full mip chain");
+		}
+
+		{
+			auto desc = dx10(FORMAT_R8_UNORM, 4, 4, 1);
+			desc.array_size = 0;
+			CHECK(parse_error(make_dds(desc, 16)) == "invalid DX10 array size");
+
+			desc.array_size = 1;
+			desc.resource_dimension = 5;
+			CHECK(parse_error(make_dds(desc, 16)) == "unknown DX10 resource dimension");
+		}
+	}
+
+	void test_legacy_cubemaps()
+	{
+		auto desc = rgba(2, 2, 1);
+		desc.caps2 = DDSCAPS2_CUBEMAP | DDSCAPS2_CUBEMAP_ALLFACES;
+
+		dds::texture_info info{};
+		CHECK(parse(make_dds(desc, 6 * 16), &info));
+		CHECK(info.format == FORMAT_R8G8B8A8_UNORM);
+		CHECK(info.is_cubemap);
+		CHECK(info.array_size == 6);
+		CHECK(info.payload_size == 6 * 16);
+
+		desc.caps2 = DDSCAPS2_CUBEMAP | 0x400;
+		CHECK(parse_error(make_dds(desc, 6 * 16)) == "partial cubemaps are not supported");
+	}
+
+	void test_truncated()
+	{
+		const auto data = make_dds(dx10(FORMAT_R8_UNORM, 4, 4, 1), 16);
+
+		CHECK(parse_error(data.substr(0, 100)) == "file is too small to contain a DDS header");
+		CHECK(parse_error(data.substr(0, 140)) == "file is too small to contain a DX10 header");
+		CHECK(parse_error(data.substr(0, 148)) == "pixel data is truncated");
+		CHECK(parse_error(data.substr(0, data.size() - 1)) == "pixel data is truncated");
+		CHECK(parse_error(data).empty());
+
+		auto bad_magic = data;
+		bad_magic[0] = 'X';
+		CHECK(parse_error(bad_magic) == "invalid DDS magic");
+
+		auto bad_size = data;
+		bad_size[4] = 0;
+		CHECK(parse_error(bad_size) == "invalid DDS header size");
+
+		CHECK(parse_error(make_dds(dxt1(0, 16, 1), 128)) == "invalid image dimensions");
+
+		auto unsupported = rgba(4, 4, 1);
+		unsupported.rgb_bit_count = 24;
+		CHECK(parse_error(make_dds(unsupported, 64)) == "legacy pixel format requires a conversion");
+	}
+
+	void test_file()
+	{
+		const auto path = std::filesystem::temp_directory_path() / "zonetool_dds_test.dds";
+		const auto data = make_dds(dxt1(16, 16, 5), 184);
+
+		{
+			std::ofstream stream(path, std::ios::binary);
+			stream.write(data.data(), static_cast<std::streamsize>(data.size()));
+		}
+
+		{
+			const dds::file file(path.string());
+			CHECK_MSG(file.is_valid(), file.get_error());
+			CHECK(file.get_payload() == std::string_view(data).substr(128));
+		}
+
+		{
+			std::ofstream stream(path, std::ios::binary);
+			stream.write(data.data(), static_cast<std::streamsize>(data.size() - 8));
+		}
+
+		{
+			const dds::file file(path.string());
+			CHECK(!file.is_valid());
+			CHECK(file.get_error() == "pixel data is truncated");
+			CHECK(file.get_payload().empty());
+		}
+
+		std::filesystem::remove(path);
+
+		const dds::file missing((path.string() + ".missing"));
+		CHECK(!missing.is_valid());
+	}
+}
+
+int main()
+{
+	try
+	{
+		test_mip_count();
+		test_dx10();
+		test_legacy_cubemaps();
+		test_truncated();
+		test_file();
+	}
+	catch (const std::exception& e)
+	{
+		test::fail(__FILE__, __LINE__, std::string("unexpected exception: ") + e.what());
+	}
+
+	return test::result("dds_test");
+}
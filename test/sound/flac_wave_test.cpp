@@ -0,0 +1,359 @@
+#include <std_include.hpp>
+
+#include "test.hpp"
+
+#include <zonetool/utils/flac.hpp>
+#include <zonetool/utils/wave.hpp>
+
+namespace flac = zonetool::flac;
+namespace wave = zonetool::wave;
+
+namespace
+{
+	// msb first, the way flac stores its header fields
+	class bit_writer
+	{
+	public:
+		void write(const std::uint64_t value, const unsigned int bits)
+		{
+			for (auto i = bits; i > 0; i--)
+			{
+				if (this->bit_ % 8 == 0)
+				{
+					this->buffer_.push_back(0);
+				}
+
+				if ((value >> (i - 1)) & 1)
+				{
+					this->buffer_.back() |= static_cast<char>(0x80 >> (this->bit_ % 8));
+				}
+
+				this->bit_++;
+			}
+		}
+
+		const std::string& get() const
+		{
+			return this->buffer_;
+		}
+
+	private:
+		std::string buffer_;
+		std::size_t bit_ = 0;
+	};
+
+	void append_be32(std::string& buffer, const std::uint32_t value)
+	{
+		for (auto shift = 24; shift >= 0; shift -= 8)
+		{
+			buffer.push_back(static_cast<char>(value >> shift));
+		}
+	}
+
+	void append_le(std::string& buffer, const std::uint32_t value, const unsigned int bytes)
+	{
+		for (auto i = 0u; i < bytes; i++)
+		{
+			buffer.push_back(static_cast<char>(value >> (i * 8)));
+		}
+	}
+
+	std::string make_streaminfo(const flac::stream_info& info)
+	{
+		bit_writer writer;
+		writer.write(info.min_block_size, 16);
+		writer.write(info.max_block_size, 16);
+		writer.write(0x123, 24); // min frame size
+		writer.write(0x456, 24); // max frame size
+		writer.write(info.sample_rate, 20);
+		writer.write(info.channels - 1, 3);
+		writer.write(info.bits_per_sample - 1, 5);
+		writer.write(info.num_samples, 36);
+
+		auto result = writer.get();
+		result.append(16, '\x5A'); // md5
+		return result;
+	}
+
+	std::string make_block(const flac::block_type_t type, const bool is_last, const std::string& data)
+	{
+		std::string result;
+		append_be32(result, (is_last ? 0x80000000u : 0) | (static_cast<std::uint32_t>(type) << 24) |
+			static_cast<std::uint32_t>(data.size()));
+		return result + data;
+	}
+
+	const flac::stream_info sample_info{1024, 1024, 48000, 2, 16, 123456};
+
+	std::string frames(const std::size_t size)
+	{
+		std::string result;
+		for (auto i = 0u; i < size; i++)
+		{
+			result.push_back(static_cast<char>(0xFF - i));
+		}
+
+		return result;
+	}
+
+	std::string fsiz_block(const bool is_last, const std::uint32_t size)
+	{
+		std::string block;
+		append_be32(block, (is_last ? 0x82000008u : 0x02000008u));
+		block.append("fsiz");
+		append_le(block, size, 4);
+		return block;
+	}
+
+	void check_info(const flac::stream_info& info, const std::string& label)
+	{
+		CHECK_MSG(info.min_block_size == sample_info.min_block_size, label);
+		CHECK_MSG(info.max_block_size == sample_info.max_block_size, label);
+		CHECK_MSG(info.sample_rate == sample_info.sample_rate, label);
+		CHECK_MSG(info.channels == sample_info.channels, label);
+		CHECK_MSG(info.bits_per_sample == sample_info.bits_per_sample, label);
+		CHECK_MSG(info.num_samples == sample_info.num_samples, label);
+	}
+
+	template <typename F>
+	std::string error_of(F&& callback)
+	{
+		try
+		{
+			callback();
+		}
+		catch (const std::runtime_error& e)
+		{
+			return e.what();
+		}
+
+		return {};
+	}
+
+	void test_metadata_block()
+	{
+		const auto last = flac::parse_metadata_block("\x84\x12\x34\x56");
+		CHECK(last.is_last);
+		CHECK(last.type == flac::vorbis_comment);
+		CHECK(last.length == 0x123456);
+
+		const auto first = flac::parse_metadata_block("\x00\x00\x00\x22");
+		CHECK(!first.is_last);
+		CHECK(first.type == flac::streaminfo);
+		CHECK(first.length == 34);
+
+		// the type keeps all 7 bits
+		const auto reserved = flac::parse_metadata_block("\x7F\xFF\xFF\xFF");
+		CHECK(!reserved.is_last);
+		CHECK(reserved.type == 0x7F);
+		CHECK(reserved.length == 0xFFFFFF);
+	}
+
+	void test_streaminfo()
+	{
+		const auto block = make_streaminfo(sample_info);
+		CHECK(block.size() == 34);
+		check_info(flac::parse_streaminfo(block), "streaminfo");
+
+		// mono, 8 bit and the largest 20 bit sample rate
+		const auto edge = flac::parse_streaminfo(make_streaminfo({16, 65535, 0xFFFFF, 1, 8, 1}));
+		CHECK(edge.min_block_size == 16 && edge.max_block_size == 65535);
+		CHECK(edge.sample_rate == 0xFFFFF && edge.channels == 1 && edge.bits_per_sample == 8 && edge.num_samples == 1);
+
+		CHECK(error_of([&] { flac::parse_streaminfo(std::string_view(block).substr(0, 33)); }) == "Flac streaminfo block is too short");
+		CHECK(error_of([] { flac::parse_streaminfo({}); }) == "Flac streaminfo block is too short");
+	}
+
+	void test_single_block()
+	{
+		const auto streaminfo = make_streaminfo(sample_info);
+		const auto audio = frames(100);
+		const auto data = "fLaC" + make_block(flac::streaminfo, true, streaminfo) + audio;
+
+		const auto result = flac::patch_stream(data);
+		check_info(result.info, "single block");
+
+		// the streaminfo loses its last flag, the new blocks go after it and the fsiz block is last
+		auto expected = "fLaC" + make_block(flac::streaminfo, false, streaminfo);
+		append_be32(expected, 0x03000000);
+		expected += fsiz_block(true, static_cast<std::uint32_t>(audio.size()));
+
+		CHECK(result.header == expected);
+		CHECK(result.frames == audio);
+		CHECK(result.size() == expected.size() + audio.size());
+	}
+
+	void test_several_blocks()
+	{
+		const auto streaminfo = make_block(flac::streaminfo, false, make_streaminfo(sample_info));
+		const auto padding = make_block(flac::padding, false, std::string(10, '\0'));
+		const auto comment = make_block(flac::vorbis_comment, true, "comment");
+		const auto audio = frames(300);
+		const auto data = "fLaC" + streaminfo + padding + comment + audio;
+
+		const auto result = flac::patch_stream(data);
+		check_info(result.info, "several blocks");
+
+		// the new blocks go in front of the last block, which stays last and is passed through with the frames
+		auto expected = "fLaC" + streaminfo + padding;
+		append_be32(expected, 0x03000000);
+		expected += fsiz_block(false, static_cast<std::uint32_t>(audio.size()));
+
+		CHECK(result.header == expected);
+		CHECK(result.frames == comment + audio);
+		CHECK(result.size() == data.size() + 4 + 12);
+	}
+
+	void test_existing_blocks()
+	{
+		const auto streaminfo = make_block(flac::streaminfo, false, make_streaminfo(sample_info));
+		const auto seektable = make_block(flac::seektable, false, std::string(18, '\x11'));
+		const auto audio = frames(50);
+
+		// an existing seektable isn't added again
+		{
+			const auto comment = make_block(flac::vorbis_comment, true, "x");
+			const auto data = "fLaC" + streaminfo + seektable + comment + audio;
+			const auto result = flac::patch_stream(data);
+
+			const auto expected = "fLaC" + streaminfo + seektable + fsiz_block(false, static_cast<std::uint32_t>(audio.size()));
+			CHECK(result.header == expected);
+			CHECK(result.frames == comment + audio);
+		}
+
+		// neither is an fsiz block, the file passes through unchanged
+		{
+			const auto fsiz = fsiz_block(true, 1234);
+			const auto data = "fLaC" + streaminfo + seektable + fsiz + audio;
+			const auto result = flac::patch_stream(data);
+
+			CHECK(result.header + std::string(result.frames) == data);
+			check_info(result.info, "existing blocks");
+		}
+
+		// other application blocks don't count
+		{
+			auto other = fsiz_block(true, 0);
+			other.replace(4, 4, "abcd");
+			const auto data = "fLaC" + streaminfo + seektable + other + audio;
+			const auto result = flac::patch_stream(data);
+
+			CHECK(result.header == "fLaC" + streaminfo + seektable + fsiz_block(false, static_cast<std::uint32_t>(audio.size())));
+			CHECK(result.frames == other + audio);
+		}
+	}
+
+	void test_invalid_flac()
+	{
+		const auto streaminfo = make_block(flac::streaminfo, true, make_streaminfo(sample_info));
+
+		CHECK(error_of([] { flac::patch_stream("RIFF...."); }) == "File is not a flac file");
+		CHECK(error_of([] { flac::patch_stream("fLaC"); }) == "Flac file has no metadata blocks");
+		CHECK(error_of([] { flac::patch_stream("fLaC\x80\x00"sv); }) == "Flac file has no metadata blocks");
+
+		const auto truncated = "fLaC" + streaminfo.substr(0, streaminfo.size() - 1);
+		CHECK(error_of([&] { flac::patch_stream(truncated); }) == "Flac metadata block exceeds the file size");
+
+		const auto short_streaminfo = "fLaC" + make_block(flac::streaminfo, true, std::string(20, '\0'));
+		CHECK(error_of([&] { flac::patch_stream(short_streaminfo); }) == "Flac streaminfo block is too short");
+	}
+
+	std::string make_chunk(const char (&id)[5], const std::string& data, const std::uint32_t size)
+	{
+		std::string result(id, 4);
+		append_le(result, size, 4);
+		return result + data;
+	}
+
+	std::string make_chunk(const char (&id)[5], const std::string& data)
+	{
+		return make_chunk(id, data, static_cast<std::uint32_t>(data.size()));
+	}
+
+	std::string make_fmt(const std::uint16_t format, const std::uint16_t channels, const std::uint32_t sample_rate,
+		const std::uint16_t bits_per_sample)
+	{
+		std::string result;
+		append_le(result, format, 2);
+		append_le(result, channels, 2);
+		append_le(result, sample_rate, 4);
+		append_le(result, sample_rate * channels * bits_per_sample / 8, 4);
+		append_le(result, channels * bits_per_sample / 8, 2);
+		append_le(result, bits_per_sample, 2);
+		return make_chunk("fmt ", result);
+	}
+
+	std::string make_wave(const std::string& chunks)
+	{
+		std::string result = "RIFF";
+		append_le(result, static_cast<std::uint32_t>(chunks.size() + 4), 4);
+		return result + "WAVE" + chunks;
+	}
+
+	void test_wave()
+	{
+		const auto samples = frames(64);
+		const auto fmt = make_fmt(wave::format_pcm, 2, 44100, 16);
+
+		// chunks in front of fmt and data are skipped
+		{
+			const auto data = make_wave(make_chunk("LIST", "abcdef") + fmt + make_chunk("fact", "1234") + make_chunk("data", samples));
+			const auto result = wave::parse(data);
+
+			CHECK(result.channels == 2);
+			CHECK(result.sample_rate == 44100);
+			CHECK(result.block_align == 4);
+			CHECK(result.bits_per_sample == 16);
+			CHECK(result.data == samples);
+		}
+
+		// a data size past the end of the file is clamped
+		{
+			const auto data = make_wave(fmt + make_chunk("data", samples, 0xFFFFFFFF));
+			CHECK(wave::parse(data).data == samples);
+
+			const auto unset = make_wave(fmt + make_chunk("data", samples, 0x1000));
+			CHECK(wave::parse(unset).data == samples);
+		}
+
+		// the data chunk may be shorter than the rest of the file
+		{
+			const auto data = make_wave(fmt + make_chunk("data", samples, 16));
+			CHECK(wave::parse(data).data == samples.substr(0, 16));
+		}
+
+		const auto no_fmt = "Wave data chunk has no valid fmt chunk in front of it.";
+		CHECK(error_of([&] { wave::parse(make_wave(make_chunk("data", samples))); }) == no_fmt);
+		CHECK(error_of([&] { wave::parse(make_wave(make_chunk("data", samples) + fmt)); }) == no_fmt);
+		CHECK(error_of([&] { wave::parse(make_wave(make_chunk("fmt ", "short") + make_chunk("data", samples))); }) == no_fmt);
+		CHECK(error_of([&] { wave::parse(make_wave(make_fmt(wave::format_pcm, 0, 44100, 16) + make_chunk("data", samples))); }) == no_fmt);
+
+		CHECK(error_of([&] { wave::parse(make_wave(make_fmt(3, 2, 44100, 32) + make_chunk("data", samples))); }) == "Invalid wave format 3.");
+		CHECK(error_of([&] { wave::parse(make_wave(fmt + make_chunk("LIST", "abc", 100) + make_chunk("data", samples))); }) == "Wave chunk exceeds the file size.");
+		CHECK(error_of([&] { wave::parse(make_wave(fmt)); }) == "Could not read sound data.");
+
+		CHECK(error_of([] { wave::parse("RIFF"); }) == "Invalid RIFF Header.");
+		CHECK(error_of([] { wave::parse("RIFX\x04\x00\x00\x00WAVE"sv); }) == "Invalid RIFF Header.");
+		CHECK(error_of([] { wave::parse("RIFF\x04\x00\x00\x00WAVX"sv); }) == "Invalid WAVE Header.");
+	}
+}
+
+int main()
+{
+	try
+	{
+		test_metadata_block();
+		test_streaminfo();
+		test_single_block();
+		test_several_blocks();
+		test_existing_blocks();
+		test_invalid_flac();
+		test_wave();
+	}
+	catch (const std::exception& e)
+	{
+		test::fail(__FILE__, __LINE__, std::string("unexpected exception: ") + e.what());
+	}
+
+	return test::result("flac_wave_test");
+}
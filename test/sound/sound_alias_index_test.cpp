@@ -0,0 +1,230 @@
+#include <std_include.hpp>
+
+#include "test.hpp"
+
+#include <zonetool/iw7/common/sound_alias_index.hpp>
+
+#include <random>
+
+namespace alias_index = zonetool::iw7::sound_alias_index;
+
+namespace
+{
+	// the linear probe the index build replaced, copied from the baseline sound_bank.cpp
+	void build_reference(const std::uint32_t* ids, const std::uint32_t count, alias_index::entry* index)
+	{
+		std::memset(index, 0xFF, sizeof(alias_index::entry) * count);
+
+		const auto placed = std::make_unique<bool[]>(count);
+
+		for (auto i = 0u; i < count; i++)
+		{
+			const auto idx = ids[i] % count;
+			if (index[idx].value == alias_index::empty)
+			{
+				index[idx].value = static_cast<unsigned short>(i);
+				index[idx].next = alias_index::empty;
+				placed[i] = true;
+			}
+		}
+
+		for (auto i = 0u; i < count; i++)
+		{
+			if (placed[i])
+			{
+				continue;
+			}
+
+			auto idx = ids[i] % count;
+			while (index[idx].next != alias_index::empty)
+			{
+				idx = index[idx].next;
+			}
+
+			auto offset = 1u;
+			auto free_idx = static_cast<std::uint32_t>(alias_index::empty);
+			while (true)
+			{
+				free_idx = (idx + offset) % count;
+				if (index[free_idx].value == alias_index::empty)
+				{
+					break;
+				}
+
+				free_idx = (idx + count - offset) % count;
+				if (index[free_idx].value == alias_index::empty)
+				{
+					break;
+				}
+
+				offset++;
+				free_idx = alias_index::empty;
+
+				if (offset >= count)
+				{
+					break;
+				}
+			}
+
+			if (free_idx == alias_index::empty)
+			{
+				throw std::runtime_error("Unable to allocate sound bank alias index list");
+			}
+
+			index[idx].next = static_cast<unsigned short>(free_idx);
+			index[free_idx].value = static_cast<unsigned short>(i);
+			index[free_idx].next = alias_index::empty;
+			placed[i] = true;
+		}
+	}
+
+	// same as game::snd_hash_name, which aliasName ids are made with
+	std::uint32_t snd_hash_name(const std::string& name)
+	{
+		std::uint32_t hash = 5381;
+		for (const auto c : name)
+		{
+			hash = 65599 * hash + static_cast<unsigned char>(std::tolower(static_cast<unsigned char>(c)));
+		}
+
+		return hash ? hash : 1;
+	}
+
+	void compare(const std::string& name, const std::vector<std::uint32_t>& ids)
+	{
+		const auto count = static_cast<std::uint32_t>(ids.size());
+
+		std::vector<alias_index::entry> index(count);
+		std::vector<alias_index::entry> reference(count);
+
+		alias_index::build(ids.data(), count, index.data());
+		build_reference(ids.data(), count, reference.data());
+
+		const auto equal = count == 0 || !std::memcmp(index.data(), reference.data(), sizeof(alias_index::entry) * count);
+		CHECK_MSG(equal, name + " (" + std::to_string(count) + " aliases)");
+
+		// every alias is reachable from its bucket
+		if (equal)
+		{
+			for (auto i = 0u; i < count; i++)
+			{
+				auto slot = ids[i] % count;
+				while (slot != alias_index::empty && index[slot].value != i)
+				{
+					slot = index[slot].next;
+				}
+
+				if (slot == alias_index::empty)
+				{
+					CHECK_MSG(false, name + ", alias " + std::to_string(i) + " is not in its chain");
+					break;
+				}
+			}
+		}
+	}
+
+	// alias names the way sound banks name them, with a few exact duplicates
+	void test_named_banks()
+	{
+		const char* prefixes[] = {"weap_", "foley_", "amb_", "vo_", "veh_", "ui_", "mus_", "step_"};
+
+		std::mt19937 random(1);
+		for (const auto count : {1u, 2u, 17u, 500u, 4096u, 20000u, 65534u})
+		{
+			std::vector<std::uint32_t> ids;
+			ids.reserve(count);
+
+			for (auto i = 0u; i < count; i++)
+			{
+				const auto* prefix = prefixes[random() % std::size(prefixes)];
+				const auto variant = random() % 8 == 0 ? i / 2 : i;
+				ids.emplace_back(snd_hash_name(prefix + std::to_string(variant) + "_" + std::to_string(random() % 4)));
+			}
+
+			compare("named bank", ids);
+		}
+	}
+
+	void test_random_collisions()
+	{
+		std::mt19937 random(2);
+
+		for (auto round = 0u; round < 200; round++)
+		{
+			// few distinct buckets for a lot of aliases
+			const std::uint32_t count = 1 + random() % 3000;
+			const std::uint32_t groups = 1 + random() % 64;
+			const std::uint32_t spread = 1 + random() % std::max(1u, count / groups);
+
+			std::vector<std::uint32_t> ids(count);
+			for (auto& id : ids)
+			{
+				id = static_cast<std::uint32_t>(random() % spread * (random() % 3 == 0 ? count : 1) + random() % 2);
+			}
+
+			compare("random collisions", ids);
+		}
+
+		for (const auto count : {1000u, 60000u})
+		{
+			std::vector<std::uint32_t> ids(count);
+			for (auto& id : ids)
+			{
+				id = random();
+			}
+
+			compare("uniform ids", ids);
+		}
+	}
+
+	void test_edge_patterns()
+	{
+		for (const auto count : {1u, 2u, 3u, 64u, 2000u})
+		{
+			// every alias in one bucket
+			compare("single bucket", std::vector<std::uint32_t>(count, 7u));
+
+			// buckets clustered at the end of the table so chains wrap around
+			std::vector<std::uint32_t> wrap(count);
+			for (auto i = 0u; i < count; i++)
+			{
+				wrap[i] = count - 1 - (i % std::max(1u, count / 8));
+			}
+			compare("wrapping chains", wrap);
+
+			// ids that are multiples of the count all land in bucket 0
+			std::vector<std::uint32_t> multiples(count);
+			for (auto i = 0u; i < count; i++)
+			{
+				multiples[i] = i * count + (i % 5 == 0 ? i : 0);
+			}
+			compare("multiples of count", multiples);
+
+			// every other bucket taken, the rest collide into the gaps
+			std::vector<std::uint32_t> alternating(count);
+			for (auto i = 0u; i < count; i++)
+			{
+				alternating[i] = (i * 2) % count;
+			}
+			compare("alternating buckets", alternating);
+		}
+
+		compare("empty bank", {});
+	}
+}
+
+int main()
+{
+	try
+	{
+		test_named_banks();
+		test_random_collisions();
+		test_edge_patterns();
+	}
+	catch (const std::exception& e)
+	{
+		test::fail(__FILE__, __LINE__, std::string("unexpected exception: ") + e.what());
+	}
+
+	return test::result("sound_alias_index_test");
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+// stands in for src/zonetool/std_include.hpp when the standalone parts are built on their own,
+// which pulls in the windows sdk and every dependency of the tool
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+using namespace std::literals;
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+// minimal checks for the standalone tests, every failure is printed and counted
+namespace test
+{
+	inline int failures = 0;
+
+	inline void fail(const char* file, const int line, const std::string& message)
+	{
+		std::printf("%s:%d: %s\n", file, line, message.data());
+		failures++;
+	}
+
+	inline std::string read_file(const std::filesystem::path& path)
+	{
+		std::ifstream stream(path, std::ios::binary);
+		if (!stream)
+		{
+			throw std::runtime_error("Failed to open " + path.string());
+		}
+
+		std::stringstream buffer;
+		buffer << stream.rdbuf();
+		return buffer.str();
+	}
+
+	inline std::uint64_t fnv1a(const void* data, const std::size_t size)
+	{
+		auto hash = 0xCBF29CE484222325ull;
+		for (auto i = 0u; i < size; i++)
+		{
+			hash ^= static_cast<const std::uint8_t*>(data)[i];
+			hash *= 0x100000001B3;
+		}
+
+		return hash;
+	}
+
+	inline int result(const char* name)
+	{
+		if (failures)
+		{
+			std::printf("%s: %d check(s) failed\n", name, failures);
+			return 1;
+		}
+
+		std::printf("%s: all checks passed\n", name);
+		return 0;
+	}
+}
+
+#define CHECK(__COND__) \
+	do { if (!(__COND__)) test::fail(__FILE__, __LINE__, "check failed: " #__COND__); } while (false)
+
+#define CHECK_MSG(__COND__, __MSG__) \
+	do { if (!(__COND__)) test::fail(__FILE__, __LINE__, std::string("check failed: " #__COND__ ", ") + (__MSG__)); } while (false)
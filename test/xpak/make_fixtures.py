@@ -0,0 +1,209 @@
+#!/usr/bin/env python3
+# writes the synthetic xpak fixtures used by xpak_format_test.cpp
+#
+# every entry of blocks.xpak has a line in blocks.expected:
+#   <key> <expected size> ok <fnv-1a 64 of the output> [unknown block types...]
+#   <key> <expected size> empty
+#   <key> <expected size> error
+
+import os
+import struct
+
+FOLDER = os.path.join(os.path.dirname(os.path.abspath(__file__)), "fixtures")
+
+PAK_MAGIC = 0x4950414B
+HEADER_FORMAT = "<IHHQQQQQQQQQQQQQQ"
+HEADER_SIZE = struct.calcsize(HEADER_FORMAT)
+MAX_COMMANDS = 30
+
+BLOCK_RAW = 0x0
+BLOCK_LZ4 = 0x3
+BLOCK_SKIP = 0xCF
+
+
+def fnv1a(data):
+    value = 0xCBF29CE484222325
+    for c in data:
+        value ^= c
+        value = (value * 0x100000001B3) & 0xFFFFFFFFFFFFFFFF
+    return value
+
+
+def pattern(size, seed):
+    return bytes((i * 31 + seed * 7 + (i >> 5)) & 0xFF for i in range(size))
+
+
+def lz4_length(value):
+    out = bytearray()
+    while value >= 255:
+        out.append(255)
+        value -= 255
+    out.append(value)
+    return bytes(out)
+
+
+def lz4_block(sequences):
+    # sequences are (literals, match offset, match length), the last one has no match.
+    # returns the block and what it decodes to
+    block = bytearray()
+    output = bytearray()
+
+    for literals, offset, length in sequences:
+        lit_token = min(len(literals), 15)
+        match_token = 0 if offset is None else min(length - 4, 15)
+        block.append((lit_token << 4) | match_token)
+        if len(literals) >= 15:
+            block += lz4_length(len(literals) - 15)
+        block += literals
+        output += literals
+
+        if offset is None:
+            continue
+
+        block += struct.pack("<H", offset)
+        if length - 4 >= 15:
+            block += lz4_length(length - 4 - 15)
+
+        for _ in range(length):
+            output.append(output[-offset])
+
+    return bytes(block), bytes(output)
+
+
+def lz4_literals(data):
+    return lz4_block([(data, None, None)])
+
+
+def lz4_repeat(seed, size):
+    # a short literal run repeated by one long match, ending in literals like lz4 requires
+    head = pattern(16, seed)
+    tail = pattern(16, seed + 1)
+    return lz4_block([(head, 16, size - 32), (tail, None, None)])
+
+
+def command(size, block_type):
+    return size | (block_type << 24)
+
+
+def header(blocks):
+    assert 0 < len(blocks) <= MAX_COMMANDS
+    commands = [command(len(data), block_type) for block_type, data in blocks]
+    commands += [0] * (MAX_COMMANDS - len(commands))
+    return struct.pack("<II30I", len(blocks), 0, *commands) + b"".join(data for _, data in blocks)
+
+
+class entry_builder:
+    def __init__(self):
+        self.data = bytearray()
+        self.output = bytearray()
+        self.unknown = []
+
+    def add(self, blocks):
+        # blocks are (type, stored data, decoded data)
+        self.data += header([(block_type, data) for block_type, data, _ in blocks])
+        for block_type, _, decoded in blocks:
+            if block_type in (BLOCK_RAW, BLOCK_LZ4):
+                self.output += decoded
+            elif block_type != BLOCK_SKIP:
+                self.unknown.append(block_type)
+        return self
+
+    def pad(self, size):
+        self.data += bytes(size)
+        return self
+
+
+def raw(data):
+    return BLOCK_RAW, data, data
+
+
+def lz4(encoded):
+    return BLOCK_LZ4, encoded[0], encoded[1]
+
+
+def build_entries():
+    entries = []
+
+    def ok(key, builder):
+        entries.append((key, bytes(builder.data), len(builder.output), "ok %016X%s" % (
+            fnv1a(builder.output), "".join(" %X" % t for t in builder.unknown))))
+
+    ok(0x1001, entry_builder().add([raw(pattern(100, 1))]))
+    ok(0x1002, entry_builder().add([lz4(lz4_literals(pattern(200, 2)))]))
+    ok(0x1003, entry_builder().add([lz4(lz4_repeat(3, 4000))]))
+    ok(0x1004, entry_builder()
+        .add([raw(pattern(50, 4)), lz4(lz4_repeat(5, 3000))])
+        .add([lz4(lz4_literals(pattern(70, 6))), raw(pattern(10, 7))]))
+
+    # zero bytes between and after headers are skipped one byte at a time
+    ok(0x1005, entry_builder()
+        .add([raw(pattern(30, 8))])
+        .pad(13)
+        .add([raw(pattern(20, 9))])
+        .pad(40))
+
+    ok(0x1006, entry_builder().add([raw(pattern(10, 10)), (BLOCK_SKIP, bytes(16), b""), raw(pattern(10, 11))]))
+    ok(0x1007, entry_builder().add([raw(pattern(10, 12)), (0x7, pattern(8, 13), b""), raw(pattern(5, 14))]))
+
+    # more lz4 blocks than the parallel threshold, spread over two headers
+    many = entry_builder()
+    many.add([lz4(lz4_repeat(20 + i, 1024 + i * 37)) for i in range(30)])
+    many.add([lz4(lz4_literals(pattern(300 + i, 60 + i))) for i in range(10)])
+    ok(0x100B, many)
+
+    ok(0x100C, entry_builder().add([lz4(lz4_repeat(90, 0x10000))]))
+
+    # the block claims more data than the entry has left
+    overrun = struct.pack("<II30I", 1, 0, command(500, BLOCK_RAW), *([0] * 29)) + pattern(100, 15)
+    entries.append((0x1008, overrun, 500, "error"))
+
+    mismatch = entry_builder().add([raw(pattern(64, 16))])
+    entries.append((0x1009, bytes(mismatch.data), 65, "empty"))
+
+    # a match offset pointing before the start of the output
+    corrupt = bytes([0x1F]) + pattern(1, 17) + struct.pack("<H", 40) + bytes([0x50]) + pattern(5, 18)
+    entries.append((0x100A, header([(BLOCK_LZ4, corrupt)]), 64, "error"))
+
+    return entries
+
+
+def write_pak(path, entries):
+    data = bytearray()
+    hashes = bytearray()
+    for key, entry, _, _ in entries:
+        hashes += struct.pack("<QQQ", key, len(data), len(entry))
+        data += entry
+
+    data_offset = HEADER_SIZE
+    hash_offset = data_offset + len(data)
+    pak_header = struct.pack(HEADER_FORMAT, PAK_MAGIC, 0, 0xD, 0, hash_offset + len(hashes), len(entries),
+        data_offset, len(data), len(entries), hash_offset, len(hashes), 0, 0, 0, 0, 0, 0)
+
+    with open(path, "wb") as file:
+        file.write(pak_header + data + hashes)
+
+
+def main():
+    os.makedirs(FOLDER, exist_ok=True)
+
+    entries = build_entries()
+    write_pak(os.path.join(FOLDER, "blocks.xpak"), entries)
+
+    with open(os.path.join(FOLDER, "blocks.expected"), "w", newline="\n") as file:
+        for key, _, size, result in entries:
+            file.write("%X %d %s\n" % (key, size, result))
+
+    # paks the hash table reader has to reject
+    with open(os.path.join(FOLDER, "too_small.xpak"), "wb") as file:
+        file.write(struct.pack("<I", PAK_MAGIC))
+
+    with open(os.path.join(FOLDER, "bad_magic.xpak"), "wb") as file:
+        file.write(struct.pack(HEADER_FORMAT, 0x12345678, 0, 0xD, *([0] * 14)))
+
+    with open(os.path.join(FOLDER, "truncated.xpak"), "wb") as file:
+        file.write(struct.pack(HEADER_FORMAT, PAK_MAGIC, 0, 0xD, 0, HEADER_SIZE, 4, HEADER_SIZE, 0, 4, HEADER_SIZE, 96,
+            0, 0, 0, 0, 0, 0) + bytes(24))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,211 @@
+#include <std_include.hpp>
+
+#include "test.hpp"
+
+#include <zonetool/t7/common/xpak_format.hpp>
+
+namespace xpak = zonetool::t7::xpak;
+
+namespace
+{
+	struct expectation
+	{
+		std::uint64_t key;
+		std::size_t size;
+		std::string result;
+		std::uint64_t hash;
+		std::vector<std::uint32_t> unknown_types;
+	};
+
+	std::vector<expectation> read_expectations(const std::filesystem::path& path)
+	{
+		std::vector<expectation> result;
+
+		std::istringstream stream(test::read_file(path));
+		std::string line;
+		while (std::getline(stream, line))
+		{
+			std::istringstream fields(line);
+
+			expectation entry{};
+			fields >> std::hex >> entry.key >> std::dec >> entry.size >> entry.result;
+			if (entry.result == "ok")
+			{
+				fields >> std::hex >> entry.hash;
+
+				std::uint32_t type{};
+				while (fields >> type)
+				{
+					entry.unknown_types.emplace_back(type);
+				}
+			}
+
+			result.emplace_back(std::move(entry));
+		}
+
+		return result;
+	}
+
+	std::string key_name(const std::uint64_t key)
+	{
+		char buffer[32]{};
+		std::snprintf(buffer, sizeof(buffer), "key %llX", static_cast<unsigned long long>(key));
+		return buffer;
+	}
+
+	void test_entries(const std::filesystem::path& fixtures)
+	{
+		const auto pak = test::read_file(fixtures / "blocks.xpak");
+		const auto expectations = read_expectations(fixtures / "blocks.expected");
+		const auto entries = xpak::format::read_hash_table(pak.data(), pak.size());
+
+		CHECK(entries.size() == expectations.size());
+		CHECK(!expectations.empty());
+
+		for (const auto& expected : expectations)
+		{
+			const auto name = key_name(expected.key);
+
+			const auto entry = std::find_if(entries.begin(), entries.end(), [&](const xpak::format::hash_entry& entry)
+			{
+				return entry.key == expected.key;
+			});
+
+			CHECK_MSG(entry != entries.end(), name);
+			if (entry == entries.end())
+			{
+				continue;
+			}
+
+			CHECK_MSG(entry->offset + entry->size <= pak.size(), name);
+
+			// serial and parallel decoding have to agree
+			for (const auto threads : {1u, 4u})
+			{
+				const auto label = name + ", " + std::to_string(threads) + " thread(s)";
+
+				std::vector<std::uint32_t> unknown_types;
+				std::vector<std::uint8_t> data;
+				auto threw = false;
+
+				try
+				{
+					data = xpak::format::extract(pak.data() + entry->offset, static_cast<std::size_t>(entry->size),
+						expected.size, threads, &unknown_types);
+				}
+				catch (const std::runtime_error&)
+				{
+					threw = true;
+				}
+
+				if (expected.result == "error")
+				{
+					CHECK_MSG(threw, label);
+					continue;
+				}
+
+				CHECK_MSG(!threw, label);
+
+				if (expected.result == "empty")
+				{
+					CHECK_MSG(data.empty(), label);
+					continue;
+				}
+
+				CHECK_MSG(data.size() == expected.size, label);
+				CHECK_MSG(test::fnv1a(data.data(), data.size()) == expected.hash, label);
+				CHECK_MSG(unknown_types == expected.unknown_types, label);
+			}
+		}
+	}
+
+	void test_block_layout(const std::filesystem::path& fixtures)
+	{
+		const auto pak = test::read_file(fixtures / "blocks.xpak");
+		const auto entries = xpak::format::read_hash_table(pak.data(), pak.size());
+
+		const auto find = [&](const std::uint64_t key)
+		{
+			return *std::find_if(entries.begin(), entries.end(), [&](const xpak::format::hash_entry& entry)
+			{
+				return entry.key == key;
+			});
+		};
+
+		// padding between and after headers doesn't produce blocks
+		{
+			const auto entry = find(0x1005);
+			const auto blocks = xpak::format::collect_blocks(pak.data() + entry.offset, static_cast<std::size_t>(entry.size));
+			CHECK(blocks.size() == 2);
+			CHECK(blocks.size() == 2 && blocks[0].size == 30 && blocks[1].size == 20);
+		}
+
+		// 0xCF blocks are dropped without being reported
+		{
+			const auto entry = find(0x1006);
+			std::vector<std::uint32_t> unknown_types;
+			const auto blocks = xpak::format::collect_blocks(pak.data() + entry.offset, static_cast<std::size_t>(entry.size), &unknown_types);
+			CHECK(blocks.size() == 2);
+			CHECK(unknown_types.empty());
+		}
+
+		// lz4 blocks only get their size once decoded
+		{
+			const auto entry = find(0x100B);
+			const auto blocks = xpak::format::collect_blocks(pak.data() + entry.offset, static_cast<std::size_t>(entry.size));
+			CHECK(blocks.size() == 40);
+			CHECK(std::all_of(blocks.begin(), blocks.end(), [](const xpak::format::data_block& block)
+			{
+				return block.type == xpak::format::block_lz4 && block.output_size == 0;
+			}));
+		}
+
+		// an empty entry has no blocks
+		CHECK(xpak::format::collect_blocks(pak.data(), 0).empty());
+		CHECK(xpak::format::extract(pak.data(), 0, 0).empty());
+	}
+
+	void test_invalid_paks(const std::filesystem::path& fixtures)
+	{
+		for (const auto* name : {"too_small.xpak", "bad_magic.xpak", "truncated.xpak"})
+		{
+			const auto pak = test::read_file(fixtures / name);
+
+			auto threw = false;
+			try
+			{
+				xpak::format::read_hash_table(pak.data(), pak.size());
+			}
+			catch (const std::runtime_error&)
+			{
+				threw = true;
+			}
+
+			CHECK_MSG(threw, name);
+		}
+	}
+}
+
+int main(const int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		std::printf("usage: %s <fixture folder>\n", argv[0]);
+		return 1;
+	}
+
+	const std::filesystem::path fixtures = argv[1];
+
+	try
+	{
+		test_entries(fixtures);
+		test_block_layout(fixtures);
+		test_invalid_paks(fixtures);
+	}
+	catch (const std::exception& e)
+	{
+		test::fail(__FILE__, __LINE__, std::string("unexpected exception: ") + e.what());
+	}
+
+	return test::result("xpak_format_test");
+}